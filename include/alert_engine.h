@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "derived_metrics.h"
+
+#define ALERT_MAX_RULES   64     // One bit each in the pending/active masks
+
+enum AlertPriority : uint8_t {
+  ALERT_INFO = 0,
+  ALERT_WARNING,
+  ALERT_CRITICAL
+};
+
+enum AlertKind : uint8_t {
+  ALERT_ABOVE = 0,       // Raised while value > threshold
+  ALERT_BELOW            // Raised while value < threshold
+};
+
+/* One threshold on a dashboard field. Values are in the units
+ * field_display_value() reports (0.01 V / 0.01 A for voltage and current). */
+struct AlertRule {
+  uint8_t       field;          // TelemetryField or DerivedField
+  AlertKind     kind;
+  int32_t       threshold;
+  int32_t       hysteresis;     // Cleared only once this far back inside the threshold
+  uint16_t      debounce_ms;    // Condition must hold this long before raising
+  AlertPriority priority;
+  const char   *text;           // Static, shown in the banner
+};
+
+/* Rules are indexed by field at init, so a changed field only visits its own
+ * rules and an unchanged one costs nothing. Debounce timers are only looked
+ * at while some rule is pending. Each rule is active at most once, so a
+ * condition that keeps holding never raises a duplicate. */
+struct AlertEngine {
+  const AlertRule *rules;
+  uint8_t  rule_count;
+  uint8_t  by_field[ALERT_MAX_RULES];          // Rule indices grouped by field
+  uint8_t  field_start[DASH_FIELD_COUNT + 1];  // by_field range of each field
+  uint32_t since_ms[ALERT_MAX_RULES];          // When a pending rule's condition began
+  uint64_t pending;
+  uint64_t active;
+  int8_t   top;                                // Rule shown in the banner, -1 = none
+  uint8_t  active_count;
+};
+
+/* rules must outlive the engine. Extra rules beyond ALERT_MAX_RULES and rules
+ * on unknown fields are ignored. */
+void alert_engine_init(AlertEngine *e, const AlertRule *rules, uint8_t count);
+
+/* Evaluate the rules of the fields in changed (DASH_FIELD_BIT mask), reading
+ * values through value(). Returns true if the top alert or the number of
+ * active alerts changed. */
+bool alert_engine_update(AlertEngine *e, uint32_t changed, int32_t (*value)(uint8_t field),
+                         uint32_t now_ms);
+
+/* Raise pending rules whose debounce has elapsed. Same return as update. */
+bool alert_engine_tick(AlertEngine *e, uint32_t now_ms);
+
+// Highest-priority active rule (earliest in the table on ties), or NULL
+const AlertRule *alert_engine_top(const AlertEngine *e);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+// Flash data partition with packed images and fonts, built by tools/pack_assets.py
+#define ASSET_PARTITION_LABEL    "assets"
+#define ASSET_PARTITION_SUBTYPE  0x40
+#define ASSET_MAGIC              0x41485344  // "DSHA"
+#define ASSET_VERSION            1
+#define ASSET_NAME_LEN           24
+#define ASSET_MAX_ENTRIES        32
+
+enum AssetType {
+  ASSET_IMAGE = 1,   // LVGL v9 .bin image: lv_image_header_t + pixel data
+  ASSET_FONT  = 2    // Pointer-free lv_font_fmt_txt font (see asset_store.cpp)
+};
+
+/* Partition layout, little-endian: AssetHeader, AssetEntry[count], then the
+ * payloads, each 4-byte aligned. Offsets are from the start of the partition. */
+struct AssetHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+  uint32_t total_size;     // Header + index + payloads
+  uint32_t index_crc;      // CRC-32 of the AssetEntry table
+};
+
+struct AssetEntry {
+  char     name[ASSET_NAME_LEN];   // NUL-padded
+  uint8_t  type;                   // AssetType
+  uint8_t  reserved[3];
+  uint32_t offset;
+  uint32_t size;
+};
+
+/* Map the partition and check its index. False (and every lookup NULL) when
+ * the partition is missing or was never flashed. */
+bool asset_store_begin();
+
+/* Descriptors pointing straight into mapped flash, created on first lookup
+ * and kept for the life of the program. NULL if the asset is not packed. */
+const lv_image_dsc_t *asset_image(const char *name);
+const lv_font_t *asset_font(const char *name);
+
+// Bytes of packed assets in flash, 0 without a valid partition
+uint32_t asset_store_size();
@@ -0,0 +1,5 @@
+#pragma once
+
+// On-device benchmarks, built only in the esp32dev_bench environment (-D DASH_BENCH).
+// Results are printed to Serial at the end of setup().
+void run_benchmarks();
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_transport.h"
+
+/* Where a telemetry field sits in a CAN message. Values are big-endian and in
+ * the same raw units as the RS485 TLVs (see the ID_* precision notes), so the
+ * rest of the pipeline cannot tell the transports apart. Signed values are
+ * two's complement on CAN and converted to the wire's sign-magnitude. Every
+ * signal of one CAN ID must name the same node. */
+struct CanSignal {
+  uint16_t can_id;             // 11-bit standard ID
+  uint8_t  node;               // Source address the message is routed as (NODE_ADDR_*)
+  uint8_t  field;              // TelemetryField
+  uint8_t  offset;             // First data byte
+  uint8_t  size;               // 1, 2 or 4 bytes
+  bool     is_signed;
+};
+
+/* Decode one CAN message into a new batch frame when its ID is mapped.
+ * Returns false for unmapped IDs, short messages and a full batch. */
+bool can_map_decode(const CanSignal *signals, uint8_t count, uint32_t id,
+                    const uint8_t *data, uint8_t dlc, TelemetryBatch *batch);
+
+/* Single hardware acceptance filter covering every mapped ID: the code holds
+ * the bits they share, the mask (1 = don't care) the bits where they differ.
+ * IDs that only match the cover are dropped by can_map_decode. */
+void can_map_filter(const CanSignal *signals, uint8_t count, uint32_t *code, uint32_t *mask);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_transport.h"
+#include "can_map.h"
+
+#define CAN_RX_QUEUE_LEN      64   // TWAI driver queue between its ISR and the task
+
+struct CanTransport {
+  const CanSignal *signals;
+  uint8_t          count;
+  int              tx_pin;
+  int              rx_pin;
+  uint32_t         bus_off;    // Bus-off recoveries
+};
+
+void can_transport_init(TelemetryTransport *t, CanTransport *ctx, const CanSignal *signals,
+                        uint8_t count, int tx_pin, int rx_pin);
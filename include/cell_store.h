@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+#define CELL_MAX          200    // Largest pack supported (cell index fits the block's 1-byte start)
+#define CELL_TEMP_NONE    INT8_MIN
+#define CELL_DIRTY_WORDS  ((CELL_MAX + 31) / 32)
+
+/* Per-cell voltages and temperatures from ID_CELL_VOLTAGES / ID_CELL_TEMPS.
+ * A cell that has not been reported reads 0 mV / CELL_TEMP_NONE and is left
+ * out of the statistics. Min, max and the voltage sum are kept up to date on
+ * every write; only when the cell holding an extreme moves inwards is that
+ * extreme rescanned, once per block. */
+struct CellStore {
+  uint8_t  count;                      // Highest cell reported + 1
+  uint16_t mv[CELL_MAX];
+  int8_t   temp_c[CELL_MAX];
+  uint32_t dirty[CELL_DIRTY_WORDS];    // Cells changed since the last sync/clear
+
+  uint8_t  mv_cells;                   // Cells with a voltage
+  uint32_t sum_mv;
+  uint16_t min_mv, max_mv;
+  uint8_t  min_mv_cell, max_mv_cell;
+
+  uint8_t  temp_cells;                 // Cells with a temperature
+  int8_t   min_c, max_c;
+  uint8_t  min_c_cell, max_c_cell;
+
+  uint8_t  rescan;                     // Extremes to recompute after this block
+};
+
+void cell_store_init(CellStore *s);
+
+/* Apply one ID_CELL_* block. Returns true if any cell changed; other block
+ * IDs are ignored. Call with dataMutex held for the shared store. */
+bool cell_store_apply_block(CellStore *s, const TelemetryBlock *block);
+
+/* Copy src into dst for the UI, merging the dirty marks; src's are cleared */
+void cell_store_sync(CellStore *dst, CellStore *src);
+
+void cell_store_clear_dirty(CellStore *s);
+
+static inline bool cell_store_is_dirty(const CellStore *s, uint8_t cell) {
+  return s->dirty[cell / 32] & (1u << (cell % 32));
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include "cell_store.h"
+
+// Fixed colour scales, so a cell only repaints when its own value changes
+#define CELL_VIEW_MV_LOW     3000
+#define CELL_VIEW_MV_HIGH    4200
+#define CELL_VIEW_C_LOW      0
+#define CELL_VIEW_C_HIGH     60
+
+/* Per-cell heatmap of a CellStore with a min/max/delta line on top; the
+ * lowest and highest cells are outlined. Cells are drawn straight from the
+ * store in DRAW_MAIN rather than into a canvas (200 cells of RGB565 would cost
+ * tens of KB of internal RAM), and only the clip area is visited, so a
+ * single-cell change repaints one small rectangle. Tap to switch between
+ * voltages and temperatures. Honours text_font and text_color of LV_PART_MAIN. */
+lv_obj_t *cell_view_create(lv_obj_t *parent, CellStore *cells, int32_t w, int32_t h);
+
+/* Invalidate the cells marked dirty in the store, and the summary line if its
+ * text changed, then clear the marks. Cost follows the rows touched, not the
+ * pack size. */
+void cell_view_refresh(lv_obj_t *obj);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+#define DERIVED_BUCKET_MS     1000   // Sliding windows advance in 1 s buckets
+#define DERIVED_WINDOW        60     // Buckets per window: rolling averages over the last minute
+#define DERIVED_MAX_GAP_MS    2000   // Longer between samples = link gap, not integrated
+#define DERIVED_MIN_KM        0.2f   // Distance needed before a consumption figure is trusted
+
+#ifndef DERIVED_PACK_WH
+#define DERIVED_PACK_WH       1000   // Usable pack energy at 100% SoC
+#endif
+
+/* Values computed on the dashboard. They extend the TelemetryField numbering
+ * so the UI binds to both the same way (see ui_bind.h). */
+enum DerivedField {
+  DERIVED_POWER = FIELD_COUNT,   // Instantaneous V*I, W
+  DERIVED_ENERGY_USED,           // Trip energy drawn, 0.01 kWh
+  DERIVED_ENERGY_REGEN,          // Trip energy recovered, 0.01 kWh
+  DERIVED_AVG_WKM,               // Rolling consumption, Wh/km
+  DERIVED_AVG_KMH,               // Rolling average speed, km/h
+  DERIVED_RANGE,                 // Predicted range from recent consumption, km
+  DASH_FIELD_COUNT
+};
+
+#define DERIVED_COUNT     (DASH_FIELD_COUNT - FIELD_COUNT)
+#define DASH_FIELD_BIT(f) ((uint32_t)(1u << (f)))
+
+/* Latest dashboard values fed in on every routed frame */
+struct DerivedInputs {
+  float voltage;                 // V
+  float current;                 // A, negative while regenerating
+  float speed_kmh;
+  int   soc;                     // %
+  int   ctrl_range_km;           // Controller's own figures, used until ours are trusted
+  int   ctrl_avg_wkm;
+};
+
+struct DerivedBucket {
+  int32_t  mj;                   // Net energy, mJ
+  uint32_t mm;                   // Distance, mm
+  uint32_t ms;                   // Integrated time
+};
+
+/* Integrates V*I and speed over the real gaps between samples (held since the
+ * previous sample) into exact trip totals and a ring of 1 s buckets. Window
+ * sums are kept running: each bucket is added once and subtracted once as it
+ * leaves the window, so an update is O(1) whatever the window length. */
+struct DerivedMetrics {
+  bool     started;
+  uint32_t last_ms;
+  float    power_w;              // Held since last_ms
+  float    speed_kmh;
+
+  int64_t  used_mj;              // Trip totals
+  int64_t  regen_mj;
+  uint64_t trip_mm;
+  int64_t  trip_net_mj;
+
+  DerivedBucket buckets[DERIVED_WINDOW];
+  uint8_t  head;                 // Bucket being filled
+  uint32_t bucket_start_ms;
+  int64_t  win_mj;               // Sums over the window
+  uint64_t win_mm;
+  uint32_t win_ms;
+
+  int32_t  out[DERIVED_COUNT];   // Published values, display units
+};
+
+void     derived_init(DerivedMetrics *m);
+
+/* Feed the values current at now_ms. Returns the DASH_FIELD_BIT mask of
+ * derived values that changed. */
+uint32_t derived_update(DerivedMetrics *m, uint32_t now_ms, const DerivedInputs *in);
+
+int32_t  derived_value(const DerivedMetrics *m, uint8_t field);
+
+/* DASH_FIELD_BIT mask of the stale telemetry fields (a FIELD_BIT mask, see
+ * link_stale_fields) plus every derived value computed from one of them */
+uint32_t derived_stale_fields(uint16_t stale_fields);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <lvgl.h>
+
+#define DIGIT_DISPLAY_MAX_DIGITS 6
+
+/* Fixed-width numeric readout drawn from cached digit glyphs. The digits and
+ * '-' of the widget's text_font are rasterised once, on first draw, and drawn
+ * scaled so the digits are height px tall: the readout can be larger than
+ * any font the UI carries, at the cost of slightly softer edges when scaled
+ * up. Setting a value only invalidates the digit cells that changed. Honours
+ * the text_font, text_color and text_opa styles of LV_PART_MAIN; the widget
+ * sizes itself to the digits of its font. */
+lv_obj_t *digit_display_create(lv_obj_t *parent, uint8_t digits, int32_t height);
+void digit_display_set_value(lv_obj_t *obj, int32_t value);
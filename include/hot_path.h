@@ -0,0 +1,23 @@
+#pragma once
+
+/* Placement of the measured hot paths. Code and constants in flash run
+ * through a 32 KB cache per core that LVGL rendering, font bitmaps and image
+ * reads keep evicting; every miss is a flash read over SPI, longer still
+ * while the other core is missing too. HOT_CODE puts a function in IRAM and
+ * HOT_DATA a constant table in DRAM, so they run at the same speed however
+ * cold the cache is. A HOT_CODE function that calls into flash pays for the
+ * miss there instead, so keep hot callees HOT_CODE or inline. IRAM is 128 KB
+ * and shared with the core's ISRs: small functions only.
+ *
+ * The LVGL blend and fill routines are placed the same way through
+ * LV_ATTRIBUTE_FAST_MEM (platformio.ini). -D DASH_HOT_IN_FLASH leaves
+ * everything in flash, for bench_hot_path in esp32dev_bench_flash.
+ * Off target the attributes are empty. */
+#if defined(ARDUINO) && !defined(DASH_HOT_IN_FLASH)
+#include <esp_attr.h>
+#define HOT_CODE  IRAM_ATTR
+#define HOT_DATA  DRAM_ATTR
+#else
+#define HOT_CODE
+#define HOT_DATA
+#endif
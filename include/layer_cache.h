@@ -0,0 +1,30 @@
+#pragma once
+
+#include <lvgl.h>
+
+/* Static layer caching. Everything static about a widget (background, radius,
+ * border, arc track, child captions) is rendered once into an RGB565 snapshot
+ * placed directly beneath it, and the widget is stripped down to its live
+ * parts. A value change inside it then redraws as a plain bitmap copy plus the
+ * value, instead of re-rasterising anti-aliased shapes.
+ *
+ * The snapshot is flattened onto the background colour of the nearest
+ * ancestor with an opaque background (layout containers in between are
+ * transparent), which must not change. Needs LV_USE_SNAPSHOT. */
+
+// Parts of the widget itself that stay live (hidden while baking)
+#define LAYER_LIVE_INDICATOR  0x01  // Arc/bar value
+#define LAYER_LIVE_KNOB       0x02  // Arc/slider knob
+
+/* RGB565 snapshot of obj and its extra draw area, flattened onto its backdrop's
+ * background colour. Free with lv_draw_buf_destroy(). NULL if it does not fit. */
+lv_draw_buf_t *layer_cache_snapshot(lv_obj_t *obj);
+
+/* Bake obj. Children listed in live[] keep rendering normally, all other
+ * children are hidden. Returns the snapshot image, or NULL if the snapshot
+ * could not be taken, in which case obj is left untouched and renders live. */
+lv_obj_t *layer_cache_bake(lv_obj_t *obj, lv_obj_t *const *live, uint8_t live_count,
+                           uint8_t live_parts);
+
+// Bytes currently held by baked snapshots
+uint32_t layer_cache_bytes();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+#define LINK_WINDOW_MS      1000  // Rates are computed over this window
+#define LINK_TIMEOUT_MS     1500  // No valid frame for this long = link down
+#define FIELD_STALE_MS      2000  // Field not refreshed for this long = stale
+
+/* Telemetry link statistics, all transports together. Frame counts and the
+ * window are written under dataMutex. CRC errors and dropped bytes come from
+ * the RS485 framer outside it, so those counters are only touched with
+ * atomic operations, and the window takes win_crc with an atomic exchange.
+ * Readers copy the struct, every member is an independent 32-bit word. */
+struct LinkHealth {
+  uint32_t frames_ok;               // Valid frames since boot
+  uint32_t crc_errors;              // Frames that failed validation since boot (atomic)
+  uint32_t bytes_dropped;           // Bytes discarded on buffer overflow (atomic)
+  uint32_t last_valid_ms;           // 0 = never
+
+  // Results of the last completed window
+  float    frame_rate;              // Valid frames per second
+  float    crc_error_rate;          // Failed / (failed + valid), 0..1
+  float    field_rate[FIELD_COUNT]; // Updates per second per field
+
+  // Window accumulators
+  uint32_t window_start_ms;
+  uint16_t win_frames;
+  uint32_t win_crc;                 // Atomic: see above
+  uint16_t win_field_updates[FIELD_COUNT];
+};
+
+extern LinkHealth linkHealth;
+
+void link_health_frame_ok(uint16_t fields, uint32_t now_ms);
+void link_health_crc_error();
+void link_health_bytes_dropped(uint32_t count);
+void link_health_tick(uint32_t now_ms);
+bool link_is_down(uint32_t now_ms);
+uint16_t link_stale_fields(const uint32_t *field_rx_ms, uint32_t now_ms);
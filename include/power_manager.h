@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+#include <driver/ledc.h>
+#include <driver/uart.h>
+
+#include "derived_metrics.h"
+
+/* Activity-aware power states. ACTIVE runs at full clock and the user's
+ * backlight level; with no touch and no significant telemetry change the
+ * dashboard dims, then idles at the lowest clock with slower display refresh.
+ * Any touch or significant change goes straight back to ACTIVE. */
+#define POWER_DIM_AFTER_MS        30000  // No activity for this long: dim the backlight
+#define POWER_IDLE_AFTER_MS      120000  // ... and for this long: idle
+#define POWER_BACKLIGHT_DIM_DIV       4  // Dimmed backlight = user level / this
+#define POWER_BACKLIGHT_IDLE          8  // Just enough to see the dashboard is on
+
+#define POWER_CPU_MHZ_MAX           240
+#define POWER_CPU_MHZ_MIN            80  // Lowest clock that keeps the 80 MHz APB (UART, SPI)
+
+#define POWER_LOOP_MIN_MS             5  // uiTask always yields at least this long
+#define POWER_LOOP_MAX_MS           100  // Longest uiTask wait when no LVGL timer is due sooner
+#define POWER_IDLE_TOUCH_POLL_MS     40  // Touch poll while idle; bounds the wake-up latency
+#define POWER_IDLE_REFR_MS          200  // Display refresh period while idle
+
+// Backlight PWM on its own LEDC timer clocked from RC_FAST, the one LEDC clock
+// that keeps running in light sleep (APB stops, and analogWrite's PWM with it)
+#define POWER_BACKLIGHT_PWM_HZ     5000
+#define POWER_BACKLIGHT_TIMER  LEDC_TIMER_3     // Clear of the timers analogWrite hands out first
+#define POWER_BACKLIGHT_CHANNEL  LEDC_CHANNEL_7
+
+#define POWER_BUS_QUIET_MS         1000  // Bus silent this long: poll slowly, allow light sleep
+#define POWER_BUS_POLL_MS            50  // UART poll period on a quiet bus; the UART ring covers it
+
+// Changes to these fields count as activity. Slowly drifting values (current,
+// voltage, temperatures, derived figures) update on screen without waking it.
+#define POWER_WAKE_FIELDS  (DASH_FIELD_BIT(FIELD_SPEED) | DASH_FIELD_BIT(FIELD_MODE) | \
+                            DASH_FIELD_BIT(FIELD_ARMED))
+
+enum PowerState : uint8_t {
+  POWER_ACTIVE = 0,
+  POWER_DIM,
+  POWER_IDLE,
+  POWER_STATE_COUNT
+};
+
+/* Since boot. Wake-ups are touch wake-ups out of DIM or IDLE, timed from the
+ * touch sample to full clock and backlight. */
+struct PowerStats {
+  uint32_t state_ms[POWER_STATE_COUNT];    // Time spent in each state
+  uint32_t entries[POWER_STATE_COUNT];
+  uint32_t loops[POWER_STATE_COUNT];       // uiTask passes in each state
+  uint32_t busy_us[POWER_STATE_COUNT];     // uiTask time between waits
+  uint32_t wakes[POWER_STATE_COUNT];
+  uint32_t wake_us[POWER_STATE_COUNT];
+  uint32_t wake_max_us[POWER_STATE_COUNT];
+};
+
+/* Owned by uiTask, except the bus locks taken by the transport tasks (power_bus_active) */
+struct PowerManager {
+  PowerState state;
+  uint8_t    brightness;        // User backlight level, used as is while active
+  uint32_t   last_activity_ms;
+  uint32_t   state_since_ms;
+  uint32_t   wake_start_us;     // Touch sample that is waking us, 0 = none
+  PowerState wake_from;
+  bool       dfs;               // esp_pm frequency scaling (and light sleep) available
+  PowerStats stats;
+};
+
+extern PowerManager power;
+
+// Configures frequency scaling and light sleep; call before the tasks start
+void power_init(PowerManager *pm, uint32_t now_ms);
+
+void power_activity(PowerManager *pm, uint32_t now_ms);
+void power_touch(PowerManager *pm, uint32_t now_ms, uint32_t sample_us);
+void power_set_brightness(PowerManager *pm, uint8_t level);
+
+/* Move to the state the activity calls for, setting the CPU clock and sleep
+ * locks. Returns true when the state changed; the caller then applies the
+ * backlight and LVGL timer periods and calls power_wake_done. */
+bool power_update(PowerManager *pm, uint32_t now_ms);
+void power_wake_done(PowerManager *pm, uint32_t now_us);
+
+uint8_t  power_backlight(const PowerManager *pm);
+
+// Backlight PWM on pin at full level; call once after power_init. Until then,
+// or when it fails, power_backlight_write does nothing.
+bool power_backlight_begin(int pin);
+void power_backlight_write(uint8_t level);
+uint32_t power_cpu_mhz();
+
+/* How long uiTask may block: until LVGL's next timer (lv_timer_handler's
+ * return value), within POWER_LOOP_MIN_MS..POWER_LOOP_MAX_MS */
+uint32_t power_loop_wait(PowerManager *pm, uint32_t lvgl_next_ms, uint32_t busy_us);
+
+/* Transport tasks: a bus keeps light sleep off while it carries traffic, and
+ * its receiver wakes the chip (a UART by its RX edge count, anything else by
+ * its RX pin going low). Calls to power_bus_active must alternate, starting
+ * with true. */
+void power_bus_wake_uart(uart_port_t uart);
+void power_bus_wake_pin(int rx_pin);
+void power_bus_active(bool active);
+
+const char *power_state_name(PowerState s);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_transport.h"
+
+// Receive buffer: one largest frame plus slack for the start of the next
+#define RS485_RX_BUF_LEN      (FRAME_MAX_LEN + 64)
+
+/* STX/ETX framing over a byte stream. Bytes go in at buf + pos; decode finds
+ * complete frames, validates and decodes them into a batch in place. Decoded
+ * frames and junk before them stay in the buffer until compact(), so the
+ * batch can point into it until it has been ingested. */
+struct Rs485Framer {
+  uint8_t  buf[RS485_RX_BUF_LEN];
+  uint16_t pos;                // Bytes in buf
+  uint16_t consumed;           // Leading bytes already decoded or discarded
+  uint32_t truncated;          // Valid frames whose TLVs ran short, delivered partly decoded
+};
+
+void    rs485_framer_init(Rs485Framer *f);
+void    rs485_framer_compact(Rs485Framer *f);
+uint8_t rs485_framer_decode(Rs485Framer *f, TelemetryBatch *batch);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <HardwareSerial.h>
+#include <driver/uart.h>
+
+#include "telemetry_transport.h"
+#include "rs485_framer.h"
+
+#define RS485_POLL_MS         5    // UART poll period while the bus carries traffic
+
+struct Rs485Transport {
+  Rs485Framer     framer;
+  HardwareSerial *port;        // Opened by the caller
+  uart_port_t     uart;        // The UART behind port, for the light-sleep wake-up
+};
+
+void rs485_transport_init(TelemetryTransport *t, Rs485Transport *ctx, HardwareSerial *port, uart_port_t uart);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <SPI.h>
+
+/* Telemetry recorder on the SD card. Telemetry ingest queues every valid frame
+ * into a RAM ring without blocking; a low-priority writer task on core 0 moves it to
+ * the card in whole 512-byte blocks, a batch per bus hold, giving the bus
+ * back to the display between blocks (see spi_bus.h).
+ *
+ * File format: records back to back, each a little-endian uint32 millis()
+ * followed by the frame exactly as received (STX ... CRC), so the frame's own
+ * length field and CRC delimit and check it. CAN messages are stored as the
+ * equivalent frame. One file per boot. */
+#define SD_LOG_RING_LEN      8192   // Power of two; ~1.5 s of traffic with cell arrays
+#define SD_LOG_BLOCK          512   // SD sector
+#define SD_LOG_BATCH_BLOCKS     4   // Blocks staged and written per bus hold
+#define SD_LOG_PERIOD_MS      100   // Writer wake-up
+#define SD_LOG_SYNC_MS       2000   // Partial block written and file synced at least this often
+#ifndef SD_LOG_SPI_HZ
+#define SD_LOG_SPI_HZ    16000000
+#endif
+
+/* Writer-side figures are written by the writer task, records and dropped by
+ * telemetry ingest; every member is an independent 32-bit word. */
+struct SdLogStats {
+  bool     active;             // Card mounted and file open
+  uint32_t records;            // Frames queued
+  uint32_t dropped;            // Frames lost to a full ring
+  uint32_t bytes_written;
+  uint32_t write_errors;
+  uint32_t hold_max_us;        // Longest single bus hold
+  char     path[16];
+};
+
+extern SdLogStats sdLog;
+
+// Starts the writer task, which mounts the card on spi (shared with the panel)
+void sd_log_begin(uint8_t cs_pin, SPIClass &spi);
+
+// Telemetry ingest only, under dataMutex. False when the frame did not fit (or logging is off).
+bool sd_log_frame(const uint8_t *frame, uint16_t len, uint32_t now_ms);
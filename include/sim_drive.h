@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+/* Synthetic drive for the on-device benchmarks and the host tests (test/).
+ * Speed and current move on every update, voltage every other update,
+ * everything else drifts slowly. Raw wire units; the values stay within
+ * their fields' ranges for the first SIM_DRIVE_UPDATES updates. */
+#define SIM_DRIVE_UPDATES   2000   // 100 s of driving at 20 Hz
+
+static inline void sim_drive_values(uint32_t n, uint32_t *v) {
+  v[FIELD_SOC]          = 80 - n / 600;
+  v[FIELD_VOLTAGE]      = 4800 - n / 2;
+  v[FIELD_CURRENT]      = 1500 + (n * 13) % 300;
+  v[FIELD_BATTERY_TEMP] = 250 + n / 400;
+  v[FIELD_SPEED]        = 300 + (n * 7) % 200;
+  v[FIELD_MODE]         = MODE_CITY;
+  v[FIELD_ARMED]        = 1;
+  v[FIELD_RANGE]        = 1200 - n / 50;
+  v[FIELD_CONSUMPTION]  = 650 + (n / 100) % 20;
+  v[FIELD_AMBIENT_TEMP] = 300 + n / 500;
+  v[FIELD_TRIP]         = n / 36;
+  v[FIELD_ODOMETER]     = 123450 + n / 36;
+  v[FIELD_AVG_SPEED]    = 350 + n / 300;
+}
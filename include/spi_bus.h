@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Arbiter for the shared VSPI bus: the panel and the SD card. The display
+ * flush comes first: while a flush waits, the SD writer cannot take the bus,
+ * and a writer already on it checks spi_bus_contended() between blocks and
+ * lets go. Hold the bus only around transfers; prepare data before acquiring. */
+enum SpiClient : uint8_t {
+  SPI_CLIENT_DISPLAY = 0,      // Highest priority first
+  SPI_CLIENT_SD,
+  SPI_CLIENT_COUNT
+};
+
+#define SPI_BUS_FLUSH_TIMEOUT_MS  500  // A flush waiting longer than this is skipped and redrawn later
+
+/* Since boot. Each client is a single task and writes only its own entries. */
+struct SpiBusStats {
+  uint32_t acquires[SPI_CLIENT_COUNT];
+  uint32_t busy_us[SPI_CLIENT_COUNT];      // Bus held
+  uint32_t wait_us[SPI_CLIENT_COUNT];      // Waiting to get it
+  uint32_t wait_max_us[SPI_CLIENT_COUNT];
+  uint32_t timeouts[SPI_CLIENT_COUNT];
+  uint32_t yields;                         // SD holds cut short by a waiting flush
+};
+
+extern SpiBusStats spiBusStats;
+
+bool spi_bus_init();
+bool spi_bus_acquire(SpiClient c, uint32_t timeout_ms);
+void spi_bus_release(SpiClient c);
+
+// True while a higher-priority client waits: finish the current block and release
+bool spi_bus_contended(SpiClient c);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+// ===== Bus Node Addresses =====
+#define NODE_ADDR_LEGACY    0x00  // Single-controller buses leave the header zeroed
+#define NODE_ADDR_BMS       0x10
+#define NODE_ADDR_MOTOR     0x20
+#define NODE_ADDR_CHARGER   0x30
+
+// Frames from addresses missing in the routing table go to the legacy route
+// when set, so controllers that put something else in the header keep working.
+#ifndef ROUTE_UNKNOWN_TO_LEGACY
+#define ROUTE_UNKNOWN_TO_LEGACY 1
+#endif
+
+enum NodeKind {
+  NODE_LEGACY = 0,
+  NODE_BMS,
+  NODE_MOTOR,
+  NODE_CHARGER,
+  NODE_COUNT
+};
+
+/* Typed per-node stores. Guarded by dataMutex like dashData. */
+struct BmsData {
+  int   soc;
+  float voltage;
+  float current;
+  int   temp;
+};
+
+struct MotorData {
+  int     speed;
+  int     motor_temp;
+  uint8_t mode;
+  bool    armed;
+  int     range;
+  int     avg_wkm;
+  int     trip;
+  int     odo;
+  int     avg_kmh;
+};
+
+struct ChargerData {
+  float voltage;
+  float current;
+  int   temp;
+};
+
+/* What the router has seen from one node. Starts zeroed. */
+struct NodeRouteState {
+  uint32_t    last_rx_ms;       // Freshness timestamp of the last routed frame
+  uint32_t    frames;
+  bool        seen;
+  bool        stale;
+  TelemetrySeqTracker seq;      // Sequence numbers are per sender
+};
+
+/* One routing table entry: where frames from a source address go */
+struct NodeRoute {
+  uint8_t     address;
+  NodeKind    kind;
+  const char *name;
+  uint16_t    dash_fields;      // Fields this node drives on the dashboard
+  uint32_t    stale_after_ms;   // No frame for this long = stale
+
+  NodeRouteState state;
+};
+
+extern BmsData bmsData;
+extern MotorData motorData;
+extern ChargerData chargerData;
+
+NodeRoute *telemetry_find_route(uint8_t address);
+NodeRoute *telemetry_route_frame(const FrameHeader *hdr, const TelemetryFrame *frame, uint32_t now_ms);
+uint8_t    telemetry_check_staleness(uint32_t now_ms);
+NodeRoute *telemetry_routes(uint8_t *count);
+uint32_t   telemetry_unrouted_frames();
+void       telemetry_reset_routes();
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ===== Dashboard Protocol Constants =====
+#define STX1             0x5D  // Start of text1
+#define STX2             0x47  // Start of text2
+#define ETX              0x78  // End of text
+
+// Frame layout: STX1 STX2 LEN_H LEN_L | 7 header bytes | TLVs | 4 trailer bytes | ETX | CRC_H CRC_L
+// LEN counts everything from the first header byte up to and including ETX.
+#define FRAME_HEADER_OFFSET   4
+#define FRAME_HEADER_SIZE     7
+#define FRAME_INFO_OFFSET     (FRAME_HEADER_OFFSET + FRAME_HEADER_SIZE)
+#define FRAME_TRAILER_SIZE    4
+#define FRAME_OVERHEAD        (FRAME_INFO_OFFSET + FRAME_TRAILER_SIZE + 1 + 2)
+
+// Largest frame accepted, overhead included. LEN is 16 bits so the wire allows
+// up to 64 KB; the receive buffer is sized from this, so raise it with
+// -D FRAME_MAX_LEN=... only as far as RAM allows.
+#ifndef FRAME_MAX_LEN
+#define FRAME_MAX_LEN         2048
+#endif
+#if FRAME_MAX_LEN < FRAME_OVERHEAD || FRAME_MAX_LEN > 0xFFFF
+#error "FRAME_MAX_LEN must be between FRAME_OVERHEAD and 65535"
+#endif
+
+// Header bytes (offsets into the frame). Bytes 7-10 are reserved.
+#define FRAME_HDR_SOURCE      4   // Source node address
+#define FRAME_HDR_DEST        5   // Destination address (0x00 = broadcast)
+#define FRAME_HDR_MSG_TYPE    6   // Message type
+
+// Message types
+#define MSG_TELEMETRY         0x01  // TLV telemetry fields
+#define MSG_TELEMETRY_BULK    0x02  // TLV telemetry fields plus bulk blocks
+
+// Data Identifiers
+#define ID_SOC           0x85  // State of Charge (0-100%)
+#define ID_VOLTAGE       0x83  // Total voltage (0.01V precision)
+#define ID_CURRENT       0x84  // Current (0.01A precision)
+#define ID_TEMP          0x80  // Battery Temperature (0.1°C precision)      battery_temp_label
+#define ID_SPEED         0x82  // Vehicle speed (0.1 km/h precision)          speed_label
+#define ID_MODE          0x86  // Driving mode (0=ECO, 1=CITY, 2=SPORT)        mode_label
+#define ID_ARMED         0x87  // Armed status (0=DISARMED, 1=ARMED)            status_label
+#define ID_RANGE         0x88  // Remaining range (0.1 km precision)             range_label
+#define ID_CONSUMPTION   0x89  // Average consumption (0.1 W/km precision)       avg_wkm_label
+#define ID_AMBIENT_TEMP  0x8A  // Ambient temperature (0.1°C precision)           motor_temp_label
+#define ID_TRIP          0x8B  // Trip distance (0.1 km precision)               trip_label
+#define ID_ODOMETER      0x8C  // Odometer (0.1 km precision)                    odo_label
+#define ID_AVG_SPEED     0x8D  // Average speed (0.1 km/h precision)            avg_kmh_label
+
+// Frame control. Lives in the 0x80-0x8F block so older decoders skip it as a
+// plain 2-byte field. Bit 15 = keyframe, bits 0-14 = frame sequence number.
+// Frames without it are legacy full frames and are treated as keyframes.
+#define ID_FRAME_SEQ     0x8E
+#define FRAME_SEQ_KEYFRAME  0x8000
+#define FRAME_SEQ_MASK      0x7FFF
+
+// Wall-clock time of day in 2-second steps (0-43199), also skippable by
+// older decoders. Drives the clock instead of millis().
+#define ID_TIME_OF_DAY   0x8F
+
+// Bulk blocks (per-cell arrays, fault dumps): ID, LEN_H, LEN_L, LEN bytes.
+// Older decoders skip a single byte for an unknown ID from 0x90 up and then
+// misread the length and payload as TLVs, so blocks only go in
+// MSG_TELEMETRY_BULK frames. A sender uses that type only towards receivers
+// known to decode blocks; telemetry_encode_frame refuses blocks in any other.
+#define ID_BLOCK_FIRST   0x90
+#define ID_BLOCK_LAST    0x9F
+#define TELEMETRY_MAX_BLOCKS  4
+
+// Per-cell arrays. Payload: index of the first cell, then one value per cell,
+// so a pack can be split over several blocks or frames.
+#define ID_CELL_VOLTAGES 0x90  // uint16 per cell, mV
+#define ID_CELL_TEMPS    0x91  // int8 per cell, °C
+
+// Driving Modes
+enum DrivingMode {
+  MODE_ECO = 0,
+  MODE_CITY = 1,
+  MODE_SPORT = 2
+};
+
+// Telemetry fields, one bit each in a field mask
+enum TelemetryField {
+  FIELD_SOC = 0,
+  FIELD_VOLTAGE,
+  FIELD_CURRENT,
+  FIELD_BATTERY_TEMP,
+  FIELD_SPEED,
+  FIELD_MODE,
+  FIELD_ARMED,
+  FIELD_RANGE,
+  FIELD_CONSUMPTION,
+  FIELD_AMBIENT_TEMP,
+  FIELD_TRIP,
+  FIELD_ODOMETER,
+  FIELD_AVG_SPEED,
+  FIELD_COUNT
+};
+
+#define FIELD_BIT(f)     ((uint16_t)(1u << (f)))
+#define FIELD_MASK_ALL   ((uint16_t)((1u << FIELD_COUNT) - 1))
+
+/* Addressing from the frame header */
+struct FrameHeader {
+  uint8_t source;
+  uint8_t dest;
+  uint8_t msg_type;
+};
+
+/* A bulk block inside a received frame. data points into the receive buffer
+ * and is only valid until the frame is consumed. */
+struct TelemetryBlock {
+  uint8_t        id;
+  uint16_t       len;
+  const uint8_t *data;
+};
+
+/* One decoded frame. Values are raw wire values, unscaled. */
+struct TelemetryFrame {
+  uint16_t present;            // FIELD_BIT mask of fields carried by the frame
+  bool     has_seq;            // ID_FRAME_SEQ was present
+  bool     keyframe;           // Full snapshot (always true for legacy frames)
+  uint16_t seq;                // Sequence number when has_seq
+  bool     has_time;           // ID_TIME_OF_DAY was present
+  uint32_t time_of_day;        // Seconds since midnight when has_time
+  uint32_t raw[FIELD_COUNT];
+  uint8_t  block_count;        // Bulk blocks carried (extra ones are dropped)
+  TelemetryBlock blocks[TELEMETRY_MAX_BLOCKS];
+};
+
+/* Sender side: keyframe every keyframe_interval frames, deltas in between */
+struct TelemetryEncoder {
+  FrameHeader header;          // Written into every frame (zeroed by init)
+  uint16_t fields;             // Fields this sender owns (all by default)
+  uint32_t last[FIELD_COUNT];  // Values as of the last frame sent
+  uint16_t seq;
+  uint16_t since_keyframe;
+  uint16_t keyframe_interval;
+  bool     force_keyframe;
+};
+
+/* Receiver side: sequence gap detection */
+struct TelemetrySeqTracker {
+  bool     synced;             // Seen at least one sequenced frame
+  bool     gap;                // Frames were lost just before the last one tracked
+  bool     awaiting_keyframe;  // Since a gap: fields no frame has carried since may be out of date
+  uint16_t last_seq;
+  uint32_t keyframes;
+  uint32_t deltas;
+  uint32_t gaps;
+  uint32_t lost_frames;
+};
+
+uint16_t calculateChecksum(const uint8_t *data, uint16_t length);
+bool validateFrame(const uint8_t* frame, uint16_t len);
+
+int8_t  telemetry_field_for_id(uint8_t id);
+uint8_t telemetry_id_for_field(uint8_t field);
+uint8_t telemetry_field_size(uint8_t field);
+float   telemetry_scale(uint8_t field, uint32_t raw);
+
+void     telemetry_parse_header(const uint8_t *frame, FrameHeader *hdr);
+
+bool     telemetry_decode_fields(const uint8_t *info, uint16_t len, TelemetryFrame *out);
+uint16_t telemetry_encode_frame(uint8_t *out, uint16_t cap, const TelemetryFrame *frame,
+                                const FrameHeader *hdr);
+
+void     telemetry_encoder_init(TelemetryEncoder *enc, uint16_t keyframe_interval);
+uint16_t telemetry_encoder_next(TelemetryEncoder *enc, const uint32_t *values,
+                                uint8_t *out, uint16_t cap);
+
+void telemetry_seq_track(TelemetrySeqTracker *trk, const TelemetryFrame *frame);
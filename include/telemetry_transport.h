@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_protocol.h"
+
+#define TRANSPORT_BATCH_MAX   16   // Frames handed to the ingest step at once
+#define TRANSPORT_WAIT_MS     50   // Longest a receive call blocks; bounds housekeeping latency
+
+/* Frames decoded by one receive call. They are ingested together, so shared
+ * state is locked once per batch rather than once per frame. raw (when set)
+ * and block data point into the transport's buffer and stay valid until its
+ * next receive call. */
+struct TelemetryBatch {
+  uint8_t        count;
+  FrameHeader    hdr[TRANSPORT_BATCH_MAX];
+  TelemetryFrame frame[TRANSPORT_BATCH_MAX];
+  const uint8_t *raw[TRANSPORT_BATCH_MAX];      // Wire frame as received, NULL if not framed
+  uint16_t       raw_len[TRANSPORT_BATCH_MAX];
+};
+
+/* A telemetry source: RS485 framing, CAN, or a virtual stand-in. Every
+ * backend decodes into the same TelemetryFrame and routes through the same
+ * nodes, so the dashboard does not know where a value came from. One task
+ * per transport calls receive() in a loop and ingests the batch. */
+struct TelemetryTransport {
+  const char *name;
+  bool     (*begin)(TelemetryTransport *t);
+  // Wait (at most about wait_ms) for traffic, then decode what arrived into t->batch
+  uint8_t  (*receive)(TelemetryTransport *t, uint32_t wait_ms);
+  void      *ctx;
+
+  TelemetryBatch batch;
+  uint32_t last_rx_ms;         // Any traffic at all, valid or not (set by the backend)
+  uint32_t rx_dropped;         // Lost before decoding: receive queue overruns
+  bool     quiet;              // No traffic for POWER_BUS_QUIET_MS (set by the task)
+};
+
+/* Claim the next frame slot: its index, or TRANSPORT_BATCH_MAX when full */
+static inline uint8_t telemetry_batch_add(TelemetryBatch *b) {
+  return b->count < TRANSPORT_BATCH_MAX ? b->count++ : TRANSPORT_BATCH_MAX;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#define RTC_I2C_ADDR          0x68     // DS3231 / DS1307 compatible
+#define RTC_RESYNC_MS         60000    // Re-read the RTC once a minute
+#define RTC_WRITEBACK_MS      3600000  // Copy bus time into the RTC at most hourly
+#define BUS_TIME_VALID_MS     600000   // Bus time is trusted for 10 min after the last update
+
+#ifndef CLOCK_24H
+#define CLOCK_24H 0                    // 1 = "21:41", 0 = "9:41 PM"
+#endif
+
+enum TimeSourceKind {
+  TIME_SRC_NONE = 0,   // Nothing set the clock yet
+  TIME_SRC_RTC,        // External RTC on the touch I2C bus
+  TIME_SRC_BUS         // Time-of-day field from the RS485 bus
+};
+
+void time_source_begin(SemaphoreHandle_t i2c_mutex);
+void time_source_set_from_bus(uint32_t seconds_of_day, uint32_t now_ms);
+void time_source_poll(uint32_t now_ms);
+
+TimeSourceKind time_source_kind(uint32_t now_ms);
+int32_t time_source_seconds_of_day(uint32_t now_ms);  // -1 when unknown
+
+void format_time_of_day(char *buf, size_t len, int32_t seconds_of_day, bool use_24h);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+/* LVGL memory backend (LV_USE_STDLIB_MALLOC = LV_STDLIB_CUSTOM).
+ *
+ * Small blocks (objects, styles, observers, label text) come from fixed
+ * size-class pools. A freed block only ever serves its own class again, so
+ * rebuilding screens cannot cut the heap into pieces. While a screen is being
+ * built, its blocks up to UI_ARENA_MAX_ALLOC go to the screen arena instead:
+ * a bump region that is released in one step when its last block is freed,
+ * which is when the screen is cleaned. Anything bigger (draw layers,
+ * snapshots) goes to the heap, or to PSRAM from UI_PSRAM_MIN_ALLOC up on
+ * boards that have it. A full pool or arena falls through to the next tier
+ * and is counted. The backend is safe to call from the draw threads; only
+ * the task that began the arena allocates from it. */
+#define UI_POOL_CLASSES       4
+#define UI_ARENA_BYTES        (20 * 1024)
+#define UI_ARENA_MAX_ALLOC    256
+#define UI_PSRAM_MIN_ALLOC    4096
+
+// Alarm thresholds, checked by ui_alloc_check()
+#define UI_HEAP_BLOCK_ALARM   (24 * 1024)   // Largest internal block: a snapshot plus a draw layer
+#define UI_HEAP_FRAG_ALARM    50            // % of the free internal heap outside the largest block
+
+enum UiAllocAlarm : uint8_t {
+  UI_ALARM_HEAP_BLOCK   = 1 << 0,   // Largest free internal block below UI_HEAP_BLOCK_ALARM
+  UI_ALARM_HEAP_FRAG    = 1 << 1,   // Internal heap fragmentation above UI_HEAP_FRAG_ALARM
+  UI_ALARM_POOL_FULL    = 1 << 2,   // Small blocks went to the heap since the last check
+  UI_ALARM_ARENA_PINNED = 1 << 3,   // A screen's blocks outlived it since the last check
+};
+
+struct UiAllocStats {
+  uint16_t class_size[UI_POOL_CLASSES];
+  uint16_t class_blocks[UI_POOL_CLASSES];
+  uint16_t class_used[UI_POOL_CLASSES];
+  uint16_t class_peak[UI_POOL_CLASSES];
+  uint32_t pool_fallbacks;     // Small blocks that found every fitting class full
+
+  uint32_t arena_used;         // Bytes, headers included
+  uint32_t arena_peak;
+  uint32_t arena_live;         // Blocks not freed yet
+  uint32_t arena_resets;       // Times the arena was released in one step
+  uint32_t arena_pinned;       // Screen builds that found the last screen's blocks alive
+  uint32_t arena_overflows;    // Blocks that did not fit in the arena
+
+  uint32_t heap_live;          // LVGL blocks on the heap or in PSRAM
+  uint32_t psram_allocs;
+  uint32_t failed;             // Allocations no tier could serve
+
+  // Internal heap, sampled by ui_alloc_check()
+  uint32_t heap_free;
+  uint32_t heap_largest;
+  uint32_t heap_largest_min;   // Low-water mark since boot
+  uint8_t  heap_frag_pct;
+  uint8_t  alarms;             // UiAllocAlarm bits currently raised
+};
+
+/* Bracket a screen build: clean the old widgets, begin, create the new ones,
+ * end before the first render so draw-time blocks stay out of the arena */
+void ui_alloc_arena_begin();
+void ui_alloc_arena_end();
+
+void ui_alloc_stats(UiAllocStats *s);
+
+/* Sample the internal heap and update the alarms. Returns the alarms raised
+ * since the last call. Cheap enough for a periodic timer. */
+uint8_t ui_alloc_check();
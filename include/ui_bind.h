@@ -0,0 +1,38 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include "telemetry_protocol.h"
+#include "derived_metrics.h"
+
+/* Telemetry data binding. Every TelemetryField and DerivedField is an LVGL int
+ * subject holding the value in display units: whole units, except voltage,
+ * current and energy in hundredths; mode is a DrivingMode and armed is 0/1.
+ *
+ * Widgets subscribe with the ui_bind_* calls and get the current value at
+ * once. Bindings are observers owned by the widget, so LVGL drops them when
+ * the widget is deleted: publishing only reaches widgets alive on the current
+ * screen and never a freed one. Every bound widget is also greyed out while
+ * any of its fields is stale. Call from the LVGL thread only. */
+
+void ui_bind_init();
+
+lv_subject_t *ui_bind_subject(uint8_t field);
+int32_t ui_bind_value(uint8_t field);
+
+// Notifies the field's widgets only when the value actually changed
+void ui_bind_publish(uint8_t field, int32_t value);
+// DASH_FIELD_BIT mask, derived values included (see derived_stale_fields)
+void ui_bind_publish_stale(uint32_t stale_fields);
+
+/* Label text from a printf format taking the field value: an int conversion
+ * for whole-unit fields, a float one for hundredths. fmt must stay
+ * valid for the lifetime of the label (a literal). */
+void ui_bind_label(lv_obj_t *label, uint8_t field, const char *fmt);
+
+/* Custom binding: cb runs for every change of any field in the DASH_FIELD_BIT
+ * mask, with lv_observer_get_target_obj() returning obj */
+void ui_bind_obj(lv_obj_t *obj, uint32_t fields, lv_observer_cb_t cb, void *user_data);
+
+// Null *ref when the object it points to is deleted
+void ui_bind_clear_on_delete(lv_obj_t **ref);
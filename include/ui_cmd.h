@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/* Commands into the UI. Any task (or ISR) posts without blocking; uiTask
+ * drains the queue once per loop and runs the commands in LVGL context. */
+enum UiCmdType : uint8_t {
+  UI_CMD_SCREEN = 0,     // arg = screen id, latest request wins
+  UI_CMD_BRIGHTNESS,     // arg = backlight level 0-255, latest wins
+  UI_CMD_ALERT,          // text = static message, arg = seconds shown; all kept
+  UI_CMD_BANNER,         // text = top alert or NULL to hide, arg = priority | others << 8; latest wins
+  UI_CMD_TYPE_COUNT
+};
+
+struct UiCmd {
+  UiCmdType   type;
+  int32_t     arg;
+  const char *text;      // Must outlive the command (a literal or static)
+};
+
+#define UI_CMD_QUEUE_LEN   16   // Power of two
+
+/* Bounded lock-free multi-producer / single-consumer ring. Each slot carries a
+ * sequence number: producers claim a position with one compare-and-swap on
+ * head and publish the slot by advancing its sequence, so the consumer never
+ * sees a half-written command and producers never wait on each other. */
+struct UiCmdQueue {
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    UiCmd cmd;
+  } slots[UI_CMD_QUEUE_LEN];
+  std::atomic<uint32_t> head;      // Next position to claim (producers)
+  uint32_t tail;                   // Next position to read (consumer only)
+  std::atomic<uint32_t> dropped;   // Pushes refused because the ring was full
+};
+
+void ui_cmd_queue_init(UiCmdQueue *q);
+bool ui_cmd_queue_push(UiCmdQueue *q, const UiCmd *cmd);   // false when full
+bool ui_cmd_queue_pop(UiCmdQueue *q, UiCmd *out);           // Consumer only
+
+/* Pop everything pending (up to cap) into out with redundant commands
+ * coalesced: only the latest SCREEN, BRIGHTNESS and BANNER survive, in the position
+ * of that latest one. Returns the number of commands in out. Consumer only. */
+uint8_t ui_cmd_queue_collect(UiCmdQueue *q, UiCmd *out, uint8_t cap);
+
+// The queue uiTask drains. Initialised in setup() before any task starts.
+extern UiCmdQueue ui_cmds;
+
+bool ui_cmd_post(UiCmdType type, int32_t arg, const char *text = nullptr);
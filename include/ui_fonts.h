@@ -0,0 +1,10 @@
+#pragma once
+
+#include <lvgl.h>
+
+/* UI fonts by pixel size (14, 16, 18, 20, 24, 32, 48).
+ * Built with DASH_ASSET_FONTS they come from the flash asset partition
+ * ("montserrat_16" etc., see tools/pack_assets.py). The compiled-in Montserrat
+ * fonts are then unreferenced and the linker drops them from the app image.
+ * A size missing from the partition falls back to LV_FONT_DEFAULT. */
+const lv_font_t *ui_font(uint8_t px);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <lvgl.h>
+
+/* Resolution-independent layout. Screens are designed against the 480x320
+ * panel; ui_layout_init() reads the real resolution and derives a scale
+ * factor and a size class from it. Widgets are then placed by flex rows and
+ * columns or grids instead of pixel offsets, fixed sizes go through ui_px(),
+ * and fonts through ui_font_px(), so one build renders on 480x320 and on
+ * 800x480 (or larger) panels. At 480x320 every value comes out unchanged. */
+#define UI_DESIGN_HOR_RES   480
+#define UI_DESIGN_VER_RES   320
+
+// Picked from the shorter panel side; selects the spacing tokens below
+enum UiSizeClass : uint8_t {
+  UI_SIZE_COMPACT,     // Below 400 px (480x320)
+  UI_SIZE_REGULAR,     // Below 560 px (800x480)
+  UI_SIZE_LARGE,       // 1024x600 and up
+  UI_SIZE_CLASS_COUNT
+};
+
+struct UiLayout {
+  int32_t     hor_res;
+  int32_t     ver_res;
+  uint16_t    scale;         // Design px to panel px, 8.8 fixed point (256 = 1:1)
+  UiSizeClass size_class;
+
+  // Spacing tokens of the size class, in panel px
+  int32_t     pad;           // Screen edges and container insides
+  int32_t     gap;           // Between the items of a row or column
+  int32_t     touch;         // Height of anything meant to be pressed
+  int32_t     radius;        // Cards and buttons
+};
+
+extern UiLayout ui_layout;
+
+// Call again whenever a different display becomes the default one
+void ui_layout_init(lv_display_t *disp);
+
+// Design size to panel size. Uniform scale: the smaller of the two axis ratios.
+int32_t ui_px(int32_t design_px);
+
+/* Font for a design pixel size: the largest available size (see ui_font())
+ * that does not exceed the scaled size, so text never outgrows its box */
+const lv_font_t *ui_font_px(uint8_t design_px);
+
+const char *ui_size_class_name(UiSizeClass c);
+
+/* Layout containers: no background, border, padding or scrolling, sized to
+ * their content until told otherwise. Children are placed by the layout. */
+lv_obj_t *ui_layout_row(lv_obj_t *parent, lv_flex_align_t main_place);
+lv_obj_t *ui_layout_column(lv_obj_t *parent, lv_flex_align_t main_place, lv_flex_align_t cross_place);
+// col_dsc and row_dsc must outlive the grid (LVGL keeps the pointers)
+lv_obj_t *ui_layout_grid(lv_obj_t *parent, const int32_t *col_dsc, const int32_t *row_dsc);
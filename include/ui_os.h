@@ -0,0 +1,32 @@
+#pragma once
+
+/* LVGL OS layer (LV_USE_OS = LV_OS_CUSTOM, included by LVGL through
+ * LV_OS_CUSTOM_INCLUDE, so C as well as C++).
+ *
+ * The same FreeRTOS primitives LVGL's own port uses, except that its threads
+ * (the software draw units) get a core each. LVGL's port creates them
+ * without affinity, so both can end up on one core. The first thread runs on
+ * core 1 beside uiTask, which only dispatches and then waits for the draw
+ * units; the second on core 0 beside the telemetry tasks, which run at a
+ * higher priority than LV_DRAW_THREAD_PRIO. Any further thread floats. */
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#define UI_OS_FIRST_THREAD_CORE   1
+#define UI_OS_SECOND_THREAD_CORE  0
+
+typedef struct {
+  void (*callback)(void *);
+  void *user_data;
+  TaskHandle_t task;           // NULL once the thread has returned
+} lv_thread_t;
+
+typedef struct {
+  SemaphoreHandle_t sem;       // Recursive: lv_lock() may nest
+} lv_mutex_t;
+
+// Latched like LVGL's: a signal before the wait is not lost
+typedef struct {
+  SemaphoreHandle_t sem;       // Binary
+} lv_thread_sync_t;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include "cell_store.h"
+
+/* The dashboard, its sidebar and the detail screens. Each show_* call cleans
+ * the default display's active screen and builds its screen there, bound to
+ * ui_bind. Only LVGL and the ui_* modules are used, so the screens build on
+ * the host as well (test/test_screens renders them headless). */
+
+// Screen ids of UI_CMD_SCREEN; 0-4 are the detail screens in sidebar order
+#define SCREEN_BATTERY      0
+#define SCREEN_VOLTAGE      1
+#define SCREEN_TEMPERATURE  2
+#define SCREEN_STATISTICS   3
+#define SCREEN_SETTINGS     4
+#define SCREEN_DASHBOARD    5
+#define SCREEN_DIAGNOSTICS  6
+
+// Per-cell data the battery screen shows: uiTask's own copy, LVGL thread only
+extern CellStore ui_cells;
+extern lv_obj_t *cell_map;       // The battery screen's cell view, NULL elsewhere
+
+extern bool sidebar_open;
+
+void create_ev_dashboard_ui();
+void show_battery_screen();
+void show_voltage_screen();
+void show_temperature_screen();
+void show_statistics_screen();
+void show_settings_screen();
+
+void toggle_sidebar();
+void show_sidebar();
+void close_sidebar();
+// Delete the sidebar at once; from outside its own event callbacks only
+void sidebar_delete();
+
+/* Clear the screen and lay out a detail screen: header on top, content area
+ * filling the rest of the panel (a padded column, items centred). *right, if
+ * given, receives the empty header cell on the right of the title. Opens the
+ * screen arena: call ui_alloc_arena_end() once the widgets are in place. */
+lv_obj_t *screen_frame(const char *title_text, uint32_t bg, lv_obj_t **right);
+
+/* Provided by the application: label is the dashboard's new clock, fill it
+ * now and keep it current */
+void time_display_attach(lv_obj_t *label);
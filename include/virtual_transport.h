@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry_transport.h"
+#include "rs485_framer.h"
+#include "can_map.h"
+
+#define VIRTUAL_CAN_QUEUE_LEN  32
+#define VIRTUAL_CHUNK_LEN      64   // Bytes delivered per receive, like a UART poll
+
+/* Stand-in bus for benchmarks and bring-up without hardware: byte streams go
+ * through the real RS485 framer, CAN messages through the real signal map,
+ * and receive() never blocks. The caller owns the storage, so nothing is
+ * allocated unless a test uses it. No Arduino or FreeRTOS underneath, so it
+ * runs in the native tests as well; the caller keeps the clock. */
+struct VirtualCanMsg {
+  uint16_t id;
+  uint8_t  dlc;
+  uint8_t  data[8];
+};
+
+struct VirtualTransport {
+  Rs485Framer      framer;
+  const uint8_t   *bytes;      // Pending byte stream (not copied)
+  uint32_t         bytes_len;
+  uint32_t         bytes_pos;
+  VirtualCanMsg    can[VIRTUAL_CAN_QUEUE_LEN];
+  uint8_t          can_head;
+  uint8_t          can_count;
+  const CanSignal *signals;
+  uint8_t          signal_count;
+  uint32_t         now_ms;     // Stamped into last_rx_ms on traffic; advanced by the caller
+};
+
+void virtual_transport_init(TelemetryTransport *t, VirtualTransport *ctx,
+                            const CanSignal *signals, uint8_t signal_count);
+// Queue a byte stream; it must stay valid until receive() has taken all of it
+void virtual_transport_feed_bytes(TelemetryTransport *t, const uint8_t *bytes, uint32_t len);
+bool virtual_transport_push_can(TelemetryTransport *t, uint16_t id, const uint8_t *data, uint8_t dlc);
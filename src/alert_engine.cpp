@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include "alert_engine.h"
+
+#define RULE_BIT(r)  ((uint64_t)1 << (r))
+
+void alert_engine_init(AlertEngine *e, const AlertRule *rules, uint8_t count) {
+  memset(e, 0, sizeof(*e));
+  e->rules = rules;
+  e->rule_count = count < ALERT_MAX_RULES ? count : ALERT_MAX_RULES;
+  e->top = -1;
+
+  // Counting sort by field, keeping table order within a field
+  uint8_t per_field[DASH_FIELD_COUNT] = {};
+  for (uint8_t r = 0; r < e->rule_count; r++) {
+    if (rules[r].field < DASH_FIELD_COUNT) per_field[rules[r].field]++;
+  }
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    e->field_start[f + 1] = e->field_start[f] + per_field[f];
+  }
+  uint8_t fill[DASH_FIELD_COUNT];
+  memcpy(fill, e->field_start, sizeof(fill));
+  for (uint8_t r = 0; r < e->rule_count; r++) {
+    if (rules[r].field < DASH_FIELD_COUNT) e->by_field[fill[rules[r].field]++] = r;
+  }
+}
+
+/* Recompute the banner choice; true if it or the active count changed */
+static bool alert_engine_rank(AlertEngine *e) {
+  int8_t top = -1;
+  uint8_t count = 0;
+  for (uint64_t m = e->active; m; m &= m - 1) {
+    uint8_t r = __builtin_ctzll(m);
+    count++;
+    if (top < 0 || e->rules[r].priority > e->rules[top].priority) top = r;
+  }
+
+  bool changed = top != e->top || count != e->active_count;
+  e->top = top;
+  e->active_count = count;
+  return changed;
+}
+
+static void raise_rule(AlertEngine *e, uint8_t r) {
+  e->pending &= ~RULE_BIT(r);
+  e->active |= RULE_BIT(r);
+}
+
+bool alert_engine_update(AlertEngine *e, uint32_t changed, int32_t (*value)(uint8_t field),
+                         uint32_t now_ms) {
+  uint64_t active_before = e->active;
+
+  for (uint32_t m = changed; m; m &= m - 1) {
+    uint8_t f = __builtin_ctz(m);
+    if (f >= DASH_FIELD_COUNT || e->field_start[f] == e->field_start[f + 1]) continue;
+    int32_t v = value(f);
+
+    for (uint8_t i = e->field_start[f]; i < e->field_start[f + 1]; i++) {
+      uint8_t r = e->by_field[i];
+      const AlertRule *rule = &e->rules[r];
+      bool above = rule->kind == ALERT_ABOVE;
+      bool tripped = above ? v > rule->threshold : v < rule->threshold;
+
+      if (e->active & RULE_BIT(r)) {
+        bool cleared = above ? v <= rule->threshold - rule->hysteresis
+                             : v >= rule->threshold + rule->hysteresis;
+        if (cleared) e->active &= ~RULE_BIT(r);
+      } else if (!tripped) {
+        e->pending &= ~RULE_BIT(r);
+      } else if (!rule->debounce_ms) {
+        raise_rule(e, r);
+      } else if (!(e->pending & RULE_BIT(r))) {
+        e->pending |= RULE_BIT(r);
+        e->since_ms[r] = now_ms;
+      } else if (now_ms - e->since_ms[r] >= rule->debounce_ms) {
+        raise_rule(e, r);
+      }
+    }
+  }
+
+  return e->active != active_before && alert_engine_rank(e);
+}
+
+bool alert_engine_tick(AlertEngine *e, uint32_t now_ms) {
+  if (!e->pending) return false;
+
+  uint64_t active_before = e->active;
+  for (uint64_t m = e->pending; m; m &= m - 1) {
+    uint8_t r = __builtin_ctzll(m);
+    if (now_ms - e->since_ms[r] >= e->rules[r].debounce_ms) raise_rule(e, r);
+  }
+  return e->active != active_before && alert_engine_rank(e);
+}
+
+const AlertRule *alert_engine_top(const AlertEngine *e) {
+  return e->top >= 0 ? &e->rules[e->top] : NULL;
+}
@@ -0,0 +1,278 @@
+#include <Arduino.h>
+#include <string.h>
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+
+#include "asset_store.h"
+
+// Partition mmap API names changed in IDF 5
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_partition_mmap_handle_t asset_mmap_handle_t;
+#define ASSET_MMAP_DATA   ESP_PARTITION_MMAP_DATA
+#define asset_munmap      esp_partition_munmap
+#else
+typedef spi_flash_mmap_handle_t asset_mmap_handle_t;
+#define ASSET_MMAP_DATA   SPI_FLASH_MMAP_DATA
+#define asset_munmap      spi_flash_munmap
+#endif
+
+/* Packed font payload. Everything is an offset from the start of the payload,
+ * so the font is used in place: only the lv_font_t, its dsc and the cmap table
+ * (which hold pointers) are built in RAM. */
+struct PackedFont {
+  uint16_t line_height;
+  int16_t  base_line;
+  int8_t   underline_position;
+  int8_t   underline_thickness;
+  uint8_t  bpp;
+  uint8_t  bitmap_format;      // 0 plain, 1 compressed
+  uint8_t  subpx;
+  uint8_t  has_kern_classes;
+  uint16_t kern_scale;
+  uint16_t cmap_num;
+  uint16_t glyph_count;
+  uint32_t glyph_dsc_off;      // glyph_count x lv_font_fmt_txt_glyph_dsc_t
+  uint32_t cmaps_off;          // cmap_num x PackedCmap
+  uint32_t bitmap_off;
+  uint32_t kern_off;           // PackedKernClasses, when has_kern_classes
+};
+
+struct PackedCmap {
+  uint32_t range_start;
+  uint16_t range_length;
+  uint16_t glyph_id_start;
+  uint16_t list_length;
+  uint8_t  type;               // lv_font_fmt_txt_cmap_type_t
+  uint8_t  reserved;
+  uint32_t unicode_list_off;   // uint16_t[list_length], 0 if none
+  uint32_t glyph_id_ofs_off;   // uint8_t/uint16_t[list_length], 0 if none
+};
+
+struct PackedKernClasses {
+  uint8_t  left_class_cnt;
+  uint8_t  right_class_cnt;
+  uint16_t reserved;
+  uint32_t left_map_off;       // uint8_t[glyph_count]
+  uint32_t right_map_off;      // uint8_t[glyph_count]
+  uint32_t values_off;         // int8_t[left_class_cnt * right_class_cnt]
+};
+
+// The packer writes glyph descriptors in the small (non-LARGE) layout
+static_assert(sizeof(lv_font_fmt_txt_glyph_dsc_t) == 8, "LV_FONT_FMT_TXT_LARGE is not supported");
+
+// off + len within size, without overflowing
+static bool in_range(uint32_t off, uint32_t len, uint32_t size) {
+  return off <= size && len <= size - off;
+}
+
+/* A font payload is used in place, so every table it points to must lie within
+ * it and every glyph id and bitmap index must stay inside its table. */
+static bool font_in_bounds(const uint8_t *p, uint32_t size) {
+  if(size < sizeof(PackedFont)) return false;
+  const PackedFont *pf = (const PackedFont *)p;
+  if(pf->glyph_count == 0 || pf->bpp == 0 || pf->bpp > 8) return false;
+  if(!in_range(pf->glyph_dsc_off, pf->glyph_count * sizeof(lv_font_fmt_txt_glyph_dsc_t), size) ||
+     !in_range(pf->cmaps_off, pf->cmap_num * sizeof(PackedCmap), size) ||
+     !in_range(pf->bitmap_off, 0, size)) {
+    return false;
+  }
+
+  // Bitmaps run to the end of the payload; compressed ones have no fixed size
+  uint32_t bitmap_size = size - pf->bitmap_off;
+  const lv_font_fmt_txt_glyph_dsc_t *glyphs = (const lv_font_fmt_txt_glyph_dsc_t *)(p + pf->glyph_dsc_off);
+  for(uint16_t g = 0; g < pf->glyph_count; g++) {
+    uint32_t len = pf->bitmap_format ? 0 : ((uint32_t)glyphs[g].box_w * glyphs[g].box_h * pf->bpp + 7) / 8;
+    if(!in_range(glyphs[g].bitmap_index, len, bitmap_size)) return false;
+  }
+
+  const PackedCmap *pc = (const PackedCmap *)(p + pf->cmaps_off);
+  for(uint16_t c = 0; c < pf->cmap_num; c++) {
+    uint32_t ids = 0, ofs_len = 0;   // Glyph ids the cmap spans, bytes of its offset list
+    switch(pc[c].type) {
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY: ids = pc[c].range_length; break;
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:  ids = pc[c].list_length; break;
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL: ofs_len = pc[c].range_length; break;
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:  ofs_len = pc[c].list_length * 2; break;
+      default: return false;
+    }
+    if(pc[c].glyph_id_start + ids > pf->glyph_count) return false;
+    if(pc[c].unicode_list_off && !in_range(pc[c].unicode_list_off, pc[c].list_length * 2, size)) return false;
+    if(ofs_len) {
+      if(!pc[c].glyph_id_ofs_off || !in_range(pc[c].glyph_id_ofs_off, ofs_len, size)) return false;
+      const uint8_t *ofs = p + pc[c].glyph_id_ofs_off;
+      for(uint32_t k = 0; k < ofs_len; k += (pc[c].type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL ? 2 : 1)) {
+        uint32_t id = pc[c].glyph_id_start +
+                      (pc[c].type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL ? (ofs[k] | ofs[k + 1] << 8) : ofs[k]);
+        if(id >= pf->glyph_count) return false;
+      }
+    }
+  }
+
+  if(pf->has_kern_classes) {
+    if(!in_range(pf->kern_off, sizeof(PackedKernClasses), size)) return false;
+    const PackedKernClasses *pk = (const PackedKernClasses *)(p + pf->kern_off);
+    if(!in_range(pk->left_map_off, pf->glyph_count, size) ||
+       !in_range(pk->right_map_off, pf->glyph_count, size) ||
+       !in_range(pk->values_off, pk->left_class_cnt * pk->right_class_cnt, size)) {
+      return false;
+    }
+    // Class 0 means no kerning; 1..cnt index the value table
+    const uint8_t *left = p + pk->left_map_off, *right = p + pk->right_map_off;
+    for(uint16_t g = 0; g < pf->glyph_count; g++) {
+      if(left[g] > pk->left_class_cnt || right[g] > pk->right_class_cnt) return false;
+    }
+  }
+  return true;
+}
+
+static const uint8_t *base = NULL;
+static const AssetHeader *header = NULL;
+static const AssetEntry *entries = NULL;
+static asset_mmap_handle_t mmap_handle;
+static void *descriptors[ASSET_MAX_ENTRIES];
+
+bool asset_store_begin() {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSET_PARTITION_SUBTYPE, ASSET_PARTITION_LABEL);
+  if(!part) {
+    Serial.println("Assets: no partition");
+    return false;
+  }
+
+  const void *ptr;
+  if(esp_partition_mmap(part, 0, part->size, ASSET_MMAP_DATA, &ptr, &mmap_handle) != ESP_OK) {
+    Serial.println("ERROR: Asset partition mmap failed!");
+    return false;
+  }
+
+  const AssetHeader *h = (const AssetHeader *)ptr;
+  const AssetEntry *e = (const AssetEntry *)(h + 1);
+  uint32_t index_end = sizeof(AssetHeader) + h->count * sizeof(AssetEntry);
+  if(h->magic != ASSET_MAGIC || h->version != ASSET_VERSION || h->count > ASSET_MAX_ENTRIES ||
+     h->total_size > part->size || h->total_size < index_end ||
+     esp_rom_crc32_le(0, (const uint8_t *)e, h->count * sizeof(AssetEntry)) != h->index_crc) {
+    Serial.println("Assets: partition empty or invalid");
+    asset_munmap(mmap_handle);
+    return false;
+  }
+  // The CRC only says the index is what the packer wrote; every payload must
+  // also lie within the packed data
+  for(uint16_t i = 0; i < h->count; i++) {
+    if(e[i].offset < index_end || !in_range(e[i].offset, e[i].size, h->total_size)) {
+      Serial.printf("ERROR: Asset %.*s lies outside the packed data, partition ignored\n",
+                    ASSET_NAME_LEN, e[i].name);
+      asset_munmap(mmap_handle);
+      return false;
+    }
+  }
+
+  base = (const uint8_t *)ptr;
+  header = h;
+  entries = e;
+  Serial.printf("Assets: %u entries, %lu bytes mapped from flash\n", h->count, h->total_size);
+  return true;
+}
+
+static int find_entry(const char *name, uint8_t type) {
+  if(!header) return -1;
+  for(uint16_t i = 0; i < header->count; i++) {
+    if(entries[i].type == type && strncmp(entries[i].name, name, ASSET_NAME_LEN) == 0) return i;
+  }
+  return -1;
+}
+
+const lv_image_dsc_t *asset_image(const char *name) {
+  int i = find_entry(name, ASSET_IMAGE);
+  if(i < 0) return NULL;
+  if(descriptors[i]) return (const lv_image_dsc_t *)descriptors[i];
+
+  const uint8_t *p = base + entries[i].offset;
+  if(entries[i].size < sizeof(lv_image_header_t)) return NULL;
+
+  lv_image_dsc_t *img = (lv_image_dsc_t *)calloc(1, sizeof(lv_image_dsc_t));
+  if(!img) return NULL;
+  memcpy(&img->header, p, sizeof(lv_image_header_t));
+  if(img->header.magic != LV_IMAGE_HEADER_MAGIC) {
+    Serial.printf("ERROR: Asset %s is not an LVGL v9 image\n", name);
+    free(img);
+    return NULL;
+  }
+  img->data_size = entries[i].size - sizeof(lv_image_header_t);
+  img->data = p + sizeof(lv_image_header_t);
+
+  descriptors[i] = img;
+  return img;
+}
+
+const lv_font_t *asset_font(const char *name) {
+  int i = find_entry(name, ASSET_FONT);
+  if(i < 0) return NULL;
+  if(descriptors[i]) return (const lv_font_t *)descriptors[i];
+
+  const uint8_t *p = base + entries[i].offset;
+  if(!font_in_bounds(p, entries[i].size)) {
+    Serial.printf("ERROR: Asset %s is not a valid packed font\n", name);
+    return NULL;
+  }
+  const PackedFont *pf = (const PackedFont *)p;
+
+  lv_font_t *font = (lv_font_t *)calloc(1, sizeof(lv_font_t));
+  lv_font_fmt_txt_dsc_t *dsc = (lv_font_fmt_txt_dsc_t *)calloc(1, sizeof(lv_font_fmt_txt_dsc_t));
+  lv_font_fmt_txt_cmap_t *cmaps = (lv_font_fmt_txt_cmap_t *)calloc(pf->cmap_num, sizeof(lv_font_fmt_txt_cmap_t));
+  lv_font_fmt_txt_kern_classes_t *kern = pf->has_kern_classes ?
+      (lv_font_fmt_txt_kern_classes_t *)calloc(1, sizeof(lv_font_fmt_txt_kern_classes_t)) : NULL;
+  if(!font || !dsc || !cmaps || (pf->has_kern_classes && !kern)) {
+    free(font);
+    free(dsc);
+    free(cmaps);
+    free(kern);
+    return NULL;
+  }
+
+  const PackedCmap *pc = (const PackedCmap *)(p + pf->cmaps_off);
+  for(uint16_t c = 0; c < pf->cmap_num; c++) {
+    cmaps[c].range_start = pc[c].range_start;
+    cmaps[c].range_length = pc[c].range_length;
+    cmaps[c].glyph_id_start = pc[c].glyph_id_start;
+    cmaps[c].list_length = pc[c].list_length;
+    cmaps[c].type = (lv_font_fmt_txt_cmap_type_t)pc[c].type;
+    cmaps[c].unicode_list = pc[c].unicode_list_off ? (const uint16_t *)(p + pc[c].unicode_list_off) : NULL;
+    cmaps[c].glyph_id_ofs_list = pc[c].glyph_id_ofs_off ? p + pc[c].glyph_id_ofs_off : NULL;
+  }
+
+  if(kern) {
+    const PackedKernClasses *pk = (const PackedKernClasses *)(p + pf->kern_off);
+    kern->left_class_cnt = pk->left_class_cnt;
+    kern->right_class_cnt = pk->right_class_cnt;
+    kern->left_class_mapping = p + pk->left_map_off;
+    kern->right_class_mapping = p + pk->right_map_off;
+    kern->class_pair_values = (const int8_t *)(p + pk->values_off);
+  }
+
+  dsc->glyph_bitmap = p + pf->bitmap_off;
+  dsc->glyph_dsc = (const lv_font_fmt_txt_glyph_dsc_t *)(p + pf->glyph_dsc_off);
+  dsc->cmaps = cmaps;
+  dsc->kern_dsc = kern;
+  dsc->kern_scale = pf->kern_scale;
+  dsc->cmap_num = pf->cmap_num;
+  dsc->bpp = pf->bpp;
+  dsc->kern_classes = kern ? 1 : 0;
+  dsc->bitmap_format = pf->bitmap_format;
+
+  font->get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+  font->get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+  font->line_height = pf->line_height;
+  font->base_line = pf->base_line;
+  font->subpx = pf->subpx;
+  font->underline_position = pf->underline_position;
+  font->underline_thickness = pf->underline_thickness;
+  font->dsc = dsc;
+
+  descriptors[i] = font;
+  return font;
+}
+
+uint32_t asset_store_size() {
+  return header ? header->total_size : 0;
+}
@@ -0,0 +1,1347 @@
+#ifdef DASH_BENCH
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <stdlib.h>
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#include <esp_ota_ops.h>
+
+#include "bench.h"
+#include "telemetry_protocol.h"
+#include "telemetry_nodes.h"
+#include "layer_cache.h"
+#include "ui_fonts.h"
+#include "ui_cmd.h"
+#include "derived_metrics.h"
+#include "cell_store.h"
+#include "cell_view.h"
+#include "alert_engine.h"
+#include "power_manager.h"
+#include "spi_bus.h"
+#include "virtual_transport.h"
+#include "rs485_transport.h"
+#include "ui_layout.h"
+#include "ui_bind.h"
+#include "ui_alloc.h"
+#include "ui_screens.h"
+#include "sim_drive.h"
+
+#define BENCH_BAUD          115200
+#define BENCH_UPDATE_HZ     20     // Telemetry updates per second being simulated
+#define BENCH_UPDATES       SIM_DRIVE_UPDATES
+#define BENCH_BATCH         32     // Frames encoded per timed decode batch
+#define BENCH_KEYFRAME_EVERY 20    // One full keyframe per second at 20 Hz
+
+/* Encode the synthetic drive with the given keyframe interval (1 = every frame
+ * is a full frame, as today) and time validate+decode on the receive side. */
+static void bench_protocol_run(const char *name, uint16_t keyframe_interval) {
+  static uint8_t frames[BENCH_BATCH][128];
+  uint16_t lens[BENCH_BATCH];
+  uint32_t values[FIELD_COUNT];
+
+  TelemetryEncoder enc;
+  telemetry_encoder_init(&enc, keyframe_interval);
+
+  uint32_t total_bytes = 0;
+  uint32_t decode_us = 0;
+  uint32_t max_frame = 0;
+  uint32_t field_writes = 0;
+
+  for (uint32_t n = 0; n < BENCH_UPDATES; n += BENCH_BATCH) {
+    uint16_t count = 0;
+    for (; count < BENCH_BATCH && n + count < BENCH_UPDATES; count++) {
+      sim_drive_values(n + count, values);
+      lens[count] = telemetry_encoder_next(&enc, values, frames[count], sizeof(frames[count]));
+      total_bytes += lens[count];
+      if (lens[count] > max_frame) max_frame = lens[count];
+    }
+
+    TelemetryFrame frame;
+    uint32_t t0 = micros();
+    for (uint16_t k = 0; k < count; k++) {
+      if (validateFrame(frames[k], lens[k])) {
+        uint16_t declaredLength = (frames[k][2] << 8) | frames[k][3];
+        telemetry_decode_fields(&frames[k][FRAME_INFO_OFFSET],
+                                declaredLength - FRAME_HEADER_SIZE - FRAME_TRAILER_SIZE - 1,
+                                &frame);
+        field_writes += __builtin_popcount(frame.present);
+      }
+    }
+    decode_us += micros() - t0;
+  }
+
+  float avg_frame = (float)total_bytes / BENCH_UPDATES;
+  float bytes_per_s = avg_frame * BENCH_UPDATE_HZ;
+  float bus_load = bytes_per_s * 10.0f * 100.0f / BENCH_BAUD;   // 8N1 = 10 bits per byte
+  float max_rate = (BENCH_BAUD / 10.0f) / avg_frame;
+
+  Serial.printf("  %-6s avg %5.1f B/frame (max %lu), %6.0f B/s @%d Hz, bus %4.1f%%, "
+                "decode %5.2f us/update, %4.1f fields/update, max rate %4.0f Hz\n",
+                name, avg_frame, max_frame, bytes_per_s, BENCH_UPDATE_HZ, bus_load,
+                (float)decode_us / BENCH_UPDATES, (float)field_writes / BENCH_UPDATES,
+                max_rate);
+}
+
+static void bench_protocol() {
+  Serial.println("[BENCH] Telemetry frames, full vs delta:");
+  bench_protocol_run("full", 1);
+  bench_protocol_run("delta", BENCH_KEYFRAME_EVERY);
+}
+
+#define SIM_NODES          3
+#define SIM_DURATION_MS    10000
+#define SIM_CHARGER_STOP   5000   // Charger goes quiet half way through
+
+struct SimNode {
+  uint8_t  address;
+  uint16_t fields;
+  uint16_t period_ms;
+  uint32_t next_ms;
+  uint32_t sent;
+  TelemetryEncoder enc;
+};
+
+/* Interleave BMS, motor controller and charger frames at a combined ~160 Hz
+ * and time validate/decode/route per frame on the target. The routing itself
+ * is checked by the host test (test/test_nodes). */
+static void bench_nodes() {
+  SimNode nodes[SIM_NODES] = {
+    { NODE_ADDR_BMS,     FIELD_BIT(FIELD_SOC) | FIELD_BIT(FIELD_VOLTAGE) |
+                         FIELD_BIT(FIELD_CURRENT) | FIELD_BIT(FIELD_BATTERY_TEMP), 20 },
+    { NODE_ADDR_MOTOR,   FIELD_BIT(FIELD_SPEED) | FIELD_BIT(FIELD_MODE) | FIELD_BIT(FIELD_ARMED) |
+                         FIELD_BIT(FIELD_RANGE) | FIELD_BIT(FIELD_TRIP) | FIELD_BIT(FIELD_ODOMETER), 10 },
+    { NODE_ADDR_CHARGER, FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT), 100 },
+  };
+  for (uint8_t k = 0; k < SIM_NODES; k++) {
+    telemetry_encoder_init(&nodes[k].enc, BENCH_KEYFRAME_EVERY);
+    nodes[k].enc.header.source = nodes[k].address;
+    nodes[k].enc.header.msg_type = MSG_TELEMETRY;
+    nodes[k].enc.fields = nodes[k].fields;
+    nodes[k].next_ms = k * 3;   // Offset the schedules so frames interleave
+  }
+
+  telemetry_reset_routes();
+
+  uint8_t frame[128];
+  uint32_t values[FIELD_COUNT];
+  uint32_t frames = 0, bytes = 0, route_us = 0;
+
+  for (uint32_t now = 0; now < SIM_DURATION_MS; now++) {
+    for (uint8_t k = 0; k < SIM_NODES; k++) {
+      SimNode *node = &nodes[k];
+      if (now < node->next_ms) continue;
+      if (node->address == NODE_ADDR_CHARGER && now >= SIM_CHARGER_STOP) continue;
+      node->next_ms += node->period_ms;
+
+      // Each node reports its own view: offset the charger so it differs from the BMS
+      sim_drive_values(now / 10 + k * 1000, values);
+      uint16_t len = telemetry_encoder_next(&node->enc, values, frame, sizeof(frame));
+      node->sent++;
+      bytes += len;
+
+      uint32_t t0 = micros();
+      if (validateFrame(frame, len)) {
+        FrameHeader hdr;
+        TelemetryFrame decoded;
+        uint16_t declaredLength = (frame[2] << 8) | frame[3];
+        telemetry_parse_header(frame, &hdr);
+        telemetry_decode_fields(&frame[FRAME_INFO_OFFSET],
+                                declaredLength - FRAME_HEADER_SIZE - FRAME_TRAILER_SIZE - 1,
+                                &decoded);
+        telemetry_route_frame(&hdr, &decoded, now);
+      }
+      route_us += micros() - t0;
+      frames++;
+    }
+    telemetry_check_staleness(now);
+  }
+
+  NodeRoute *bms = telemetry_find_route(NODE_ADDR_BMS);
+  NodeRoute *motor = telemetry_find_route(NODE_ADDR_MOTOR);
+  NodeRoute *charger = telemetry_find_route(NODE_ADDR_CHARGER);
+
+  float rate = frames * 1000.0f / SIM_DURATION_MS;
+  Serial.printf("[BENCH] Multi-node bus: %lu frames (%.0f/s combined), %.0f B/s = %.1f%% of %d baud\n",
+                frames, rate, bytes * 1000.0f / SIM_DURATION_MS,
+                bytes * 1000.0f / SIM_DURATION_MS * 10.0f * 100.0f / BENCH_BAUD, BENCH_BAUD);
+  Serial.printf("  route+decode %.2f us/frame, BMS %lu, Motor %lu, Charger %lu\n",
+                (float)route_us / frames, bms->state.frames, motor->state.frames, charger->state.frames);
+
+  telemetry_reset_routes();
+}
+
+#define LARGE_CELLS       192    // Per-cell voltages, 2 bytes each
+#define LARGE_DUMP_LEN    600    // Fault dump bytes
+
+/* Decode time of a ~1 KB frame carrying bulk blocks. Bounds and the
+ * FRAME_MAX_LEN limit are fuzzed by the host test (test/test_frame_fuzz). */
+static void bench_large_frame() {
+  static uint8_t frame[FRAME_MAX_LEN];
+  static uint8_t cells[LARGE_CELLS * 2];
+  static uint8_t dump[LARGE_DUMP_LEN];
+  static TelemetryFrame tx, rx;
+
+  for (uint16_t k = 0; k < sizeof(cells); k += 2) {
+    uint16_t mv = 3300 + (k * 37) % 900;
+    cells[k] = mv >> 8;
+    cells[k + 1] = mv & 0xFF;
+  }
+  for (uint16_t k = 0; k < sizeof(dump); k++) dump[k] = k * 7919 >> 3;
+
+  sim_drive_values(0, tx.raw);
+  tx.present = FIELD_MASK_ALL;
+  tx.has_seq = true;
+  tx.keyframe = true;
+  tx.seq = 1;
+  tx.has_time = false;
+  tx.block_count = 2;
+  tx.blocks[0] = { ID_BLOCK_FIRST, sizeof(cells), cells };
+  tx.blocks[1] = { ID_BLOCK_FIRST + 1, sizeof(dump), dump };
+
+  FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY_BULK };
+  uint16_t len = telemetry_encode_frame(frame, sizeof(frame), &tx, &hdr);
+
+  uint32_t t0 = micros();
+  bool ok = validateFrame(frame, len);
+  uint32_t validate_us = micros() - t0;
+  t0 = micros();
+  ok &= telemetry_decode_fields(&frame[FRAME_INFO_OFFSET], len - FRAME_OVERHEAD, &rx);
+  uint32_t decode_us = micros() - t0;
+  ok &= rx.present == FIELD_MASK_ALL && rx.block_count == 2;
+
+  Serial.printf("[BENCH] Large frame: %u B, validate %lu us, decode %lu us -> %s\n",
+                len, validate_us, decode_us, ok ? "PASS" : "FAIL");
+}
+
+#define XPORT_UPDATES     400
+#define XPORT_FRAME_LEN   32     // A BMS frame with four fields is 29 bytes
+
+// BMS pack message, laid out like the 0x310 entry of the CAN map in main.cpp
+static const CanSignal xport_signals[] = {
+  { 0x310, NODE_ADDR_BMS, FIELD_SOC,          0, 1, false },
+  { 0x310, NODE_ADDR_BMS, FIELD_VOLTAGE,      1, 2, false },
+  { 0x310, NODE_ADDR_BMS, FIELD_CURRENT,      3, 2, true  },
+  { 0x310, NODE_ADDR_BMS, FIELD_BATTERY_TEMP, 5, 2, false },
+  { 0x320, NODE_ADDR_MOTOR, FIELD_SPEED,      0, 2, false },
+  { 0x321, NODE_ADDR_MOTOR, FIELD_RANGE,      0, 2, false },
+};
+#define XPORT_SIGNALS  (sizeof(xport_signals) / sizeof(xport_signals[0]))
+
+static const uint8_t xport_fields[] = { FIELD_SOC, FIELD_VOLTAGE, FIELD_CURRENT, FIELD_BATTERY_TEMP };
+
+/* Drain a transport, keeping the BMS fields of every frame in arrival order */
+static uint32_t xport_drain(TelemetryTransport *t, uint32_t (*out)[4], uint32_t *us) {
+  uint32_t n = 0;
+  for (;;) {
+    uint32_t t0 = micros();
+    uint8_t count = t->receive(t, 0);
+    *us += micros() - t0;
+    VirtualTransport *v = (VirtualTransport *)t->ctx;
+    if (!count && v->bytes_pos == v->bytes_len && !v->can_count) break;
+    for (uint8_t k = 0; k < count && n < XPORT_UPDATES; k++, n++) {
+      for (uint8_t i = 0; i < 4; i++) out[n][i] = t->batch.frame[k].raw[xport_fields[i]];
+    }
+  }
+  return n;
+}
+
+/* Decode cost per frame of the same BMS values sent as RS485 frames and as
+ * CAN messages through the virtual transport. That both decode to identical
+ * fields, and the CAN filter and drop rules, are checked by the host test
+ * (test/test_transport). */
+static void bench_transport() {
+  static VirtualTransport vctx;
+  static uint8_t stream[XPORT_UPDATES * XPORT_FRAME_LEN];
+  static uint32_t sent[XPORT_UPDATES][4], via_rs485[XPORT_UPDATES][4], via_can[XPORT_UPDATES][4];
+  TelemetryTransport t;
+  virtual_transport_init(&t, &vctx, xport_signals, XPORT_SIGNALS);
+  t.begin(&t);
+
+  FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY };
+  TelemetryFrame tx;
+  memset(&tx, 0, sizeof(tx));
+  uint32_t values[FIELD_COUNT];
+  uint32_t stream_len = 0;
+  for (uint32_t n = 0; n < XPORT_UPDATES; n++) {
+    sim_drive_values(n * 10, values);
+    if (n & 1) values[FIELD_CURRENT] = 0x8000 | (values[FIELD_CURRENT] / 3);   // Regen
+    for (uint8_t i = 0; i < 4; i++) {
+      tx.raw[xport_fields[i]] = sent[n][i] = values[xport_fields[i]];
+      tx.present |= FIELD_BIT(xport_fields[i]);
+    }
+    stream_len += telemetry_encode_frame(&stream[stream_len], sizeof(stream) - stream_len, &tx, &hdr);
+  }
+
+  uint32_t rs485_us = 0, can_us = 0;
+  virtual_transport_feed_bytes(&t, stream, stream_len);
+  uint32_t rs485_frames = xport_drain(&t, via_rs485, &rs485_us);
+
+  uint32_t can_frames = 0;
+  for (uint32_t n = 0; n < XPORT_UPDATES;) {
+    // Fill the queue like a burst in the driver's ISR queue, then drain it
+    for (; n < XPORT_UPDATES; n++) {
+      int32_t cur = (sent[n][2] & 0x8000) ? -(int32_t)(sent[n][2] & 0x7FFF) : (int32_t)sent[n][2];
+      uint8_t d[8] = {
+        (uint8_t)sent[n][0], (uint8_t)(sent[n][1] >> 8), (uint8_t)sent[n][1],
+        (uint8_t)((uint16_t)cur >> 8), (uint8_t)cur, (uint8_t)(sent[n][3] >> 8), (uint8_t)sent[n][3], 0
+      };
+      if (!virtual_transport_push_can(&t, 0x310, d, 8)) break;
+    }
+    can_frames += xport_drain(&t, &via_can[can_frames], &can_us);
+  }
+
+  Serial.printf("[BENCH] Transports: RS485 %.2f us/frame (%lu frames), CAN %.2f us/frame (%lu frames)\n",
+                (float)rs485_us / XPORT_UPDATES, rs485_frames, (float)can_us / XPORT_UPDATES, can_frames);
+}
+
+#define DERIVED_SIM_MS   (2 * 3600 * 1000UL)   // Two hours of driving
+
+/* Update cost over the synthetic drive at a jittery ~20 Hz, every fourth
+ * minute regenerating. The trip energy and rolling figures are checked by the
+ * host test (test/test_derived), which integrates a reference over the same
+ * drive. */
+static void bench_derived() {
+  static DerivedMetrics m;
+  derived_init(&m);
+  uint32_t values[FIELD_COUNT];
+  DerivedInputs in = {};
+
+  uint32_t updates = 0, update_us = 0;
+  for (uint32_t now = 1000, n = 0; now < DERIVED_SIM_MS; now += 40 + (n * 7919) % 21, n++) {
+    sim_drive_values(n % BENCH_UPDATES, values);   // Stays within the synthetic ranges
+    in.voltage = telemetry_scale(FIELD_VOLTAGE, values[FIELD_VOLTAGE]);
+    in.current = telemetry_scale(FIELD_CURRENT, values[FIELD_CURRENT]) * ((now / 60000) % 4 == 3 ? -0.5f : 1.0f);
+    in.speed_kmh = telemetry_scale(FIELD_SPEED, values[FIELD_SPEED]);
+    in.soc = values[FIELD_SOC];
+
+    uint32_t t0 = micros();
+    derived_update(&m, now, &in);
+    update_us += micros() - t0;
+    updates++;
+  }
+
+  Serial.printf("[BENCH] Derived metrics: %lu updates, %.2f us/update\n",
+                updates, (float)update_us / updates);
+}
+
+#define ALERT_BENCH_RULES  48
+#define ALERT_SIM_MS       600000   // Ten minutes at 20 Hz
+
+static int32_t alert_values[DASH_FIELD_COUNT];
+
+static int32_t bench_alert_value(uint8_t field) {
+  return alert_values[field];
+}
+
+/* Update cost with dozens of rules while the battery heats past both
+ * temperature thresholds and cools down again, every field changed on every
+ * update. Debounce, hysteresis and priority are checked by the host test
+ * (test/test_alerts), which replays the same drive. */
+static void bench_alerts() {
+  static AlertRule rules[ALERT_BENCH_RULES];
+  rules[0] = { FIELD_BATTERY_TEMP, ALERT_ABOVE, 55, 3, 2000, ALERT_CRITICAL, "overheating" };
+  rules[1] = { FIELD_BATTERY_TEMP, ALERT_ABOVE, 45, 3, 5000, ALERT_WARNING, "hot" };
+  rules[2] = { FIELD_SOC, ALERT_BELOW, 10, 2, 0, ALERT_CRITICAL, "soc" };
+  for (uint8_t r = 3; r < ALERT_BENCH_RULES; r++) {
+    // Filler on every field, out of reach of the synthetic values
+    uint8_t f = r % DASH_FIELD_COUNT;
+    rules[r] = { f, ALERT_ABOVE, 1000000 + r, 10, (uint16_t)(r * 100), ALERT_INFO, "filler" };
+  }
+
+  static AlertEngine e;
+  alert_engine_init(&e, rules, ALERT_BENCH_RULES);
+  uint32_t values[FIELD_COUNT];
+
+  uint32_t updates = 0, update_us = 0, max_us = 0, changes = 0;
+  for (uint32_t now = 0, n = 0; now < ALERT_SIM_MS; now += 50, n++) {
+    sim_drive_values(n % BENCH_UPDATES, values);
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) alert_values[f] = values[f];
+
+    // 30 C -> 60 C over five minutes and back, with noise
+    uint32_t t = now < ALERT_SIM_MS / 2 ? now : ALERT_SIM_MS - now;
+    alert_values[FIELD_BATTERY_TEMP] = 30 + t * 30 / (ALERT_SIM_MS / 2) + (int32_t)((n * 7919) % 5) - 2;
+    uint32_t changed = (1u << FIELD_COUNT) - 1;   // Worst case: every field changed
+
+    uint32_t t0 = micros();
+    bool c = alert_engine_update(&e, changed, bench_alert_value, now);
+    c |= alert_engine_tick(&e, now);
+    uint32_t us = micros() - t0;
+    update_us += us;
+    if (us > max_us) max_us = us;
+    updates++;
+    if (c) changes++;
+  }
+
+  Serial.printf("[BENCH] Alerts: %d rules, %.2f us/update (max %lu) with every field changed, "
+                "%lu banner changes\n",
+                ALERT_BENCH_RULES, (float)update_us / updates, max_us, changes);
+}
+
+#define POWER_BENCH_WAKES  5
+
+/* Power state timeline with no activity, then touch wake-ups out of idle on a
+ * copy of the live manager: the clock and sleep locks really switch, so the
+ * wake time is the real one. Worst case from touch to full power is one idle
+ * touch poll plus that. */
+static void bench_power() {
+  PowerManager pm = power;
+  pm.state = POWER_ACTIVE;
+  pm.last_activity_ms = 0;
+  pm.state_since_ms = 0;
+  memset(&pm.stats, 0, sizeof(pm.stats));
+
+  uint32_t dim_at = 0, idle_at = 0;
+  for (uint32_t now = 0; now <= POWER_IDLE_AFTER_MS + 1000; now += 100) {
+    if (!power_update(&pm, now)) continue;
+    if (pm.state == POWER_DIM) dim_at = now;
+    if (pm.state == POWER_IDLE) idle_at = now;
+  }
+  bool ok = dim_at == POWER_DIM_AFTER_MS && idle_at == POWER_IDLE_AFTER_MS;
+
+  uint32_t now = idle_at;
+  for (uint8_t i = 0; i < POWER_BENCH_WAKES; i++) {
+    if (pm.state != POWER_IDLE) {
+      now += POWER_IDLE_AFTER_MS;
+      power_update(&pm, now);
+    }
+    power_touch(&pm, now, micros());
+    ok &= power_update(&pm, now) && pm.state == POWER_ACTIVE;
+    power_wake_done(&pm, micros());
+  }
+
+  // uiTask's wait follows LVGL's next timer within the loop bounds
+  ok &= power_loop_wait(&pm, 0, 0) == POWER_LOOP_MIN_MS;
+  ok &= power_loop_wait(&pm, 33, 0) == 33;
+  ok &= power_loop_wait(&pm, LV_NO_TIMER_READY, 0) == POWER_LOOP_MAX_MS;
+
+  uint32_t wakes = pm.stats.wakes[POWER_IDLE];
+  uint32_t worst_ms = POWER_IDLE_TOUCH_POLL_MS + (pm.stats.wake_max_us[POWER_IDLE] + 999) / 1000;
+  ok &= wakes == POWER_BENCH_WAKES && worst_ms < 50;
+
+  Serial.printf("[BENCH] Power: dim at %lu ms, idle at %lu ms, %s; wake from idle %.2f us avg, "
+                "%lu us max, worst case touch to full power %lu ms -> %s\n",
+                dim_at, idle_at, pm.dfs ? "frequency scaling" : "direct clock switch",
+                wakes ? (float)pm.stats.wake_us[POWER_IDLE] / wakes : 0,
+                pm.stats.wake_max_us[POWER_IDLE], worst_ms, ok ? "PASS" : "FAIL");
+}
+
+#define SPI_BENCH_FLUSHES   200
+#define SPI_BENCH_FLUSH_US  3000   // Roughly a 480x40 RGB565 band at 40 MHz
+#define SPI_BENCH_BLOCK_US   400   // One 512-byte SD block at 16 MHz, plus card overhead
+
+static volatile bool spi_bench_running = false;
+static volatile uint32_t spi_bench_blocks = 0;
+
+/* Stand-in SD writer: batches of four blocks, letting go between blocks when
+ * the display waits, like the real writer */
+static void bench_spi_writer(void *param) {
+  while (spi_bench_running) {
+    if (!spi_bus_acquire(SPI_CLIENT_SD, 1000)) continue;
+    uint8_t b = 0;
+    do {
+      delayMicroseconds(SPI_BENCH_BLOCK_US);
+      spi_bench_blocks++;
+    } while (++b < 4 && !spi_bus_contended(SPI_CLIENT_SD));
+    if (b < 4) spiBusStats.yields++;
+    spi_bus_release(SPI_CLIENT_SD);
+    vTaskDelay(1);
+  }
+  vTaskDelete(NULL);
+}
+
+/* Display flushes at ~60 FPS against a saturating SD writer on the other
+ * core: a flush should never wait much longer than one SD block. */
+static void bench_spi_bus() {
+  memset(&spiBusStats, 0, sizeof(spiBusStats));
+  spi_bench_blocks = 0;
+  spi_bench_running = true;
+  xTaskCreatePinnedToCore(bench_spi_writer, "Bench_SD", 2048, NULL, 1, NULL, 0);
+  delay(20);
+
+  uint32_t t0 = millis();
+  for (uint16_t i = 0; i < SPI_BENCH_FLUSHES; i++) {
+    if (!spi_bus_acquire(SPI_CLIENT_DISPLAY, SPI_BUS_FLUSH_TIMEOUT_MS)) continue;
+    delayMicroseconds(SPI_BENCH_FLUSH_US);
+    spi_bus_release(SPI_CLIENT_DISPLAY);
+    delay(16 - SPI_BENCH_FLUSH_US / 1000);
+  }
+  uint32_t elapsed = millis() - t0;
+  spi_bench_running = false;
+  delay(50);
+
+  SpiBusStats st = spiBusStats;
+  uint32_t flushes = st.acquires[SPI_CLIENT_DISPLAY];
+  float busy = (st.busy_us[SPI_CLIENT_DISPLAY] + st.busy_us[SPI_CLIENT_SD]) / 10.0f / elapsed;
+  float sd_kbs = spi_bench_blocks * 512 / 1.024f / elapsed;
+  bool ok = flushes == SPI_BENCH_FLUSHES && st.timeouts[SPI_CLIENT_DISPLAY] == 0;
+  ok &= st.wait_max_us[SPI_CLIENT_DISPLAY] < 2 * SPI_BENCH_BLOCK_US + 200;
+
+  Serial.printf("[BENCH] SPI bus: %lu flushes, wait %.0f us avg / %lu us max, SD %.0f KB/s "
+                "(%lu yields), bus %.0f%% busy -> %s\n",
+                flushes, flushes ? (float)st.wait_us[SPI_CLIENT_DISPLAY] / flushes : 0,
+                st.wait_max_us[SPI_CLIENT_DISPLAY], sd_kbs, st.yields, busy, ok ? "PASS" : "FAIL");
+  memset(&spiBusStats, 0, sizeof(spiBusStats));
+}
+
+#define CMD_PRODUCERS   4
+#define CMD_PER_PRODUCER 5000
+
+static UiCmdQueue bench_cmds;
+static volatile uint8_t bench_producers_done = 0;
+
+/* Producer: arg = producer << 24 | sequence, retried until accepted */
+static void bench_cmd_producer(void *param) {
+  uint32_t p = (uint32_t)(uintptr_t)param;
+  for (uint32_t i = 0; i < CMD_PER_PRODUCER;) {
+    UiCmd cmd = { UI_CMD_ALERT, (int32_t)(p << 24 | i), NULL };
+    if (ui_cmd_queue_push(&bench_cmds, &cmd)) i++;
+    else taskYIELD();
+  }
+  __atomic_add_fetch(&bench_producers_done, 1, __ATOMIC_RELEASE);
+  vTaskDelete(NULL);
+}
+
+/* Several producers on both cores hammer one queue while this task drains it.
+ * Every command must arrive exactly once and in order per producer. The host
+ * test (test/test_ui_cmd) runs the same with threads and checks coalescing;
+ * this is the same check on the target's two cores and its memory model. */
+static void bench_ui_cmd() {
+  ui_cmd_queue_init(&bench_cmds);
+  bench_producers_done = 0;
+
+  for (uint32_t p = 0; p < CMD_PRODUCERS; p++) {
+    xTaskCreatePinnedToCore(bench_cmd_producer, "BenchCmd", 2048, (void *)(uintptr_t)p,
+                            uxTaskPriorityGet(NULL), NULL, p & 1);
+  }
+
+  int32_t last[CMD_PRODUCERS];
+  for (uint8_t p = 0; p < CMD_PRODUCERS; p++) last[p] = -1;
+  uint32_t received = 0, bad = 0;
+  uint32_t t0 = micros();
+  while (received < CMD_PRODUCERS * CMD_PER_PRODUCER) {
+    UiCmd cmd;
+    if (!ui_cmd_queue_pop(&bench_cmds, &cmd)) {
+      taskYIELD();
+      continue;
+    }
+    uint32_t p = (uint32_t)cmd.arg >> 24;
+    int32_t seq = cmd.arg & 0xFFFFFF;
+    if (p >= CMD_PRODUCERS || seq != last[p] + 1) bad++;
+    else last[p] = seq;
+    received++;
+  }
+  uint32_t us = micros() - t0;
+  while (__atomic_load_n(&bench_producers_done, __ATOMIC_ACQUIRE) < CMD_PRODUCERS) vTaskDelay(1);
+
+  UiCmd extra;
+  bool ok = bad == 0 && !ui_cmd_queue_pop(&bench_cmds, &extra);
+
+  Serial.printf("[BENCH] UI command queue: %d producers x %d, %lu received in %lu us, "
+                "%lu full retries, %lu out of order -> %s\n",
+                CMD_PRODUCERS, CMD_PER_PRODUCER, received, us,
+                bench_cmds.dropped.load(), bad, ok ? "PASS" : "FAIL");
+}
+
+#define RENDER_REPS 20
+
+static uint32_t bench_flush_us = 0;
+static uint32_t bench_flush_start = 0;
+
+static void bench_flush_event_cb(lv_event_t *e) {
+  if (lv_event_get_code(e) == LV_EVENT_FLUSH_START) bench_flush_start = micros();
+  else bench_flush_us += micros() - bench_flush_start;
+}
+
+/* Average render time for a full redraw of obj, SPI flush time excluded */
+static uint32_t bench_render_us(lv_display_t *disp, lv_obj_t *obj) {
+  bench_flush_us = 0;
+  uint32_t t0 = micros();
+  for (uint8_t i = 0; i < RENDER_REPS; i++) {
+    lv_obj_invalidate(obj);
+    lv_refr_now(disp);
+  }
+  return (micros() - t0 - bench_flush_us) / RENDER_REPS;
+}
+
+/* Live vs baked redraw of the battery screen arc and a dashboard card */
+static void bench_layer_cache() {
+  lv_display_t *disp = lv_display_get_default();
+  lv_obj_t *prev = lv_screen_active();
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0x0f1419), 0);
+  lv_screen_load(scr);
+
+  lv_obj_t *arc = lv_arc_create(scr);
+  lv_obj_set_size(arc, 200, 200);
+  lv_obj_align(arc, LV_ALIGN_LEFT_MID, 10, 0);
+  lv_arc_set_range(arc, 0, 100);
+  lv_arc_set_value(arc, 64);
+  lv_obj_set_style_arc_width(arc, 20, LV_PART_INDICATOR);
+
+  lv_obj_t *card = lv_obj_create(scr);
+  lv_obj_set_size(card, 200, 90);
+  lv_obj_align(card, LV_ALIGN_RIGHT_MID, -10, 0);
+  lv_obj_set_style_radius(card, 10, 0);
+  lv_obj_t *caption = lv_label_create(card);
+  lv_label_set_text(caption, "Mode");
+  lv_obj_align(caption, LV_ALIGN_TOP_MID, 0, 3);
+  lv_obj_t *value = lv_label_create(card);
+  lv_label_set_text(value, "CITY");
+  lv_obj_set_style_text_font(value, ui_font(20), 0);
+  lv_obj_align(value, LV_ALIGN_CENTER, 0, 15);
+
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+  lv_refr_now(disp);
+
+  uint32_t arc_live = bench_render_us(disp, arc);
+  uint32_t card_live = bench_render_us(disp, card);
+
+  layer_cache_bake(arc, NULL, 0, LAYER_LIVE_INDICATOR | LAYER_LIVE_KNOB);
+  layer_cache_bake(card, &value, 1, 0);
+  lv_refr_now(disp);
+
+  uint32_t arc_baked = bench_render_us(disp, arc);
+  uint32_t card_baked = bench_render_us(disp, card);
+
+  Serial.println("[BENCH] Layer cache, render time per full redraw (flush excluded):");
+  Serial.printf("  arc  200x200 live %6lu us, baked %6lu us\n", arc_live, arc_baked);
+  Serial.printf("  card 200x90  live %6lu us, baked %6lu us\n", card_live, card_baked);
+  Serial.printf("  snapshots hold %lu bytes\n", layer_cache_bytes());
+
+  lv_display_remove_event_cb_with_user_data(disp, bench_flush_event_cb, NULL);
+  lv_screen_load(prev);
+  lv_obj_delete(scr);
+  lv_refr_now(disp);
+}
+
+#define CELL_BENCH_CELLS   200
+#define CELL_BENCH_UPDATES 50    // 10 s of full-pack updates at 5 Hz
+
+/* Pack of CELL_BENCH_CELLS with a slow drift per update and one weak cell */
+static void bench_cell_block(uint32_t n, bool temps, uint8_t *payload, TelemetryBlock *b) {
+  payload[0] = 0;
+  for (uint16_t i = 0; i < CELL_BENCH_CELLS; i++) {
+    if (temps) {
+      payload[1 + i] = 25 + (i * 7 + n) % 9;
+    } else {
+      uint16_t mv = 3700 + (i * 13 + n * 3) % 40 - (i == 57 ? 150 : 0);
+      payload[1 + 2 * i] = mv >> 8;
+      payload[2 + 2 * i] = mv & 0xFF;
+    }
+  }
+  b->id = temps ? ID_CELL_TEMPS : ID_CELL_VOLTAGES;
+  b->len = 1 + CELL_BENCH_CELLS * (temps ? 1 : 2);
+  b->data = payload;
+}
+
+/* Full-pack cell frames through decode, the store and the heatmap: time per
+ * update on the RS485 side and render time for a full-pack vs single-cell
+ * change, and check the incremental statistics against a rescan. */
+static void bench_cells() {
+  static uint8_t frame[FRAME_MAX_LEN];
+  static uint8_t mv_payload[1 + CELL_BENCH_CELLS * 2];
+  static uint8_t temp_payload[1 + CELL_BENCH_CELLS];
+  static CellStore store, view_store;
+  static TelemetryFrame tx, rx;
+  cell_store_init(&store);
+  cell_store_init(&view_store);
+
+  lv_display_t *disp = lv_display_get_default();
+  lv_obj_t *prev = lv_screen_active();
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0x0f1419), 0);
+  lv_screen_load(scr);
+  lv_obj_t *view = cell_view_create(scr, &view_store, 285, 170);
+  lv_obj_set_style_text_font(view, ui_font(14), 0);
+  lv_obj_set_style_text_color(view, lv_color_white(), 0);
+  lv_obj_center(view);
+
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+  lv_refr_now(disp);
+
+  FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY_BULK };
+  tx.present = 0;
+  tx.has_seq = false;
+  tx.has_time = false;
+  tx.block_count = 2;
+
+  uint32_t rx_us = 0, sync_us = 0, render_us = 0, frame_len = 0;
+  for (uint32_t n = 0; n < CELL_BENCH_UPDATES; n++) {
+    bench_cell_block(n, false, mv_payload, &tx.blocks[0]);
+    bench_cell_block(n, true, temp_payload, &tx.blocks[1]);
+    uint16_t len = telemetry_encode_frame(frame, sizeof(frame), &tx, &hdr);
+    frame_len = len;
+
+    uint32_t t0 = micros();
+    if (validateFrame(frame, len)) {
+      telemetry_decode_fields(&frame[FRAME_INFO_OFFSET], len - FRAME_OVERHEAD, &rx);
+      for (uint8_t b = 0; b < rx.block_count; b++) cell_store_apply_block(&store, &rx.blocks[b]);
+    }
+    uint32_t t1 = micros();
+    cell_store_sync(&view_store, &store);
+    cell_view_refresh(view);
+    uint32_t t2 = micros();
+    bench_flush_us = 0;
+    lv_refr_now(disp);
+    render_us += micros() - t2 - bench_flush_us;
+    rx_us += t1 - t0;
+    sync_us += t2 - t1;
+  }
+
+  // Incremental extremes against a plain scan
+  uint16_t min_mv = UINT16_MAX, max_mv = 0;
+  for (uint8_t i = 0; i < store.count; i++) {
+    if (store.mv[i] < min_mv) min_mv = store.mv[i];
+    if (store.mv[i] > max_mv) max_mv = store.mv[i];
+  }
+  bool ok = store.count == CELL_BENCH_CELLS && store.mv_cells == CELL_BENCH_CELLS &&
+            store.min_mv == min_mv && store.max_mv == max_mv && store.min_mv_cell == 57;
+
+  // One cell changes: only its rectangle should be repainted
+  TelemetryBlock one = { ID_CELL_VOLTAGES, 3, mv_payload };
+  mv_payload[0] = 120;
+  mv_payload[1] = 0x0E;
+  mv_payload[2] = 0x42;
+  cell_store_apply_block(&store, &one);
+  cell_store_sync(&view_store, &store);
+  uint32_t t0 = micros();
+  cell_view_refresh(view);
+  bench_flush_us = 0;
+  lv_refr_now(disp);
+  uint32_t one_us = micros() - t0 - bench_flush_us;
+
+  Serial.printf("[BENCH] Cell heatmap, %d cells, %lu B frames: decode+store %lu us, "
+                "sync+invalidate %lu us, render %lu us per full-pack update; "
+                "single cell %lu us -> %s\n",
+                CELL_BENCH_CELLS, frame_len, rx_us / CELL_BENCH_UPDATES,
+                sync_us / CELL_BENCH_UPDATES, render_us / CELL_BENCH_UPDATES, one_us,
+                ok ? "PASS" : "FAIL");
+
+  lv_display_remove_event_cb_with_user_data(disp, bench_flush_event_cb, NULL);
+  lv_screen_load(prev);
+  lv_obj_delete(scr);
+  lv_refr_now(disp);
+}
+
+// From main.cpp; the other screens are in ui_screens.cpp
+void show_diagnostics_screen();
+
+struct BenchScreen {
+  const char *name;
+  void (*show)();
+};
+
+/* Full-screen render time of every screen. Build the esp32dev_bench and
+ * esp32dev_bench_1unit environments to compare one and two draw units. */
+static void bench_draw_units() {
+  static const BenchScreen screens[] = {
+    { "dashboard",   create_ev_dashboard_ui },
+    { "battery",     show_battery_screen },
+    { "voltage",     show_voltage_screen },
+    { "temperature", show_temperature_screen },
+    { "statistics",  show_statistics_screen },
+    { "settings",    show_settings_screen },
+    { "diagnostics", show_diagnostics_screen },
+  };
+  lv_display_t *disp = lv_display_get_default();
+
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+
+  Serial.printf("[BENCH] Full-screen render with %d draw unit(s), flush excluded:\n",
+                LV_DRAW_SW_DRAW_UNIT_CNT);
+  for (uint8_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++) {
+    screens[i].show();
+    uint32_t us = bench_render_us(disp, lv_screen_active());
+    Serial.printf("  %-12s %6lu us\n", screens[i].name, us);
+  }
+
+  lv_display_remove_event_cb_with_user_data(disp, bench_flush_event_cb, NULL);
+  create_ev_dashboard_ui();
+  lv_refr_now(disp);
+}
+
+#define LAYOUT_BUF_BYTES  (480 * 40 * 2)   // Same band budget as the panel's draw buffer
+#define LAYOUT_SCREENS    7
+
+extern lv_display_t *disp;
+
+static void bench_layout_flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px_map) {
+  lv_display_flush_ready(d);
+}
+
+/* Visible children that stick out of their parent: a layout that does not
+ * fit the panel. Baked images are placed by hand and skipped. */
+static uint16_t bench_layout_overflow(lv_obj_t *parent) {
+  uint16_t bad = 0;
+  lv_area_t pa;
+  lv_obj_get_coords(parent, &pa);
+  for (uint32_t i = 0; i < lv_obj_get_child_count(parent); i++) {
+    lv_obj_t *child = lv_obj_get_child(parent, i);
+    if (lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+    if (lv_obj_has_flag(child, LV_OBJ_FLAG_IGNORE_LAYOUT)) continue;
+    lv_area_t ca;
+    lv_obj_get_coords(child, &ca);
+    if (!lv_area_is_in(&ca, &pa, 0)) bad++;
+    bad += bench_layout_overflow(child);
+  }
+  return bad;
+}
+
+/* Off-screen display for the screen benchmarks. The screens redraw through
+ * the global disp, so it points at the bench display until
+ * bench_panel_restore(). */
+static lv_display_t *bench_display_open(int32_t w, int32_t h, uint8_t *buf, lv_display_flush_cb_t flush_cb) {
+  lv_display_t *d = lv_display_create(w, h);
+  lv_display_set_flush_cb(d, flush_cb);
+  lv_display_set_buffers(d, buf, NULL, LAYOUT_BUF_BYTES, LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_default(d);
+  disp = d;
+  ui_layout_init(d);
+  return d;
+}
+
+// Back to the panel, with a fresh dashboard on it
+static void bench_panel_restore(lv_display_t *panel) {
+  disp = panel;
+  lv_display_set_default(panel);
+  ui_layout_init(panel);
+  create_ev_dashboard_ui();
+  lv_refr_now(panel);
+}
+
+/* Every screen on an off-screen 480x320 and 800x480 display: render time with
+ * a no-op flush, and whether the layout fits */
+static void bench_layout() {
+  static const BenchScreen screens[] = {
+    { "dashboard",   create_ev_dashboard_ui },
+    { "battery",     show_battery_screen },
+    { "voltage",     show_voltage_screen },
+    { "temperature", show_temperature_screen },
+    { "statistics",  show_statistics_screen },
+    { "settings",    show_settings_screen },
+    { "diagnostics", show_diagnostics_screen },
+  };
+  static const int32_t res[][2] = { { 480, 320 }, { 800, 480 } };
+  uint32_t us[2][LAYOUT_SCREENS] = {};
+  lv_display_t *panel = disp;
+
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(LAYOUT_BUF_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (!buf) {
+    Serial.println("ERROR: [BENCH] Layout: no memory for a draw buffer, skipped");
+    return;
+  }
+
+  bool ok = true;
+  Serial.println("[BENCH] Layout, full-screen render per resolution (no flush):");
+  for (uint8_t r = 0; r < 2; r++) {
+    lv_display_t *d = bench_display_open(res[r][0], res[r][1], buf, bench_layout_flush_cb);
+
+    for (uint8_t i = 0; i < LAYOUT_SCREENS; i++) {
+      screens[i].show();
+      lv_obj_t *scr = lv_screen_active();
+      lv_obj_update_layout(scr);
+      uint16_t bad = bench_layout_overflow(scr);
+      us[r][i] = bench_render_us(d, scr);
+      if (bad) ok = false;
+      Serial.printf("  %4ldx%-4ld %-12s %6lu us, %3lu ns/px%s\n", res[r][0], res[r][1],
+                    screens[i].name, us[r][i],
+                    (unsigned long)((uint64_t)us[r][i] * 1000 / (res[r][0] * res[r][1])),
+                    bad ? ", OVERFLOW" : "");
+      if (bad) Serial.printf("    %u object(s) outside their parent\n", bad);
+    }
+
+    uint32_t baked = layer_cache_bytes();
+    create_ev_dashboard_ui();      // Leaves the diagnostics screen: perf hooks come off d
+    Serial.printf("  %4ldx%-4ld dashboard snapshots %lu bytes\n", res[r][0], res[r][1],
+                  layer_cache_bytes() - baked);
+    lv_display_delete(d);
+  }
+  heap_caps_free(buf);
+
+  uint64_t total[2] = {};
+  for (uint8_t i = 0; i < LAYOUT_SCREENS; i++) {
+    total[0] += us[0][i];
+    total[1] += us[1][i];
+  }
+  Serial.printf("  800x480 / 480x320: %.2fx the time for %.2fx the pixels -> %s\n",
+                total[0] ? (float)total[1] / total[0] : 0.0f, 800.0f * 480 / (480 * 320),
+                ok ? "PASS" : "FAIL");
+  bench_panel_restore(panel);
+}
+
+// The clock label, from main.cpp
+extern lv_obj_t *time_label;
+
+#define GOLDEN_DRAW_UNITS 2      // Render times below are from esp32dev_bench
+#define GOLDEN_TIME_PCT   15     // Allowed render time growth
+#define GOLDEN_AREA_PCT   10     // Allowed growth of the area one value change redraws
+#define GOLDEN_NO_FIELD   0xFF
+
+struct GoldenScenario {
+  const char *name;
+  void (*show)();
+  uint8_t update_field;          // Changed once to measure a partial redraw
+};
+
+struct GoldenRecord {
+  uint32_t render_us;            // 0 = not recorded yet
+  uint32_t update_px;
+  uint32_t draw_tasks;
+};
+
+// Run every animation to its end on simulated ticks; nothing drives lv_tick here
+static void bench_finish_anims() {
+  for (uint16_t i = 0; i < 500 && lv_anim_count_running(); i++) {
+    lv_tick_inc(LV_DEF_REFR_PERIOD);
+    lv_anim_refr_now();
+  }
+}
+
+static void golden_sidebar_open() {
+  create_ev_dashboard_ui();
+  show_sidebar();
+  sidebar_open = true;
+  bench_finish_anims();
+}
+
+static void golden_sidebar_closed() {
+  golden_sidebar_open();
+  close_sidebar();
+  sidebar_open = false;
+  bench_finish_anims();
+}
+
+static const GoldenScenario golden_scenarios[] = {
+  { "dashboard",      create_ev_dashboard_ui,  FIELD_SPEED },
+  { "battery",        show_battery_screen,     FIELD_SOC },
+  { "voltage",        show_voltage_screen,     FIELD_VOLTAGE },
+  { "temperature",    show_temperature_screen, FIELD_BATTERY_TEMP },
+  { "statistics",     show_statistics_screen,  FIELD_TRIP },
+  { "settings",       show_settings_screen,    GOLDEN_NO_FIELD },
+  { "sidebar open",   golden_sidebar_open,     FIELD_SPEED },
+  { "sidebar closed", golden_sidebar_closed,   FIELD_SPEED },
+};
+#define GOLDEN_SCENARIOS (sizeof(golden_scenarios) / sizeof(golden_scenarios[0]))
+
+/* Rows printed by bench_golden(), recorded on the device (esp32dev_bench);
+ * one per scenario. Paste the printed rows here after the first run and after
+ * every intended UI change. A row left at zero is reported as not recorded. */
+static const GoldenRecord golden[GOLDEN_SCENARIOS] = {
+  { 0, 0, 0 },   // dashboard
+  { 0, 0, 0 },   // battery
+  { 0, 0, 0 },   // voltage
+  { 0, 0, 0 },   // temperature
+  { 0, 0, 0 },   // statistics
+  { 0, 0, 0 },   // settings
+  { 0, 0, 0 },   // sidebar open
+  { 0, 0, 0 },   // sidebar closed
+};
+
+// Telemetry every scenario is rendered with, in ui_bind display units
+static const int32_t golden_values[FIELD_COUNT] = {
+  64, 5120, 1234, 31, 42, MODE_CITY, 1, 87, 96, 48, 12, 3456, 38
+};
+
+static uint32_t golden_px = 0;
+static uint32_t golden_tasks = 0;
+
+static void golden_flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px_map) {
+  golden_px += lv_area_get_size(area);
+  lv_display_flush_ready(d);
+}
+
+static void golden_task_cb(lv_event_t *e) {
+  golden_tasks++;
+}
+
+static void golden_count_tasks(lv_obj_t *obj, bool on) {
+  if (on) {
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+    lv_obj_add_event_cb(obj, golden_task_cb, LV_EVENT_DRAW_TASK_ADDED, NULL);
+  } else {
+    lv_obj_remove_flag(obj, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+    lv_obj_remove_event_cb(obj, golden_task_cb);
+  }
+  for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+    golden_count_tasks(lv_obj_get_child(obj, i), on);
+  }
+}
+
+/* Frame-cost regression for the screens and the sidebar. Each scenario is
+ * rendered on an off-screen 480x320 display with fixed telemetry and a fixed
+ * clock, then checked against its golden row: the full redraw time, the
+ * pixels one value change redraws and the draw tasks of a full redraw. What
+ * the screens look like is checked on the host against PNG goldens
+ * (test/test_screens, pio test -e native_ui); these are the costs only the
+ * device can measure. A value change that redraws the whole screen fails
+ * even without a row. Rows not recorded yet make the result INCOMPLETE, and
+ * the run prints the rows to record. */
+static void bench_golden() {
+  lv_display_t *panel = disp;
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(LAYOUT_BUF_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (!buf) {
+    Serial.println("ERROR: [BENCH] Golden: no memory for a draw buffer, skipped");
+    return;
+  }
+
+  // Fixed inputs; the live ones come back afterwards
+  static int32_t saved_values[DASH_FIELD_COUNT];
+  static CellStore saved_cells;
+  static uint8_t mv_payload[1 + CELL_BENCH_CELLS * 2];
+  static uint8_t temp_payload[1 + CELL_BENCH_CELLS];
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    saved_values[f] = ui_bind_value(f);
+    ui_bind_publish(f, f < FIELD_COUNT ? golden_values[f] : 10 + f * 3);
+  }
+  ui_bind_publish_stale(0);
+  saved_cells = ui_cells;
+  cell_store_init(&ui_cells);
+  TelemetryBlock block;
+  bench_cell_block(0, false, mv_payload, &block);
+  cell_store_apply_block(&ui_cells, &block);
+  bench_cell_block(0, true, temp_payload, &block);
+  cell_store_apply_block(&ui_cells, &block);
+
+  lv_display_t *d = bench_display_open(UI_DESIGN_HOR_RES, UI_DESIGN_VER_RES, buf, golden_flush_cb);
+  lv_display_add_event_cb(d, bench_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(d, bench_flush_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+  uint32_t screen_px = UI_DESIGN_HOR_RES * UI_DESIGN_VER_RES;
+
+  static GoldenRecord now[GOLDEN_SCENARIOS];
+  bool ok = true;
+  uint8_t missing = 0;
+  Serial.println("[BENCH] Golden screen costs, 480x320:");
+  for (uint8_t i = 0; i < GOLDEN_SCENARIOS; i++) {
+    const GoldenScenario *sc = &golden_scenarios[i];
+    const GoldenRecord *g = &golden[i];
+    GoldenRecord *r = &now[i];
+
+    sc->show();
+    if (time_label) lv_label_set_text(time_label, "12:00");
+    lv_obj_t *scr = lv_screen_active();
+    lv_refr_now(d);
+    r->render_us = bench_render_us(d, scr);
+
+    golden_tasks = 0;
+    golden_count_tasks(scr, true);
+    lv_obj_invalidate(scr);
+    lv_refr_now(d);
+    golden_count_tasks(scr, false);
+    r->draw_tasks = golden_tasks;
+
+    golden_px = 0;
+    if (sc->update_field != GOLDEN_NO_FIELD) {
+      ui_bind_publish(sc->update_field, ui_bind_value(sc->update_field) + 1);
+      lv_refr_now(d);
+      ui_bind_publish(sc->update_field, golden_values[sc->update_field]);
+    }
+    r->update_px = golden_px;
+
+    // Compare
+    char why[48] = "";
+    bool recorded = g->render_us != 0;
+    if (recorded && GOLDEN_DRAW_UNITS == LV_DRAW_SW_DRAW_UNIT_CNT &&
+        r->render_us > g->render_us * (100 + GOLDEN_TIME_PCT) / 100) {
+      strncat(why, " time", sizeof(why) - strlen(why) - 1);
+    }
+    if ((recorded && r->update_px > g->update_px * (100 + GOLDEN_AREA_PCT) / 100) ||
+        r->update_px >= screen_px) {
+      strncat(why, r->update_px >= screen_px ? " full-screen update" : " update area",
+              sizeof(why) - strlen(why) - 1);
+    }
+    if (recorded && r->draw_tasks > g->draw_tasks) {
+      strncat(why, " draw tasks", sizeof(why) - strlen(why) - 1);
+    }
+    if (why[0]) ok = false;
+    if (!recorded) missing++;
+
+    Serial.printf("  %-14s %6lu us (was %6lu), update %6lu px (was %6lu), %4lu draw tasks (was %4lu): %s%s\n",
+                  sc->name, r->render_us, g->render_us, r->update_px, g->update_px,
+                  r->draw_tasks, g->draw_tasks,
+                  why[0] ? "FAIL:" : recorded ? "PASS" : "NOT RECORDED", why);
+  }
+
+  if (!ok || missing) {
+    Serial.println("  Rows for golden[] if the changes are intended:");
+    for (uint8_t i = 0; i < GOLDEN_SCENARIOS; i++) {
+      const GoldenRecord *r = &now[i];
+      Serial.printf("  { %lu, %lu, %lu },   // %s\n", r->render_us, r->update_px,
+                    r->draw_tasks, golden_scenarios[i].name);
+    }
+  }
+  if (!ok) {
+    Serial.println("[BENCH] Golden screen costs -> FAIL");
+  } else if (missing) {
+    Serial.printf("[BENCH] Golden screen costs -> INCOMPLETE, %u of %u rows not recorded\n",
+                  missing, (unsigned)GOLDEN_SCENARIOS);
+  } else {
+    Serial.println("[BENCH] Golden screen costs -> PASS");
+  }
+
+  // Leave the dashboard so nothing on d outlives it
+  create_ev_dashboard_ui();
+  lv_display_delete(d);
+  heap_caps_free(buf);
+
+  ui_cells = saved_cells;
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) ui_bind_publish(f, saved_values[f]);
+  bench_panel_restore(panel);
+}
+
+// Partition mmap API names changed in IDF 5
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_partition_mmap_handle_t hot_mmap_handle_t;
+#define HOT_MMAP_DATA   ESP_PARTITION_MMAP_DATA
+#define hot_munmap      esp_partition_munmap
+#else
+typedef spi_flash_mmap_handle_t hot_mmap_handle_t;
+#define HOT_MMAP_DATA   SPI_FLASH_MMAP_DATA
+#define hot_munmap      spi_flash_munmap
+#endif
+
+#define HOT_REPS          1000
+#define HOT_RENDER_REPS   100
+#define HOT_EVICT_BYTES   (64 * 1024)   // Twice the cache, so no line survives
+#define HOT_CACHE_LINE    32
+
+static const uint8_t *hot_flash = NULL;
+static volatile bool hot_load_running = false;
+static volatile uint32_t hot_sink = 0;
+static uint32_t hot_samples[HOT_REPS];
+
+// One read per cache line across the mapped flash
+static void hot_evict() {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < HOT_EVICT_BYTES; i += HOT_CACHE_LINE) sum += hot_flash[i];
+  hot_sink += sum;
+}
+
+/* Flash load on the other core: its cache misses queue on the same SPI flash
+ * bus as ours, like SD-time image and font reads do */
+static void bench_flash_load(void *param) {
+  uint8_t n = 0;
+  while (hot_load_running) {
+    hot_evict();
+    if (++n % 32 == 0) vTaskDelay(1);   // Let the idle task feed the watchdog
+  }
+  vTaskDelete(NULL);
+}
+
+struct HotCase {
+  const char *name;
+  bool cold;                     // Cache evicted before each run
+  bool load;                     // Flash load on the other core
+};
+
+static const HotCase hot_cases[] = {
+  { "warm",       false, false },
+  { "cold",       true,  false },
+  { "cold+load",  true,  true },
+};
+
+static int hot_cmp(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void hot_print(const char *probe, const char *name, uint16_t n, float scale) {
+  qsort(hot_samples, n, sizeof(hot_samples[0]), hot_cmp);
+  Serial.printf("  %-7s %-10s %7.1f %7.1f %7.1f %7.1f\n", probe, name,
+                hot_samples[0] * scale, hot_samples[n / 2] * scale,
+                hot_samples[n * 99 / 100] * scale, hot_samples[n - 1] * scale);
+}
+
+/* Latency spread of the placed hot paths with a warm cache, an evicted one
+ * and an evicted one with flash traffic from the other core: decoding one
+ * RS485 frame (CRC, framing, TLVs) and rendering a card (LVGL fill and
+ * blend, flush excluded). Build esp32dev_bench_flash to get the same numbers
+ * with everything in flash. */
+static void bench_hot_path() {
+  const esp_partition_t *app = esp_ota_get_running_partition();
+  const void *ptr;
+  hot_mmap_handle_t handle;
+  if (!app || esp_partition_mmap(app, 0, HOT_EVICT_BYTES, HOT_MMAP_DATA, &ptr, &handle) != ESP_OK) {
+    Serial.println("ERROR: [BENCH] Hot path: cannot map the app partition, skipped");
+    return;
+  }
+  hot_flash = (const uint8_t *)ptr;
+
+  static uint8_t frame[FRAME_MAX_LEN];
+  static Rs485Framer framer;
+  static TelemetryBatch batch;
+  TelemetryFrame tx;
+  memset(&tx, 0, sizeof(tx));
+  uint32_t values[FIELD_COUNT];
+  sim_drive_values(1, values);
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) tx.raw[f] = values[f];
+  tx.present = FIELD_MASK_ALL;
+  FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY };
+  uint16_t len = telemetry_encode_frame(frame, sizeof(frame), &tx, &hdr);
+
+  lv_display_t *disp = lv_display_get_default();
+  lv_obj_t *prev = lv_screen_active();
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+  lv_screen_load(scr);
+  lv_obj_t *card = lv_obj_create(scr);
+  lv_obj_set_size(card, 200, 90);
+  lv_obj_center(card);
+  lv_obj_set_style_radius(card, 10, 0);
+  lv_obj_set_style_shadow_width(card, 12, 0);
+  lv_obj_t *value = lv_label_create(card);
+  lv_label_set_text(value, "CITY");
+  lv_obj_set_style_text_font(value, ui_font(20), 0);
+  lv_obj_center(value);
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(disp, bench_flush_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+  lv_refr_now(disp);
+
+  bool ok = len > 0;
+  float us_per_cycle = 1.0f / ESP.getCpuFreqMHz();
+#ifdef DASH_HOT_IN_FLASH
+  Serial.println("[BENCH] Hot paths in flash (DASH_HOT_IN_FLASH), us min / p50 / p99 / max:");
+#else
+  Serial.println("[BENCH] Hot paths in IRAM, us min / p50 / p99 / max:");
+#endif
+  for (uint8_t c = 0; c < sizeof(hot_cases) / sizeof(hot_cases[0]); c++) {
+    const HotCase *hc = &hot_cases[c];
+    if (hc->load) {
+      hot_load_running = true;
+      xTaskCreatePinnedToCore(bench_flash_load, "Bench_Flash", 2048, NULL, 1, NULL, 0);
+      delay(10);
+    }
+
+    for (uint16_t i = 0; i < HOT_REPS; i++) {
+      memcpy(framer.buf, frame, len);
+      framer.pos = len;
+      framer.consumed = 0;
+      batch.count = 0;
+      if (hc->cold) hot_evict();
+      uint32_t c0 = ESP.getCycleCount();
+      uint8_t n = rs485_framer_decode(&framer, &batch);
+      hot_samples[i] = ESP.getCycleCount() - c0;
+      ok &= n == 1 && batch.frame[0].present == FIELD_MASK_ALL;
+    }
+    hot_print("decode", hc->name, HOT_REPS, us_per_cycle);
+
+    for (uint16_t i = 0; i < HOT_RENDER_REPS; i++) {
+      lv_obj_invalidate(card);
+      if (hc->cold) hot_evict();
+      bench_flush_us = 0;
+      uint32_t t0 = micros();
+      lv_refr_now(disp);
+      hot_samples[i] = micros() - t0 - bench_flush_us;
+    }
+    hot_print("render", hc->name, HOT_RENDER_REPS, 1.0f);
+
+    if (hc->load) {
+      hot_load_running = false;
+      delay(50);
+    }
+  }
+  Serial.printf("[BENCH] Hot paths -> %s\n", ok ? "PASS" : "FAIL");
+
+  hot_munmap(handle);
+  lv_display_remove_event_cb_with_user_data(disp, bench_flush_event_cb, NULL);
+  lv_screen_load(prev);
+  lv_obj_delete(scr);
+  lv_refr_now(disp);
+}
+
+#define ALLOC_SOAK_CYCLES   50
+#define ALLOC_DRIFT_BYTES   1024   // Heap free / largest block allowed to go down over the soak
+#define ALLOC_SLOWDOWN_PCT  20     // Last cycle against the first
+
+/* Rebuild every screen ALLOC_SOAK_CYCLES times, the way a driver paging
+ * through them would, and check that nothing is left behind: every build
+ * releases its arena, the internal heap neither shrinks nor splits, the pool
+ * free lists are intact and rebuilds do not get slower. */
+static void bench_alloc() {
+  static const BenchScreen screens[] = {
+    { "dashboard",   create_ev_dashboard_ui },
+    { "battery",     show_battery_screen },
+    { "voltage",     show_voltage_screen },
+    { "temperature", show_temperature_screen },
+    { "statistics",  show_statistics_screen },
+    { "settings",    show_settings_screen },
+    { "diagnostics", show_diagnostics_screen },
+  };
+  const uint8_t n = sizeof(screens) / sizeof(screens[0]);
+
+  // One warm-up cycle: fonts, image cache and draw layers reach their steady size
+  for (uint8_t i = 0; i < n; i++) {
+    screens[i].show();
+  }
+  ui_alloc_check();
+  UiAllocStats before, after;
+  ui_alloc_stats(&before);
+
+  uint32_t first_us = 0, last_us = 0;
+  for (uint16_t c = 0; c < ALLOC_SOAK_CYCLES; c++) {
+    uint32_t t0 = micros();
+    for (uint8_t i = 0; i < n; i++) {
+      screens[i].show();
+    }
+    uint32_t us = micros() - t0;
+    if (c == 0) first_us = us;
+    last_us = us;
+  }
+  create_ev_dashboard_ui();
+  lv_refr_now(disp);
+  ui_alloc_check();
+  ui_alloc_stats(&after);
+
+  uint32_t builds = ALLOC_SOAK_CYCLES * n;
+  int32_t free_drop = (int32_t)(before.heap_free - after.heap_free);
+  int32_t largest_drop = (int32_t)(before.heap_largest - after.heap_largest);
+  bool pools_ok = lv_mem_test() == LV_RESULT_OK;
+
+  Serial.printf("[BENCH] Allocator soak, %lu screen builds:\n", (unsigned long)builds);
+  for (uint8_t c = 0; c < UI_POOL_CLASSES; c++) {
+    Serial.printf("  pool %3u B: %3u / %3u used, peak %u\n", after.class_size[c],
+                  after.class_used[c], after.class_blocks[c], after.class_peak[c]);
+  }
+  Serial.printf("  arena: peak %lu / %u B, %lu resets, %lu pinned, %lu overflows\n",
+                after.arena_peak, UI_ARENA_BYTES, after.arena_resets - before.arena_resets,
+                after.arena_pinned - before.arena_pinned, after.arena_overflows - before.arena_overflows);
+  Serial.printf("  pool fallbacks %lu, heap blocks %lu, failed %lu\n",
+                after.pool_fallbacks - before.pool_fallbacks, after.heap_live, after.failed);
+  Serial.printf("  heap free %lu -> %lu, largest %lu -> %lu (%u%% frag)\n",
+                before.heap_free, after.heap_free, before.heap_largest, after.heap_largest,
+                after.heap_frag_pct);
+  Serial.printf("  cycle %lu us first, %lu us last\n", first_us, last_us);
+
+  bool ok = pools_ok && after.failed == before.failed &&
+            after.arena_resets - before.arena_resets >= builds &&
+            after.arena_pinned == before.arena_pinned &&
+            free_drop <= ALLOC_DRIFT_BYTES && largest_drop <= ALLOC_DRIFT_BYTES &&
+            last_us <= first_us + first_us * ALLOC_SLOWDOWN_PCT / 100;
+  Serial.printf("[BENCH] Allocator -> %s%s\n", ok ? "PASS" : "FAIL", pools_ok ? "" : " (pool lists corrupt)");
+}
+
+void run_benchmarks() {
+  Serial.println("\n=== Benchmarks ===");
+  bench_protocol();
+  bench_nodes();
+  bench_large_frame();
+  bench_transport();
+  bench_derived();
+  bench_alerts();
+  bench_power();
+  bench_spi_bus();
+  bench_ui_cmd();
+  bench_layer_cache();
+  bench_cells();
+  bench_draw_units();
+  bench_layout();
+  bench_golden();
+  bench_hot_path();
+  bench_alloc();
+  Serial.println("=== Benchmarks Complete ===\n");
+}
+
+#endif // DASH_BENCH
@@ -0,0 +1,62 @@
+#include <string.h>
+
+#include "can_map.h"
+
+#define CAN_ID_MASK  0x7FF
+
+/* Two's complement of the given width to the wire's sign-magnitude
+ * (top bit of the field = negative) */
+static uint32_t to_sign_magnitude(uint32_t v, uint8_t size) {
+  uint32_t sign = 1u << (size * 8 - 1);
+  if (!(v & sign)) return v;
+  uint32_t mag = (size == 4 ? 0u : (sign << 1)) - v;   // |v| in the field width
+  return sign | (mag & (sign - 1));
+}
+
+bool can_map_decode(const CanSignal *signals, uint8_t count, uint32_t id,
+                    const uint8_t *data, uint8_t dlc, TelemetryBatch *batch) {
+  // A short message is dropped whole rather than half-applied
+  bool mapped = false;
+  for (uint8_t s = 0; s < count; s++) {
+    if (signals[s].can_id != id) continue;
+    if (signals[s].offset + signals[s].size > dlc) return false;
+    mapped = true;
+  }
+  if (!mapped) return false;
+
+  TelemetryFrame *frame = NULL;
+  for (uint8_t s = 0; s < count; s++) {
+    const CanSignal *sig = &signals[s];
+    if (sig->can_id != id) continue;
+
+    if (!frame) {
+      uint8_t k = telemetry_batch_add(batch);
+      if (k == TRANSPORT_BATCH_MAX) return false;
+      batch->hdr[k].source = sig->node;
+      batch->hdr[k].dest = 0;
+      batch->hdr[k].msg_type = MSG_TELEMETRY;
+      batch->raw[k] = NULL;
+      batch->raw_len[k] = 0;
+      frame = &batch->frame[k];
+      memset(frame, 0, sizeof(*frame));
+      frame->keyframe = true;      // No sequence numbers on CAN: each message stands alone
+    }
+
+    uint32_t v = 0;
+    for (uint8_t b = 0; b < sig->size; b++) v = (v << 8) | data[sig->offset + b];
+    if (sig->is_signed) v = to_sign_magnitude(v, sig->size);
+    frame->raw[sig->field] = v;
+    frame->present |= FIELD_BIT(sig->field);
+  }
+  return frame != NULL;
+}
+
+void can_map_filter(const CanSignal *signals, uint8_t count, uint32_t *code, uint32_t *mask) {
+  uint32_t first = count ? signals[0].can_id & CAN_ID_MASK : 0;
+  uint32_t differ = 0;
+  for (uint8_t s = 1; s < count; s++) differ |= (signals[s].can_id & CAN_ID_MASK) ^ first;
+
+  // Single filter mode, standard frames: ID in bits 31-21, RTR and data bytes below
+  *code = first << 21;
+  *mask = (differ << 21) | 0x1FFFFF;
+}
@@ -0,0 +1,72 @@
+#include <Arduino.h>
+#include <string.h>
+#include <driver/twai.h>
+
+#include "can_transport.h"
+#include "power_manager.h"
+
+/* Wait for the first message, then drain whatever else the driver's ISR has
+ * queued so the batch is ingested under one lock. */
+static uint8_t can_receive(TelemetryTransport *t, uint32_t wait_ms) {
+  CanTransport *c = (CanTransport *)t->ctx;
+  t->batch.count = 0;
+
+  twai_message_t msg;
+  TickType_t wait = pdMS_TO_TICKS(wait_ms);
+  while (t->batch.count < TRANSPORT_BATCH_MAX && twai_receive(&msg, wait) == ESP_OK) {
+    wait = 0;
+    t->last_rx_ms = millis();
+    if (msg.extd || msg.rtr) continue;
+    can_map_decode(c->signals, c->count, msg.identifier, msg.data, msg.data_length_code, &t->batch);
+  }
+  if (t->batch.count) return t->batch.count;
+
+  // Nothing arrived: make sure the controller is still on the bus
+  twai_status_info_t status;
+  if (twai_get_status_info(&status) != ESP_OK) return 0;
+  t->rx_dropped = status.rx_missed_count;
+  if (status.state == TWAI_STATE_BUS_OFF) {
+    c->bus_off++;
+    Serial.println("ERROR: [CAN] Bus off, recovering");
+    twai_initiate_recovery();
+  } else if (status.state == TWAI_STATE_STOPPED) {
+    twai_start();                  // Recovery finished
+  }
+  return 0;
+}
+
+static bool can_begin(TelemetryTransport *t) {
+  CanTransport *c = (CanTransport *)t->ctx;
+  twai_general_config_t g_config =
+      TWAI_GENERAL_CONFIG_DEFAULT((gpio_num_t)c->tx_pin, (gpio_num_t)c->rx_pin, TWAI_MODE_NORMAL);
+  g_config.rx_queue_len = CAN_RX_QUEUE_LEN;
+  twai_timing_config_t t_config = TWAI_TIMING_CONFIG_500KBITS();
+  twai_filter_config_t f_config;
+  f_config.single_filter = true;
+  can_map_filter(c->signals, c->count, &f_config.acceptance_code, &f_config.acceptance_mask);
+
+  esp_err_t err = twai_driver_install(&g_config, &t_config, &f_config);
+  if (err == ESP_OK) err = twai_start();
+  if (err != ESP_OK) {
+    Serial.printf("ERROR: [CAN] TWAI start failed (%d)\n", err);
+    return false;
+  }
+  Serial.printf("[CAN] 500 kbit/s, filter code 0x%08lX mask 0x%08lX\n",
+                (unsigned long)f_config.acceptance_code, (unsigned long)f_config.acceptance_mask);
+  power_bus_wake_pin(c->rx_pin);
+  return true;
+}
+
+void can_transport_init(TelemetryTransport *t, CanTransport *ctx, const CanSignal *signals,
+                        uint8_t count, int tx_pin, int rx_pin) {
+  memset(t, 0, sizeof(*t));
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->signals = signals;
+  ctx->count = count;
+  ctx->tx_pin = tx_pin;
+  ctx->rx_pin = rx_pin;
+  t->name = "CAN";
+  t->begin = can_begin;
+  t->receive = can_receive;
+  t->ctx = ctx;
+}
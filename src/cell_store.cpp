@@ -0,0 +1,138 @@
+#include <string.h>
+
+#include "cell_store.h"
+
+#define RESCAN_MV    0x01
+#define RESCAN_TEMP  0x02
+
+void cell_store_init(CellStore *s) {
+  memset(s, 0, sizeof(*s));
+  memset(s->temp_c, CELL_TEMP_NONE, sizeof(s->temp_c));
+}
+
+static void mark(CellStore *s, uint8_t cell) {
+  s->dirty[cell / 32] |= 1u << (cell % 32);
+  if (cell >= s->count) s->count = cell + 1;
+}
+
+static bool set_mv(CellStore *s, uint8_t cell, uint16_t mv) {
+  uint16_t old = s->mv[cell];
+  if (old == mv) return false;
+  s->mv[cell] = mv;
+  mark(s, cell);
+
+  if (old) {
+    s->sum_mv -= old;
+    s->mv_cells--;
+  }
+  if (!mv) {
+    // Cell dropped out: only matters if it held an extreme
+    if (cell == s->min_mv_cell || cell == s->max_mv_cell) s->rescan |= RESCAN_MV;
+    return true;
+  }
+  s->sum_mv += mv;
+  s->mv_cells++;
+
+  if (s->mv_cells == 1 || mv < s->min_mv) {
+    s->min_mv = mv;
+    s->min_mv_cell = cell;
+  } else if (cell == s->min_mv_cell && mv > old) {
+    s->rescan |= RESCAN_MV;
+  }
+  if (s->mv_cells == 1 || mv > s->max_mv) {
+    s->max_mv = mv;
+    s->max_mv_cell = cell;
+  } else if (cell == s->max_mv_cell && mv < old) {
+    s->rescan |= RESCAN_MV;
+  }
+  return true;
+}
+
+static bool set_temp(CellStore *s, uint8_t cell, int8_t c) {
+  int8_t old = s->temp_c[cell];
+  if (old == c) return false;
+  s->temp_c[cell] = c;
+  mark(s, cell);
+
+  if (old != CELL_TEMP_NONE) s->temp_cells--;
+  if (c == CELL_TEMP_NONE) {
+    if (cell == s->min_c_cell || cell == s->max_c_cell) s->rescan |= RESCAN_TEMP;
+    return true;
+  }
+  s->temp_cells++;
+
+  if (s->temp_cells == 1 || c < s->min_c) {
+    s->min_c = c;
+    s->min_c_cell = cell;
+  } else if (cell == s->min_c_cell && c > old) {
+    s->rescan |= RESCAN_TEMP;
+  }
+  if (s->temp_cells == 1 || c > s->max_c) {
+    s->max_c = c;
+    s->max_c_cell = cell;
+  } else if (cell == s->max_c_cell && c < old) {
+    s->rescan |= RESCAN_TEMP;
+  }
+  return true;
+}
+
+static void rescan(CellStore *s) {
+  if (s->rescan & RESCAN_MV) {
+    s->min_mv = UINT16_MAX;
+    s->max_mv = 0;
+    s->min_mv_cell = s->max_mv_cell = 0;
+    for (uint8_t i = 0; i < s->count; i++) {
+      uint16_t mv = s->mv[i];
+      if (!mv) continue;
+      if (mv < s->min_mv) { s->min_mv = mv; s->min_mv_cell = i; }
+      if (mv > s->max_mv) { s->max_mv = mv; s->max_mv_cell = i; }
+    }
+    if (!s->mv_cells) s->min_mv = 0;
+  }
+  if (s->rescan & RESCAN_TEMP) {
+    s->min_c = INT8_MAX;
+    s->max_c = INT8_MIN;
+    s->min_c_cell = s->max_c_cell = 0;
+    for (uint8_t i = 0; i < s->count; i++) {
+      int8_t c = s->temp_c[i];
+      if (c == CELL_TEMP_NONE) continue;
+      if (c < s->min_c) { s->min_c = c; s->min_c_cell = i; }
+      if (c > s->max_c) { s->max_c = c; s->max_c_cell = i; }
+    }
+    if (!s->temp_cells) s->min_c = s->max_c = 0;
+  }
+  s->rescan = 0;
+}
+
+bool cell_store_apply_block(CellStore *s, const TelemetryBlock *block) {
+  if (block->len < 1) return false;
+  if (block->id != ID_CELL_VOLTAGES && block->id != ID_CELL_TEMPS) return false;
+
+  uint8_t first = block->data[0];
+  const uint8_t *p = block->data + 1;
+  uint16_t n = block->len - 1;
+  if (block->id == ID_CELL_VOLTAGES) n /= 2;
+  if (first >= CELL_MAX) return false;
+  if (n > CELL_MAX - first) n = CELL_MAX - first;
+
+  bool changed = false;
+  if (block->id == ID_CELL_VOLTAGES) {
+    for (uint16_t k = 0; k < n; k++) changed |= set_mv(s, first + k, (p[2 * k] << 8) | p[2 * k + 1]);
+  } else {
+    for (uint16_t k = 0; k < n; k++) changed |= set_temp(s, first + k, (int8_t)p[k]);
+  }
+  if (s->rescan) rescan(s);
+  return changed;
+}
+
+void cell_store_sync(CellStore *dst, CellStore *src) {
+  uint32_t dirty[CELL_DIRTY_WORDS];
+  for (uint8_t w = 0; w < CELL_DIRTY_WORDS; w++) dirty[w] = dst->dirty[w] | src->dirty[w];
+  memcpy(dst, src, sizeof(*dst));
+  memcpy(dst->dirty, dirty, sizeof(dirty));
+  memset(src->dirty, 0, sizeof(src->dirty));
+}
+
+void cell_store_clear_dirty(CellStore *s) {
+  memset(s->dirty, 0, sizeof(s->dirty));
+}
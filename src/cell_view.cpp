@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cell_view.h"
+
+#define CELL_GAP      2
+#define HEAT_STEPS    16
+
+struct CellView {
+  CellStore *cells;
+  bool     show_temp;
+
+  // Grid geometry for the size and cell count it was laid out for
+  int32_t  w;
+  int32_t  h;
+  uint8_t  laid_out;
+  uint8_t  cols;
+  uint8_t  rows;
+  int32_t  cell_w;
+  int32_t  cell_h;
+  int32_t  strip_h;     // Summary line above the grid
+
+  uint8_t  mark_min;    // Cells outlined when last invalidated
+  uint8_t  mark_max;
+  char     strip[48];
+};
+
+static lv_color_t heat[HEAT_STEPS];
+static bool heat_ready = false;
+
+/* Blue (low) -> green -> yellow -> red (high) */
+static void init_heat() {
+  heat_ready = true;
+  static const uint32_t stops[4] = { 0x2962ff, 0x00c853, 0xffd600, 0xff1744 };
+  for (uint8_t i = 0; i < HEAT_STEPS; i++) {
+    uint32_t pos = i * 3 * 255 / (HEAT_STEPS - 1);
+    uint8_t seg = pos / 255 < 3 ? pos / 255 : 2;
+    uint8_t mix = pos - seg * 255;
+    heat[i] = lv_color_mix(lv_color_hex(stops[seg + 1]), lv_color_hex(stops[seg]), mix);
+  }
+}
+
+static lv_color_t cell_color(const CellView *cv, uint8_t cell) {
+  int32_t v, lo, hi;
+  if (cv->show_temp) {
+    if (cv->cells->temp_c[cell] == CELL_TEMP_NONE) return lv_color_hex(0x333333);
+    v = cv->cells->temp_c[cell];
+    lo = CELL_VIEW_C_LOW;
+    hi = CELL_VIEW_C_HIGH;
+  } else {
+    if (!cv->cells->mv[cell]) return lv_color_hex(0x333333);
+    v = cv->cells->mv[cell];
+    lo = CELL_VIEW_MV_LOW;
+    hi = CELL_VIEW_MV_HIGH;
+  }
+  if (v <= lo) return heat[0];
+  if (v >= hi) return heat[HEAT_STEPS - 1];
+  return heat[(v - lo) * HEAT_STEPS / (hi - lo + 1)];
+}
+
+static void extremes(const CellView *cv, uint8_t *min_cell, uint8_t *max_cell) {
+  const CellStore *s = cv->cells;
+  bool any = cv->show_temp ? s->temp_cells : s->mv_cells;
+  *min_cell = !any ? CELL_MAX : cv->show_temp ? s->min_c_cell : s->min_mv_cell;
+  *max_cell = !any ? CELL_MAX : cv->show_temp ? s->max_c_cell : s->max_mv_cell;
+}
+
+/* Summary line; returns true if it changed */
+static bool format_strip(CellView *cv) {
+  const CellStore *s = cv->cells;
+  char text[sizeof(cv->strip)];
+
+  if (cv->show_temp && s->temp_cells) {
+    snprintf(text, sizeof(text), "Min %d°C  Max %d°C  Delta %d°C",
+             s->min_c, s->max_c, s->max_c - s->min_c);
+  } else if (!cv->show_temp && s->mv_cells) {
+    snprintf(text, sizeof(text), "Min %u.%03u  Max %u.%03u  Delta %u mV",
+             s->min_mv / 1000, s->min_mv % 1000, s->max_mv / 1000, s->max_mv % 1000,
+             s->max_mv - s->min_mv);
+  } else {
+    snprintf(text, sizeof(text), "No cell data");
+  }
+
+  if (!strcmp(text, cv->strip)) return false;
+  strcpy(cv->strip, text);
+  return true;
+}
+
+static void layout(CellView *cv, lv_obj_t *obj) {
+  int32_t w = cv->w;
+  int32_t h = cv->h;
+  const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+  uint8_t count = cv->cells->count ? cv->cells->count : 1;
+
+  cv->laid_out = cv->cells->count;
+  cv->strip_h = lv_font_get_line_height(font) + 4;
+  cv->cols = count > 128 ? 20 : 16;
+  cv->rows = (count + cv->cols - 1) / cv->cols;
+  cv->cell_w = (w + CELL_GAP) / cv->cols - CELL_GAP;
+  cv->cell_h = (h - cv->strip_h + CELL_GAP) / cv->rows - CELL_GAP;
+  if (cv->cell_h > cv->cell_w) cv->cell_h = cv->cell_w;
+}
+
+static void cell_area(const CellView *cv, const lv_area_t *coords, uint8_t row, uint8_t col,
+                      lv_area_t *a) {
+  a->x1 = coords->x1 + col * (cv->cell_w + CELL_GAP);
+  a->y1 = coords->y1 + cv->strip_h + row * (cv->cell_h + CELL_GAP);
+  a->x2 = a->x1 + cv->cell_w - 1;
+  a->y2 = a->y1 + cv->cell_h - 1;
+}
+
+static void draw(CellView *cv, lv_obj_t *obj, lv_layer_t *layer) {
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+  const lv_area_t *clip = &layer->_clip_area;
+
+  if (clip->y1 < coords.y1 + cv->strip_h) {
+    lv_draw_label_dsc_t label;
+    lv_draw_label_dsc_init(&label);
+    label.font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    label.color = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
+    label.text = cv->strip;
+    label.text_local = 1;
+    lv_area_t a = { coords.x1, coords.y1, coords.x2, coords.y1 + cv->strip_h - 1 };
+    lv_draw_label(layer, &label, &a);
+  }
+
+  // Only the rows and columns inside the clip area
+  int32_t pitch_x = cv->cell_w + CELL_GAP;
+  int32_t pitch_y = cv->cell_h + CELL_GAP;
+  int32_t grid_y = coords.y1 + cv->strip_h;
+  int32_t r0 = clip->y1 > grid_y ? (clip->y1 - grid_y) / pitch_y : 0;
+  int32_t r1 = (clip->y2 - grid_y) / pitch_y;
+  int32_t c0 = clip->x1 > coords.x1 ? (clip->x1 - coords.x1) / pitch_x : 0;
+  int32_t c1 = (clip->x2 - coords.x1) / pitch_x;
+  if (clip->y2 < grid_y) return;
+  if (r1 >= cv->rows) r1 = cv->rows - 1;
+  if (c1 >= cv->cols) c1 = cv->cols - 1;
+
+  uint8_t min_cell, max_cell;
+  extremes(cv, &min_cell, &max_cell);
+
+  lv_draw_rect_dsc_t dsc;
+  lv_draw_rect_dsc_init(&dsc);
+  dsc.radius = 2;
+  for (int32_t r = r0; r <= r1; r++) {
+    for (int32_t c = c0; c <= c1; c++) {
+      uint16_t cell = r * cv->cols + c;
+      if (cell >= cv->cells->count) break;
+
+      lv_area_t a;
+      cell_area(cv, &coords, r, c, &a);
+      dsc.bg_color = cell_color(cv, cell);
+      dsc.border_width = (cell == min_cell || cell == max_cell) ? 1 : 0;
+      dsc.border_color = lv_color_white();
+      lv_draw_rect(layer, &dsc, &a);
+    }
+  }
+}
+
+static void cell_view_event_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+  CellView *cv = (CellView *)lv_obj_get_user_data(obj);
+  if (!cv) return;
+
+  lv_event_code_t code = lv_event_get_code(e);
+
+  if (code == LV_EVENT_DRAW_MAIN) {
+    draw(cv, obj, lv_event_get_layer(e));
+  } else if (code == LV_EVENT_CLICKED) {
+    cv->show_temp = !cv->show_temp;
+    extremes(cv, &cv->mark_min, &cv->mark_max);
+    format_strip(cv);
+    lv_obj_invalidate(obj);
+  } else if (code == LV_EVENT_SIZE_CHANGED) {
+    cv->w = lv_obj_get_width(obj);
+    cv->h = lv_obj_get_height(obj);
+    layout(cv, obj);
+  } else if (code == LV_EVENT_STYLE_CHANGED) {
+    layout(cv, obj);   // Font decides the summary line height
+  } else if (code == LV_EVENT_DELETE) {
+    lv_free(cv);
+    lv_obj_set_user_data(obj, NULL);
+  }
+}
+
+lv_obj_t *cell_view_create(lv_obj_t *parent, CellStore *cells, int32_t w, int32_t h) {
+  if (!heat_ready) init_heat();
+
+  CellView *cv = (CellView *)lv_malloc(sizeof(CellView));
+  if (!cv) return NULL;
+  memset(cv, 0, sizeof(*cv));
+  cv->cells = cells;
+  cv->w = w;
+  cv->h = h;
+
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_set_size(obj, w, h);
+  lv_obj_set_user_data(obj, cv);
+  lv_obj_add_event_cb(obj, cell_view_event_cb, LV_EVENT_DRAW_MAIN, NULL);
+  lv_obj_add_event_cb(obj, cell_view_event_cb, LV_EVENT_CLICKED, NULL);
+  lv_obj_add_event_cb(obj, cell_view_event_cb, LV_EVENT_SIZE_CHANGED, NULL);
+  lv_obj_add_event_cb(obj, cell_view_event_cb, LV_EVENT_STYLE_CHANGED, NULL);
+  lv_obj_add_event_cb(obj, cell_view_event_cb, LV_EVENT_DELETE, NULL);
+
+  layout(cv, obj);
+  extremes(cv, &cv->mark_min, &cv->mark_max);
+  format_strip(cv);
+  cell_store_clear_dirty(cells);   // Everything is drawn fresh anyway
+  return obj;
+}
+
+void cell_view_refresh(lv_obj_t *obj) {
+  if (!obj) return;
+  CellView *cv = (CellView *)lv_obj_get_user_data(obj);
+  if (!cv) return;
+  CellStore *s = cv->cells;
+
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+
+  if (s->count != cv->laid_out) {
+    // Pack grew: new geometry, repaint everything once
+    layout(cv, obj);
+    extremes(cv, &cv->mark_min, &cv->mark_max);
+    format_strip(cv);
+    cell_store_clear_dirty(s);
+    lv_obj_invalidate(obj);
+    return;
+  }
+
+  // Outlines follow the extremes: repaint the cells that gain or lose one
+  uint8_t min_cell, max_cell;
+  extremes(cv, &min_cell, &max_cell);
+  const uint8_t moved[4] = { cv->mark_min, cv->mark_max, min_cell, max_cell };
+  if (min_cell != cv->mark_min || max_cell != cv->mark_max) {
+    for (uint8_t k = 0; k < 4; k++) {
+      if (moved[k] < CELL_MAX) s->dirty[moved[k] / 32] |= 1u << (moved[k] % 32);
+    }
+    cv->mark_min = min_cell;
+    cv->mark_max = max_cell;
+  }
+
+  // One area per row spanning its changed cells keeps the invalidation list
+  // short even for a full-pack update
+  for (uint8_t r = 0; r < cv->rows; r++) {
+    int16_t first = -1, last = -1;
+    for (uint8_t c = 0; c < cv->cols; c++) {
+      uint16_t cell = r * cv->cols + c;
+      if (cell >= s->count) break;
+      if (cell_store_is_dirty(s, cell)) {
+        if (first < 0) first = c;
+        last = c;
+      }
+    }
+    if (first < 0) continue;
+
+    lv_area_t a, b;
+    cell_area(cv, &coords, r, first, &a);
+    cell_area(cv, &coords, r, last, &b);
+    a.x2 = b.x2;
+    lv_obj_invalidate_area(obj, &a);
+  }
+
+  if (format_strip(cv)) {
+    lv_area_t a = { coords.x1, coords.y1, coords.x2, coords.y1 + cv->strip_h - 1 };
+    lv_obj_invalidate_area(obj, &a);
+  }
+  cell_store_clear_dirty(s);
+}
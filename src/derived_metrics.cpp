@@ -0,0 +1,116 @@
+#include <math.h>
+#include <string.h>
+
+#include "derived_metrics.h"
+
+#define MJ_PER_CENTI_KWH  36000000LL   // 0.01 kWh
+#define MM_PER_KM         1000000.0f
+
+void derived_init(DerivedMetrics *m) {
+  memset(m, 0, sizeof(*m));
+}
+
+/* Move the window up to now_ms, dropping buckets that fall out of it */
+static void derived_advance(DerivedMetrics *m, uint32_t now_ms) {
+  if (now_ms - m->bucket_start_ms >= (uint32_t)DERIVED_BUCKET_MS * DERIVED_WINDOW) {
+    memset(m->buckets, 0, sizeof(m->buckets));
+    m->win_mj = 0;
+    m->win_mm = 0;
+    m->win_ms = 0;
+    m->bucket_start_ms = now_ms;
+    return;
+  }
+  while (now_ms - m->bucket_start_ms >= DERIVED_BUCKET_MS) {
+    m->head = (m->head + 1) % DERIVED_WINDOW;
+    DerivedBucket *old = &m->buckets[m->head];
+    m->win_mj -= old->mj;
+    m->win_mm -= old->mm;
+    m->win_ms -= old->ms;
+    memset(old, 0, sizeof(*old));
+    m->bucket_start_ms += DERIVED_BUCKET_MS;
+  }
+}
+
+static void derived_integrate(DerivedMetrics *m, uint32_t dt_ms) {
+  int32_t mj = (int32_t)lroundf(m->power_w * dt_ms);                  // W * ms = mJ
+  uint32_t mm = m->speed_kmh > 0 ? (uint32_t)lroundf(m->speed_kmh * dt_ms / 3.6f) : 0;
+
+  if (mj >= 0) m->used_mj += mj;
+  else m->regen_mj -= mj;
+  m->trip_net_mj += mj;
+  m->trip_mm += mm;
+
+  DerivedBucket *b = &m->buckets[m->head];
+  b->mj += mj;
+  b->mm += mm;
+  b->ms += dt_ms;
+  m->win_mj += mj;
+  m->win_mm += mm;
+  m->win_ms += dt_ms;
+}
+
+/* Wh/km over a net energy and distance, or -1 when not trustworthy */
+static float consumption_wh_km(int64_t mj, uint64_t mm) {
+  if (mm < DERIVED_MIN_KM * MM_PER_KM || mj <= 0) return -1;
+  return (mj / 3600000.0f) / (mm / MM_PER_KM);
+}
+
+uint32_t derived_update(DerivedMetrics *m, uint32_t now_ms, const DerivedInputs *in) {
+  if (!m->started) {
+    m->started = true;
+    m->bucket_start_ms = now_ms;
+  } else {
+    uint32_t dt = now_ms - m->last_ms;
+    derived_advance(m, now_ms);
+    if (dt <= DERIVED_MAX_GAP_MS) derived_integrate(m, dt);
+  }
+  m->last_ms = now_ms;
+  m->power_w = in->voltage * in->current;
+  m->speed_kmh = in->speed_kmh;
+
+  // Recent consumption first, the whole trip while the window is too short
+  float wh_km = consumption_wh_km(m->win_mj, m->win_mm);
+  if (wh_km < 0) wh_km = consumption_wh_km(m->trip_net_mj, m->trip_mm);
+
+  int32_t out[DERIVED_COUNT];
+  out[DERIVED_POWER - FIELD_COUNT] = (int32_t)lroundf(m->power_w);
+  out[DERIVED_ENERGY_USED - FIELD_COUNT] = (int32_t)((m->used_mj + MJ_PER_CENTI_KWH / 2) / MJ_PER_CENTI_KWH);
+  out[DERIVED_ENERGY_REGEN - FIELD_COUNT] = (int32_t)((m->regen_mj + MJ_PER_CENTI_KWH / 2) / MJ_PER_CENTI_KWH);
+  out[DERIVED_AVG_WKM - FIELD_COUNT] = wh_km < 0 ? in->ctrl_avg_wkm : (int32_t)lroundf(wh_km);
+  out[DERIVED_AVG_KMH - FIELD_COUNT] = m->win_ms ? (int32_t)lroundf(m->win_mm * 3.6f / m->win_ms) : 0;
+  out[DERIVED_RANGE - FIELD_COUNT] = wh_km < 0 ? in->ctrl_range_km
+                                   : (int32_t)lroundf(in->soc * 0.01f * DERIVED_PACK_WH / wh_km);
+
+  uint32_t changed = 0;
+  for (uint8_t d = 0; d < DERIVED_COUNT; d++) {
+    if (out[d] != m->out[d]) {
+      m->out[d] = out[d];
+      changed |= DASH_FIELD_BIT(FIELD_COUNT + d);
+    }
+  }
+  return changed;
+}
+
+int32_t derived_value(const DerivedMetrics *m, uint8_t field) {
+  if (field < FIELD_COUNT || field >= DASH_FIELD_COUNT) return 0;
+  return m->out[field - FIELD_COUNT];
+}
+
+// Telemetry fields each derived value is computed from
+static const uint16_t derived_inputs[DERIVED_COUNT] = {
+  FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT),                              // Power
+  FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT),                              // Energy used
+  FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT),                              // Energy regen
+  FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT) | FIELD_BIT(FIELD_SPEED),     // Wh/km
+  FIELD_BIT(FIELD_SPEED),                                                           // km/h
+  FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT) | FIELD_BIT(FIELD_SPEED) |
+    FIELD_BIT(FIELD_SOC),                                                           // Range
+};
+
+uint32_t derived_stale_fields(uint16_t stale_fields) {
+  uint32_t stale = stale_fields;
+  for (uint8_t d = 0; d < DERIVED_COUNT; d++) {
+    if (derived_inputs[d] & stale_fields) stale |= DASH_FIELD_BIT(FIELD_COUNT + d);
+  }
+  return stale;
+}
@@ -0,0 +1,195 @@
+#include <string.h>
+
+#include "digit_display.h"
+
+// Cached glyphs: '0'-'9', then '-'
+#define DIGIT_GLYPHS 11
+#define GLYPH_MINUS  10
+
+struct DigitGlyph {
+  int16_t ofs_x;              // Font pixels, from the font's glyph descriptor
+  int16_t ofs_y;
+  int16_t adv_w;
+  lv_draw_buf_t *bitmap;      // A8, at the font's own size; NULL until first drawn
+};
+
+struct DigitDisplay {
+  uint8_t  digits;
+  char     glyphs[DIGIT_DISPLAY_MAX_DIGITS];  // '0'-'9', '-' or ' ' per cell
+  int32_t  height;            // Requested digit height, px
+
+  // Geometry of the current font
+  const lv_font_t *font;
+  int32_t  scale;             // 8.8 fixed point, LV_SCALE_NONE = as the font draws it
+  int32_t  top;               // Top of the tallest digit above the baseline, font pixels
+  int32_t  cell_w;            // Widest digit advance, scaled
+  DigitGlyph glyph[DIGIT_GLYPHS];
+};
+
+static int8_t glyph_index(char c) {
+  if(c >= '0' && c <= '9') return c - '0';
+  if(c == '-') return GLYPH_MINUS;
+  return -1;
+}
+
+static void free_bitmaps(DigitDisplay *dd) {
+  for(uint8_t k = 0; k < DIGIT_GLYPHS; k++) {
+    if(!dd->glyph[k].bitmap) continue;
+    lv_image_cache_drop(dd->glyph[k].bitmap);
+    lv_draw_buf_destroy(dd->glyph[k].bitmap);
+    dd->glyph[k].bitmap = NULL;
+  }
+}
+
+/* Glyph metrics and cell size for the widget's font. Bitmaps are dropped and
+ * rasterised again on the next draw. Returns false if the font has no digits. */
+static bool set_font(lv_obj_t *obj, DigitDisplay *dd, const lv_font_t *font) {
+  free_bitmaps(dd);
+  dd->font = font;
+  dd->cell_w = 0;
+
+  int32_t top = 0, bottom = 0, adv = 0;   // Over the digits; '-' sits between them
+  for(uint8_t k = 0; k < DIGIT_GLYPHS; k++) {
+    lv_font_glyph_dsc_t g;
+    memset(&g, 0, sizeof(g));
+    uint32_t letter = k == GLYPH_MINUS ? '-' : '0' + k;
+    if(!lv_font_get_glyph_dsc(font, &g, letter, 0)) {
+      if(k != GLYPH_MINUS) return false;
+    }
+    dd->glyph[k].ofs_x = g.ofs_x;
+    dd->glyph[k].ofs_y = g.ofs_y;
+    dd->glyph[k].adv_w = g.adv_w;
+    if(k == GLYPH_MINUS) break;
+    if(g.ofs_y + g.box_h > top) top = g.ofs_y + g.box_h;
+    if(g.ofs_y < bottom || k == 0) bottom = g.ofs_y;
+    if(g.adv_w > adv) adv = g.adv_w;
+  }
+  if(top <= bottom) return false;
+
+  dd->top = top;
+  dd->scale = dd->height * LV_SCALE_NONE / (top - bottom);
+  dd->cell_w = (adv * dd->scale + LV_SCALE_NONE - 1) / LV_SCALE_NONE;
+  lv_obj_set_size(obj, dd->digits * dd->cell_w, dd->height);
+  return true;
+}
+
+static lv_draw_buf_t *glyph_bitmap(DigitDisplay *dd, uint8_t k) {
+  if(dd->glyph[k].bitmap) return dd->glyph[k].bitmap;
+
+  lv_font_glyph_dsc_t g;
+  memset(&g, 0, sizeof(g));
+  if(!lv_font_get_glyph_dsc(dd->font, &g, k == GLYPH_MINUS ? '-' : '0' + k, 0)) return NULL;
+  if(g.box_w == 0 || g.box_h == 0) return NULL;
+
+  lv_draw_buf_t *buf = lv_draw_buf_create(g.box_w, g.box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+  if(!buf) return NULL;
+  if(!lv_font_get_glyph_bitmap(&g, buf)) {
+    lv_draw_buf_destroy(buf);
+    return NULL;
+  }
+  dd->glyph[k].bitmap = buf;
+  return buf;
+}
+
+static void digit_display_event_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+  DigitDisplay *dd = (DigitDisplay *)lv_obj_get_user_data(obj);
+  if(!dd) return;
+
+  lv_event_code_t code = lv_event_get_code(e);
+
+  if(code == LV_EVENT_STYLE_CHANGED) {
+    // Setting the size below restyles the widget too: only act on a new font
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    if(font != dd->font) set_font(obj, dd, font);
+  } else if(code == LV_EVENT_DRAW_MAIN) {
+    if(!dd->cell_w) return;     // Font without digits
+
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.opa = lv_obj_get_style_text_opa(obj, LV_PART_MAIN);
+    dsc.recolor = lv_obj_get_style_text_color(obj, LV_PART_MAIN);   // A8: the glyph's colour
+    dsc.recolor_opa = LV_OPA_COVER;
+    dsc.scale_x = dsc.scale_y = dd->scale;
+    dsc.pivot.x = dsc.pivot.y = 0;
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    for(uint8_t i = 0; i < dd->digits; i++) {
+      int8_t k = glyph_index(dd->glyphs[i]);
+      if(k < 0) continue;
+      lv_draw_buf_t *bitmap = glyph_bitmap(dd, k);
+      if(!bitmap) continue;
+
+      // Centred in its cell, on the common baseline
+      const DigitGlyph *g = &dd->glyph[k];
+      int32_t x = coords.x1 + i * dd->cell_w + (dd->cell_w - g->adv_w * dd->scale / LV_SCALE_NONE) / 2 +
+                  g->ofs_x * dd->scale / LV_SCALE_NONE;
+      int32_t y = coords.y1 + (dd->top - g->ofs_y - (int32_t)bitmap->header.h) * dd->scale / LV_SCALE_NONE;
+      lv_area_t a = { x, y, (int32_t)(x + bitmap->header.w - 1), (int32_t)(y + bitmap->header.h - 1) };
+      dsc.src = bitmap;
+      lv_draw_image(layer, &dsc, &a);
+    }
+  } else if(code == LV_EVENT_DELETE) {
+    free_bitmaps(dd);
+    lv_free(dd);
+    lv_obj_set_user_data(obj, NULL);
+  }
+}
+
+lv_obj_t *digit_display_create(lv_obj_t *parent, uint8_t digits, int32_t height) {
+  if(digits > DIGIT_DISPLAY_MAX_DIGITS) digits = DIGIT_DISPLAY_MAX_DIGITS;
+
+  DigitDisplay *dd = (DigitDisplay *)lv_malloc(sizeof(DigitDisplay));
+  if(!dd) return NULL;
+  memset(dd, 0, sizeof(*dd));
+
+  dd->digits = digits;
+  dd->height = height;
+  memset(dd->glyphs, ' ', sizeof(dd->glyphs));
+
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_user_data(obj, dd);
+  lv_obj_add_event_cb(obj, digit_display_event_cb, LV_EVENT_STYLE_CHANGED, NULL);
+  lv_obj_add_event_cb(obj, digit_display_event_cb, LV_EVENT_DRAW_MAIN, NULL);
+  lv_obj_add_event_cb(obj, digit_display_event_cb, LV_EVENT_DELETE, NULL);
+  set_font(obj, dd, lv_obj_get_style_text_font(obj, LV_PART_MAIN));   // Inherited until one is set
+  return obj;
+}
+
+/* Right-aligned value; only cells whose glyph changed are invalidated */
+void digit_display_set_value(lv_obj_t *obj, int32_t value) {
+  if(!obj) return;
+  DigitDisplay *dd = (DigitDisplay *)lv_obj_get_user_data(obj);
+  if(!dd) return;
+
+  char glyphs[DIGIT_DISPLAY_MAX_DIGITS];
+  memset(glyphs, ' ', sizeof(glyphs));
+
+  bool negative = value < 0;
+  uint32_t v = negative ? -value : value;
+  int8_t i = dd->digits - 1;
+  do {
+    glyphs[i--] = '0' + v % 10;
+    v /= 10;
+  } while(v && i >= 0);
+  if(negative && i >= 0) glyphs[i] = '-';
+
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+  for(uint8_t c = 0; c < dd->digits; c++) {
+    if(glyphs[c] == dd->glyphs[c]) continue;
+    dd->glyphs[c] = glyphs[c];
+
+    lv_area_t cell;
+    cell.x1 = coords.x1 + c * dd->cell_w;
+    cell.x2 = cell.x1 + dd->cell_w - 1;
+    cell.y1 = coords.y1;
+    cell.y2 = coords.y2;
+    lv_obj_invalidate_area(obj, &cell);
+  }
+}
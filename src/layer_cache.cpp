@@ -0,0 +1,165 @@
+#include "layer_cache.h"
+
+static uint32_t cached_bytes = 0;
+static lv_color_t bake_backdrop;
+
+/* Saved opacities of a live part while it is hidden for the snapshot */
+struct PartOpa {
+  lv_opa_t bg;
+  lv_opa_t border;
+  lv_opa_t arc;
+  lv_opa_t shadow;
+};
+
+static void hide_part(lv_obj_t *obj, lv_part_t part, PartOpa *saved) {
+  saved->bg = lv_obj_get_style_bg_opa(obj, part);
+  saved->border = lv_obj_get_style_border_opa(obj, part);
+  saved->arc = lv_obj_get_style_arc_opa(obj, part);
+  saved->shadow = lv_obj_get_style_shadow_opa(obj, part);
+  lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, part);
+  lv_obj_set_style_border_opa(obj, LV_OPA_TRANSP, part);
+  lv_obj_set_style_arc_opa(obj, LV_OPA_TRANSP, part);
+  lv_obj_set_style_shadow_opa(obj, LV_OPA_TRANSP, part);
+}
+
+static void restore_part(lv_obj_t *obj, lv_part_t part, const PartOpa *saved) {
+  lv_obj_set_style_bg_opa(obj, saved->bg, part);
+  lv_obj_set_style_border_opa(obj, saved->border, part);
+  lv_obj_set_style_arc_opa(obj, saved->arc, part);
+  lv_obj_set_style_shadow_opa(obj, saved->shadow, part);
+}
+
+/* Fill the whole snapshot area with the parent's colour before obj draws, so
+ * rounded corners and anti-aliased edges blend onto it and RGB565 needs no
+ * alpha */
+static void backdrop_draw_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+
+  lv_area_t area;
+  lv_obj_get_coords(obj, &area);
+  int32_t ext = lv_obj_get_ext_draw_size(obj);
+  lv_area_increase(&area, ext, ext);
+
+  lv_draw_rect_dsc_t dsc;
+  lv_draw_rect_dsc_init(&dsc);
+  dsc.bg_color = bake_backdrop;
+  dsc.bg_opa = LV_OPA_COVER;
+  dsc.radius = 0;
+  lv_draw_rect(lv_event_get_layer(e), &dsc, &area);
+}
+
+static void baked_image_delete_cb(lv_event_t *e) {
+  lv_draw_buf_t *snap = (lv_draw_buf_t *)lv_event_get_user_data(e);
+  cached_bytes -= snap->data_size;
+  lv_image_cache_drop(snap);
+  lv_draw_buf_destroy(snap);
+}
+
+static bool is_live(lv_obj_t *child, lv_obj_t *const *live, uint8_t live_count) {
+  for (uint8_t i = 0; i < live_count; i++) {
+    if (live[i] == child) return true;
+  }
+  return false;
+}
+
+/* What obj is drawn on: the nearest ancestor with a solid background. Layout
+ * containers in between are transparent. */
+static lv_obj_t *backdrop_of(lv_obj_t *obj) {
+  lv_obj_t *parent = lv_obj_get_parent(obj);
+  while (parent && lv_obj_get_parent(parent) &&
+         lv_obj_get_style_bg_opa(parent, LV_PART_MAIN) < LV_OPA_COVER) {
+    parent = lv_obj_get_parent(parent);
+  }
+  return parent;
+}
+
+lv_draw_buf_t *layer_cache_snapshot(lv_obj_t *obj) {
+#if LV_USE_SNAPSHOT
+  lv_obj_t *parent = obj ? backdrop_of(obj) : NULL;
+  if (!parent) return NULL;
+
+  bake_backdrop = lv_obj_get_style_bg_color(parent, LV_PART_MAIN);
+  lv_obj_add_event_cb(obj, backdrop_draw_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+  lv_draw_buf_t *snap = lv_snapshot_take(obj, LV_COLOR_FORMAT_RGB565);
+  lv_obj_remove_event_cb(obj, backdrop_draw_cb);
+  return snap;
+#else
+  LV_UNUSED(obj);
+  return NULL;
+#endif
+}
+
+lv_obj_t *layer_cache_bake(lv_obj_t *obj, lv_obj_t *const *live, uint8_t live_count,
+                           uint8_t live_parts) {
+#if LV_USE_SNAPSHOT
+  lv_obj_t *parent = obj ? lv_obj_get_parent(obj) : NULL;
+  if (!parent) return NULL;
+
+  lv_obj_update_layout(obj);
+
+  // Live content must not end up in the snapshot
+  for (uint8_t i = 0; i < live_count; i++) {
+    lv_obj_add_flag(live[i], LV_OBJ_FLAG_HIDDEN);
+  }
+  PartOpa indicator, knob;
+  if (live_parts & LAYER_LIVE_INDICATOR) hide_part(obj, LV_PART_INDICATOR, &indicator);
+  if (live_parts & LAYER_LIVE_KNOB) hide_part(obj, LV_PART_KNOB, &knob);
+
+  lv_draw_buf_t *snap = layer_cache_snapshot(obj);
+
+  for (uint8_t i = 0; i < live_count; i++) {
+    lv_obj_remove_flag(live[i], LV_OBJ_FLAG_HIDDEN);
+  }
+  if (live_parts & LAYER_LIVE_INDICATOR) restore_part(obj, LV_PART_INDICATOR, &indicator);
+  if (live_parts & LAYER_LIVE_KNOB) restore_part(obj, LV_PART_KNOB, &knob);
+
+  if (!snap) {
+    LV_LOG_WARN("snapshot failed, rendering live");
+    return NULL;
+  }
+  cached_bytes += snap->data_size;
+
+  // Snapshot covers obj plus its extra draw area (shadows, outlines, knob)
+  int32_t ext = lv_obj_get_ext_draw_size(obj);
+  lv_obj_t *img = lv_image_create(parent);
+  lv_image_set_src(img, snap);
+  lv_obj_add_flag(img, LV_OBJ_FLAG_IGNORE_LAYOUT);
+  lv_obj_set_pos(img, lv_obj_get_x(obj) - ext, lv_obj_get_y(obj) - ext);
+  lv_obj_move_to_index(img, lv_obj_get_index(obj));
+  lv_obj_add_event_cb(img, baked_image_delete_cb, LV_EVENT_DELETE, snap);
+
+  if (live_count == 0 && live_parts == 0) {
+    // Under a flex or grid parent a hidden obj would give up its slot and
+    // move its siblings away from their baked images; keep it, invisible
+    if (lv_obj_get_style_layout(parent, LV_PART_MAIN) != LV_LAYOUT_NONE) {
+      lv_obj_set_style_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN);
+    } else {
+      lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    }
+    return img;
+  }
+
+  // Keep obj for layout and its live content, drop everything static
+  uint32_t count = lv_obj_get_child_count(obj);
+  for (uint32_t i = 0; i < count; i++) {
+    lv_obj_t *child = lv_obj_get_child(obj, i);
+    if (!is_live(child, live, live_count)) lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+  }
+  lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN);
+  lv_obj_set_style_border_width(obj, 0, LV_PART_MAIN);
+  lv_obj_set_style_outline_width(obj, 0, LV_PART_MAIN);
+  lv_obj_set_style_shadow_width(obj, 0, LV_PART_MAIN);
+  lv_obj_set_style_arc_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN);
+  return img;
+#else
+  LV_UNUSED(obj);
+  LV_UNUSED(live);
+  LV_UNUSED(live_count);
+  LV_UNUSED(live_parts);
+  return NULL;
+#endif
+}
+
+uint32_t layer_cache_bytes() {
+  return cached_bytes;
+}
@@ -0,0 +1,62 @@
+#include <string.h>
+
+#include "link_health.h"
+#include "hot_path.h"
+
+LinkHealth linkHealth = {};
+
+void link_health_frame_ok(uint16_t fields, uint32_t now_ms) {
+  linkHealth.frames_ok++;
+  linkHealth.win_frames++;
+  linkHealth.last_valid_ms = now_ms;
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (fields & FIELD_BIT(f)) linkHealth.win_field_updates[f]++;
+  }
+}
+
+// Called from the framer's decode, without dataMutex; see LinkHealth
+HOT_CODE void link_health_crc_error() {
+  __atomic_add_fetch(&linkHealth.crc_errors, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&linkHealth.win_crc, 1, __ATOMIC_RELAXED);
+}
+
+HOT_CODE void link_health_bytes_dropped(uint32_t count) {
+  if (count) __atomic_add_fetch(&linkHealth.bytes_dropped, count, __ATOMIC_RELAXED);
+}
+
+/* Close the rate window once LINK_WINDOW_MS has passed. Cheap enough to call
+ * on every pass of the RS485 loop. */
+void link_health_tick(uint32_t now_ms) {
+  uint32_t elapsed = now_ms - linkHealth.window_start_ms;
+  if (elapsed < LINK_WINDOW_MS) return;
+
+  // Errors counted after the exchange fall into the next window, none are lost
+  uint32_t win_crc = __atomic_exchange_n(&linkHealth.win_crc, 0, __ATOMIC_RELAXED);
+  float scale = 1000.0f / elapsed;
+  uint32_t attempts = linkHealth.win_frames + win_crc;
+
+  linkHealth.frame_rate = linkHealth.win_frames * scale;
+  linkHealth.crc_error_rate = attempts ? (float)win_crc / attempts : 0.0f;
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    linkHealth.field_rate[f] = linkHealth.win_field_updates[f] * scale;
+  }
+
+  linkHealth.window_start_ms = now_ms;
+  linkHealth.win_frames = 0;
+  memset(linkHealth.win_field_updates, 0, sizeof(linkHealth.win_field_updates));
+}
+
+bool link_is_down(uint32_t now_ms) {
+  return linkHealth.last_valid_ms == 0 || now_ms - linkHealth.last_valid_ms > LINK_TIMEOUT_MS;
+}
+
+/* FIELD_BIT mask of fields never received or not refreshed within FIELD_STALE_MS */
+uint16_t link_stale_fields(const uint32_t *field_rx_ms, uint32_t now_ms) {
+  uint16_t stale = 0;
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (field_rx_ms[f] == 0 || now_ms - field_rx_ms[f] > FIELD_STALE_MS) {
+      stale |= FIELD_BIT(f);
+    }
+  }
+  return stale;
+}
@@ -2,6 +2,7 @@
 #include <SD.h>
 #include <SPI.h>
 #include <lvgl.h>
+#include <lvgl_private.h>     // lv_display_t::flush_cb, wrapped by shared_bus_flush_cb
 #include <TFT_eSPI.h>
 #include <Wire.h>
 #include <GT911.h>
@@ -10,22 +11,54 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <esp_freertos_hooks.h>
+
+#include "telemetry_protocol.h"
+#include "telemetry_nodes.h"
+#include "link_health.h"
+#include "time_source.h"
+#include "derived_metrics.h"
+#include "cell_store.h"
+#include "cell_view.h"
+#include "alert_engine.h"
+#include "power_manager.h"
+#include "spi_bus.h"
+#include "sd_logger.h"
+#include "telemetry_transport.h"
+#include "rs485_transport.h"
+#include "can_transport.h"
+#include "asset_store.h"
+#include "ui_fonts.h"
+#include "ui_layout.h"
+#include "ui_alloc.h"
+#include "ui_bind.h"
+#include "ui_cmd.h"
+#include "ui_screens.h"
+#ifdef DASH_BENCH
+#include "bench.h"
+#endif
 
 // Mutex for protecting shared dashboard data
 SemaphoreHandle_t dataMutex = NULL;
 
-// LVGL Mutex for thread safety
-SemaphoreHandle_t lvgl_mutex= NULL;
-
 // I2C Mutex for thread safety
 SemaphoreHandle_t i2c_mutex= NULL;
 
-// Flag to indicate data update
-volatile bool data_updated = false;
+// Fields changed by RS485 since the UI last refreshed them (DASH_FIELD_BIT mask)
+volatile uint32_t dirty_fields = 0;
 
 #define SD_CS 5
+// Panel resolution; the UI lays itself out for it (ui_layout.h)
+#ifndef TFT_HOR_RES
 #define TFT_HOR_RES 480  // LANDSCAPE: Width first
+#endif
+#ifndef TFT_VER_RES
 #define TFT_VER_RES 320  // LANDSCAPE: Height second
+#endif
+
+// Partial render buffer: a fixed internal-RAM budget (40 lines at 480 px), so
+// wider panels render in shorter bands rather than needing more RAM
+#define DRAW_BUF_BYTES (480 * 40 * (LV_COLOR_DEPTH / 8))
 
 /* Touch pins */
 #define TOUCH_SDA 33
@@ -37,36 +70,41 @@ volatile bool data_updated = false;
 #define SERIAL1_RX 16
 #define SERIAL1_TX 17
 
-// ===== Dashboard Protocol Constants =====
-#define STX1             0x5D  // Start of text1
-#define STX2             0x47  // Start of text2
-#define ETX              0x78  // End of text
-
-// Data Identifiers
-#define ID_SOC           0x85  // State of Charge (0-100%)
-#define ID_VOLTAGE       0x83  // Total voltage (0.01V precision)
-#define ID_CURRENT       0x84  // Current (0.01A precision)
-#define ID_TEMP          0x80  // Battery Temperature (0.1°C precision)      battery_temp_label
-#define ID_SPEED         0x82  // Vehicle speed (0.1 km/h precision)          speed_label
-#define ID_MODE          0x86  // Driving mode (0=ECO, 1=CITY, 2=SPORT)        mode_label
-#define ID_ARMED         0x87  // Armed status (0=DISARMED, 1=ARMED)            status_label
-#define ID_RANGE         0x88  // Remaining range (0.1 km precision)             range_label
-#define ID_CONSUMPTION   0x89  // Average consumption (0.1 W/km precision)       avg_wkm_label
-#define ID_AMBIENT_TEMP  0x8A  // Ambient temperature (0.1°C precision)           motor_temp_label
-#define ID_TRIP          0x8B  // Trip distance (0.1 km precision)               trip_label
-#define ID_ODOMETER      0x8C  // Odometer (0.1 km precision)                    odo_label
-#define ID_AVG_SPEED     0x8D  // Average speed (0.1 km/h precision)            avg_kmh_label
-
-// Driving Modes
-enum DrivingMode {
-  MODE_ECO = 0,
-  MODE_CITY = 1,
-  MODE_SPORT = 2
+// ===== CAN (TWAI) Configuration =====
+// Needs an external transceiver; build with -D DASH_CAN to enable
+#define CAN_TX_PIN 26
+#define CAN_RX_PIN 27
+
+// Room for a CAN message re-encoded as a frame for the SD log
+#define TRANSPORT_LOG_FRAME_LEN 128
+
+// ===== Telemetry transports =====
+Rs485Transport rs485_link;
+TelemetryTransport rs485_transport;
+
+#ifdef DASH_CAN
+/* CAN IDs of the pack and motor controller, mapped onto the same fields (and
+ * raw units) as their RS485 TLVs, so both buses route through the same nodes */
+static const CanSignal can_signals[] = {
+  // id      node              field               offset size signed
+  { 0x310, NODE_ADDR_BMS,    FIELD_SOC,           0,     1,   false },
+  { 0x310, NODE_ADDR_BMS,    FIELD_VOLTAGE,       1,     2,   false },
+  { 0x310, NODE_ADDR_BMS,    FIELD_CURRENT,       3,     2,   true  },
+  { 0x310, NODE_ADDR_BMS,    FIELD_BATTERY_TEMP,  5,     2,   false },
+  { 0x320, NODE_ADDR_MOTOR,  FIELD_SPEED,         0,     2,   false },
+  { 0x320, NODE_ADDR_MOTOR,  FIELD_MODE,          2,     1,   false },
+  { 0x320, NODE_ADDR_MOTOR,  FIELD_ARMED,         3,     1,   false },
+  { 0x320, NODE_ADDR_MOTOR,  FIELD_AMBIENT_TEMP,  4,     2,   false },
+  { 0x321, NODE_ADDR_MOTOR,  FIELD_RANGE,         0,     2,   false },
+  { 0x321, NODE_ADDR_MOTOR,  FIELD_CONSUMPTION,   2,     2,   false },
+  { 0x321, NODE_ADDR_MOTOR,  FIELD_AVG_SPEED,     4,     2,   false },
+  { 0x322, NODE_ADDR_MOTOR,  FIELD_TRIP,          0,     2,   false },
+  { 0x322, NODE_ADDR_MOTOR,  FIELD_ODOMETER,      2,     4,   false },
 };
 
-// ===== Buffer for receiving data =====
-uint8_t serialBuffer[256];
-uint16_t bufferPos = 0;
+CanTransport can_link;
+TelemetryTransport can_transport;
+#endif
 
 GT911 ts = GT911();
 void *draw_buf;
@@ -76,37 +114,19 @@ lv_display_t *disp;
 uint8_t *image_data = NULL;
 uint32_t image_size = 0;
 
-/* Dashboard UI Elements - Global pointers to labels */
-lv_obj_t *speed_label;
-lv_obj_t *range_label;
-lv_obj_t *avg_wkm_label;
-lv_obj_t *trip_label;
-lv_obj_t *odo_label;
-lv_obj_t *avg_kmh_label;
-lv_obj_t *motor_temp_label;
-lv_obj_t *battery_temp_label;
-lv_obj_t *mode_label;
-lv_obj_t *status_label;
-
-lv_obj_t *soc;
-lv_obj_t *voltage;
-lv_obj_t *current;
-
-lv_obj_t *time_label;              // update in time
-
-// Global variables
-lv_obj_t *menu_btn = NULL;
-lv_obj_t *sidebar = NULL;
-lv_obj_t *overlay = NULL;
-bool sidebar_open = false;
+/* Telemetry widgets bind to ui_bind subjects instead of global pointers.
+ * The clock is not telemetry; its pointer is nulled when the label goes. */
+lv_obj_t *time_label = NULL;
 
 lv_indev_t *touch_indev = NULL;
 
 unsigned long last_time_update = 0;
+int time_shown_minute = -1;        // Minute of day currently on time_label
 
 /* Dashboard Data Structure */
 struct DashboardData {
   int speed;
+  float speed_kmh;              // Unrounded speed, for distance integration
   int range;
   int avg_wkm;
   int trip;
@@ -114,38 +134,60 @@ struct DashboardData {
   int avg_kmh;
   int motor_temp;
   int battery_temp;
-  String mode;
-  String status;
+  int mode;                     // DrivingMode
+  int armed;                    // 0 = DISARMED, 1 = ARMED
   int soc;
   float voltage;
   float current;
+  uint32_t rx_ms[FIELD_COUNT];  // millis() each field was last received, 0 = never
 } dashData;
 
+// Power, energy and rolling averages computed from dashData. Guarded by dataMutex.
+DerivedMetrics derived;
+
+// Per-cell voltages and temperatures. cells is guarded by dataMutex; uiTask
+// copies it into ui_cells (its own, unlocked) when cells_dirty is set.
+CellStore cells;
+volatile bool cells_dirty = false;
+
+/* Alert thresholds, in field_display_value() units. Evaluated by the telemetry
+ * tasks on every change of their field; the top active one is shown in a banner. */
+static const AlertRule alert_rules[] = {
+  // field               kind         threshold  hyst  debounce  priority        text
+  { FIELD_BATTERY_TEMP,  ALERT_ABOVE,  55,        3,    2000,     ALERT_CRITICAL, "Battery overheating" },
+  { FIELD_BATTERY_TEMP,  ALERT_ABOVE,  45,        3,    5000,     ALERT_WARNING,  "Battery hot" },
+  { FIELD_BATTERY_TEMP,  ALERT_BELOW,  0,         2,    5000,     ALERT_WARNING,  "Battery too cold" },
+  { FIELD_SOC,           ALERT_BELOW,  10,        2,    0,        ALERT_CRITICAL, "Battery critically low" },
+  { FIELD_SOC,           ALERT_BELOW,  20,        2,    0,        ALERT_WARNING,  "Battery low" },
+  { FIELD_CURRENT,       ALERT_ABOVE,  15000,     1000, 1000,     ALERT_WARNING,  "High discharge current" },
+  { FIELD_CURRENT,       ALERT_BELOW,  -5000,     500,  1000,     ALERT_WARNING,  "High regen current" },
+  { FIELD_AMBIENT_TEMP,  ALERT_ABOVE,  90,        5,    3000,     ALERT_WARNING,  "Motor hot" },
+  { DERIVED_RANGE,       ALERT_BELOW,  5,         1,    10000,    ALERT_INFO,     "Range below 5 km" },
+};
+
+// Guarded by dataMutex; every transport task updates them
+AlertEngine alerts;
+static bool banner_dirty = false;   // Top alert changed, banner not posted yet
+
 // Task handles
 TaskHandle_t rs485TaskHandle = NULL;
+TaskHandle_t canTaskHandle = NULL;
 TaskHandle_t uiTaskHandle = NULL;
 
+// Given by the telemetry tasks when it leaves work for the UI, so uiTask can sleep until
+// LVGL's next timer instead of polling
+SemaphoreHandle_t ui_wake = NULL;
+
 /* Forward declarations */
-void create_ev_dashboard_ui();
-
-void toggle_sidebar();
-void show_sidebar();
-void close_sidebar();
-static void overlay_event_cb(lv_event_t *e);  
-static void option_cb(lv_event_t *e);
-
-void show_battery_screen();
-void show_voltage_screen();
-void show_temperature_screen();
-void show_statistics_screen();
-void show_settings_screen();
+void show_diagnostics_screen();
 void update_time_display();
 
-void update_ui_element(uint8_t id);
+int32_t field_display_value(uint8_t field);
 
 /* Initialize dashboard data with defaults */
 void init_dashboard_data() {
   dashData.speed = 0;
+  dashData.speed_kmh = 0;
   dashData.range = 10;
   dashData.avg_wkm = 30;
   dashData.trip = 110;
@@ -153,74 +195,182 @@ void init_dashboard_data() {
   dashData.avg_kmh = 10;
   dashData.motor_temp = 20;
   dashData.battery_temp = 10;
-  dashData.mode = "Sports";
-  dashData.status = "ARMED";
+  dashData.mode = MODE_SPORT;
+  dashData.armed = 1;
   dashData.soc = 25;
   dashData.voltage = 23.0;
   dashData.current = 0.0;
+  memset(dashData.rx_ms, 0, sizeof(dashData.rx_ms));
+  derived_init(&derived);
+  cell_store_init(&cells);
+  cell_store_init(&ui_cells);
+  alert_engine_init(&alerts, alert_rules, sizeof(alert_rules) / sizeof(alert_rules[0]));
 }
 
-volatile int pending_screen = -1;
-
-// ===== CRC-16 Modbus Calculation =====
-uint16_t calculateChecksum(const uint8_t *data, uint16_t length) {
-  uint16_t crc = 0xFFFF;
-  for (uint16_t pos = 0; pos < length; pos++) {
-    crc ^= (uint16_t)data[pos];
-    for (uint8_t i = 8; i != 0; i--) {
-      if ((crc & 0x0001) != 0) {
-        crc >>= 1;
-        crc ^= 0xA001;
-      } else {
-        crc >>= 1;
-      }
+static inline void set_field(int &dst, int v, uint8_t field, uint16_t &changed) {
+  if (dst != v) { dst = v; changed |= FIELD_BIT(field); }
+}
+
+static inline void set_field(float &dst, float v, uint8_t field, uint16_t &changed) {
+  if (dst != v) { dst = v; changed |= FIELD_BIT(field); }
+}
+
+/* Apply the fields carried by a decoded frame to dashData.
+ * Call with dataMutex held. Returns the mask of fields whose value changed. */
+uint16_t apply_telemetry(const TelemetryFrame *frame) {
+  uint16_t changed = 0;
+
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (!(frame->present & FIELD_BIT(f))) continue;
+    uint32_t raw = frame->raw[f];
+    float value = telemetry_scale(f, raw);
+
+    switch (f) {
+      case FIELD_SOC:
+        set_field(dashData.soc, (int)value, f, changed);
+        break;
+
+      case FIELD_VOLTAGE:
+        set_field(dashData.voltage, value, f, changed);
+        break;
+
+      case FIELD_CURRENT:
+        set_field(dashData.current, value, f, changed);
+        break;
+
+      case FIELD_BATTERY_TEMP:
+        set_field(dashData.battery_temp, (int)value, f, changed);
+        break;
+
+      case FIELD_SPEED:
+        dashData.speed_kmh = value;
+        set_field(dashData.speed, (int)value, f, changed);
+        break;
+
+      case FIELD_MODE:
+        if (raw <= MODE_SPORT) set_field(dashData.mode, (int)raw, f, changed);
+        break;
+
+      case FIELD_ARMED:
+        set_field(dashData.armed, raw ? 1 : 0, f, changed);
+        break;
+
+      case FIELD_RANGE:
+        set_field(dashData.range, (int)value, f, changed);
+        break;
+
+      case FIELD_CONSUMPTION:
+        set_field(dashData.avg_wkm, (int)value, f, changed);
+        break;
+
+      case FIELD_AMBIENT_TEMP:
+        set_field(dashData.motor_temp, (int)value, f, changed);
+        break;
+
+      case FIELD_TRIP:
+        set_field(dashData.trip, (int)value, f, changed);
+        break;
+
+      case FIELD_ODOMETER:
+        set_field(dashData.odo, (int)value, f, changed);
+        break;
+
+      case FIELD_AVG_SPEED:
+        set_field(dashData.avg_kmh, (int)value, f, changed);
+        break;
     }
   }
-  return crc;
+
+  return changed;
 }
 
-// ===== Frame Validation =====
-bool validateFrame(uint8_t* frame, uint16_t len) {
-  if (len < 15 || frame[0] != STX1 || frame[1] != STX2) {
-    return false;
-  }
+volatile uint32_t touch_callback_count = 0;
+volatile uint32_t touch_detected_count = 0;
 
-  uint16_t declaredLength = (frame[2] << 8) | frame[3];
-  uint16_t expectedLength = declaredLength + 6;
-  
-  if (len != expectedLength) {
-    return false;
-  }
+/* ===== Performance Counters ===== */
+// Only collected while the diagnostics screen or the HUD overlay is up
+struct PerfStats {
+  uint32_t render_start_us;
+  uint32_t flush_start_us;
+  uint32_t frames;
+  uint32_t render_us;        // Whole refresh, flushes included
+  uint32_t render_max_us;
+  uint32_t flush_us;
+  uint32_t touch_reads;
+  uint32_t touch_us;
+  uint32_t touch_max_us;
+};
 
-  uint16_t etxPos = 4 + declaredLength - 1;
-  if (frame[etxPos] != ETX) {
-    return false;
-  }
+PerfStats perf = {};
+volatile bool perf_active = false;
 
-  uint16_t calculatedChecksum = calculateChecksum(&frame[2], declaredLength + 2);
-  uint16_t receivedChecksum = (frame[expectedLength-2] << 8) | frame[expectedLength-1];
-  
-  if (receivedChecksum != calculatedChecksum) {
-    return false;
-  }
+// Idle hook calls per core. The idle task waits for an interrupt after each
+// call, so with no other load it runs about once per RTOS tick.
+volatile uint32_t idle_calls[2] = {0, 0};
 
-  return true;
+static bool idle_hook_core0() { idle_calls[0]++; return true; }
+static bool idle_hook_core1() { idle_calls[1]++; return true; }
+
+// The panel flush holds the shared VSPI bus from start to finish. The driver's
+// flush blocks until the pixels are out, so it returns at the end of the transfer.
+static lv_display_flush_cb_t panel_flush_cb = NULL;
+static lv_area_t flush_skipped;            // Screen area to draw again, if flush_skip_pending
+static bool flush_skip_pending = false;
+
+static void redraw_skipped_cb(void *arg) {
+    lv_display_t *d = (lv_display_t *)arg;
+    lv_obj_invalidate_area(lv_display_get_screen_active(d), &flush_skipped);
+    flush_skip_pending = false;
 }
 
-volatile uint32_t touch_callback_count = 0;
-volatile uint32_t touch_detected_count = 0;
+/* A flush that cannot get the bus from the SD writer in time is not sent:
+ * the pixels would go out while the card is selected. The area is drawn
+ * again on a later refresh instead. */
+static void shared_bus_flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px_map) {
+    if(!spi_bus_acquire(SPI_CLIENT_DISPLAY, SPI_BUS_FLUSH_TIMEOUT_MS)) {
+        Serial.println("ERROR: SPI bus not released by SD writer, frame postponed");
+        if(flush_skip_pending) {
+            lv_area_join(&flush_skipped, &flush_skipped, area);
+        } else {
+            flush_skipped = *area;
+            flush_skip_pending = true;
+            lv_async_call(redraw_skipped_cb, d);   // Invalidating from inside the refresh is not allowed
+        }
+        lv_display_flush_ready(d);
+        return;
+    }
+    panel_flush_cb(d, area, px_map);
+    spi_bus_release(SPI_CLIENT_DISPLAY);
+}
+
+// A touch out of idle only wakes the screen: nothing under the near-dark
+// backlight is pressed until the finger lifts
+static bool touch_wake_only = false;
 
 void my_touch_read(lv_indev_t *indev, lv_indev_data_t *data) {
+    uint32_t t0 = micros();
    
     if(xSemaphoreTake(i2c_mutex, pdMS_TO_TICKS(50))) {  // 50ms instead of 10ms
         uint8_t touches = ts.touched(GT911_MODE_POLLING);
+
+        if(perf_active) {
+            uint32_t dt = micros() - t0;
+            perf.touch_reads++;
+            perf.touch_us += dt;
+            if(dt > perf.touch_max_us) perf.touch_max_us = dt;
+        }
+
         if (touches) {
+            if(power.state == POWER_IDLE) touch_wake_only = true;
+            power_touch(&power, millis(), t0);
+
             GTPoint *p = ts.getPoints();
             data->point.x = TFT_HOR_RES - p->y;
             data->point.y = p->x;
-            data->state = LV_INDEV_STATE_PRESSED;
+            data->state = touch_wake_only ? LV_INDEV_STATE_RELEASED : LV_INDEV_STATE_PRESSED;
             Serial.printf("Touch: x=%d, y=%d\n", data->point.x, data->point.y);
         } else {
+            touch_wake_only = false;
             data->state = LV_INDEV_STATE_RELEASED;
         }
         xSemaphoreGive(i2c_mutex);
@@ -254,6 +404,144 @@ void my_touch_read(lv_indev_t *indev, lv_indev_data_t *data) {
 //   Serial.println("=== Touch Test Complete ===\n");
 // }
 
+/* Screen switch, run by uiTask once the triggering event callback returned */
+static void switch_screen(int screen_id) {
+  Serial.printf("UI Task: Switching to screen %d\n", screen_id);
+  
+  // Delete sidebar (now safe - event callback has returned)
+  sidebar_delete();
+  
+  // Switch screens
+  switch(screen_id) {
+    case SCREEN_BATTERY:
+      Serial.println("Opening Battery Screen...");
+      show_battery_screen();
+      break;
+    case SCREEN_VOLTAGE:
+      Serial.println("Opening Voltage Screen...");
+      show_voltage_screen();
+      break;
+    case SCREEN_TEMPERATURE:
+      Serial.println("Opening Temperature Screen...");
+      show_temperature_screen();
+      break;
+    case SCREEN_STATISTICS:
+      Serial.println("Opening Statistics Screen...");
+      show_statistics_screen();
+      break;
+    case SCREEN_SETTINGS:
+      Serial.println("Opening Settings Screen...");
+      show_settings_screen();
+      break;
+    case SCREEN_DASHBOARD:
+      Serial.println("Returning to Dashboard...");
+      create_ev_dashboard_ui();
+      break;
+    case SCREEN_DIAGNOSTICS:
+      Serial.println("Opening Diagnostics Screen...");
+      show_diagnostics_screen();
+      break;
+  }
+  
+  Serial.println("Screen switch complete");
+}
+
+static lv_obj_t *alert_toast = NULL;
+
+/* Message over whatever screen is up, removed after the given time */
+static void show_alert(const char *text, int32_t seconds) {
+  if(alert_toast) {
+    lv_obj_delete(alert_toast);
+  }
+  alert_toast = lv_label_create(lv_layer_top());
+  lv_label_set_text_static(alert_toast, text ? text : "");
+  lv_obj_set_style_bg_color(alert_toast, lv_color_hex(0xcc3300), 0);
+  lv_obj_set_style_bg_opa(alert_toast, LV_OPA_COVER, 0);
+  lv_obj_set_style_text_color(alert_toast, lv_color_white(), 0);
+  lv_obj_set_style_text_font(alert_toast, ui_font_px(16), 0);
+  lv_obj_set_style_pad_all(alert_toast, ui_px(8), 0);
+  lv_obj_set_style_radius(alert_toast, ui_px(6), 0);
+  lv_obj_align(alert_toast, LV_ALIGN_BOTTOM_MID, 0, -ui_px(60));
+  ui_bind_clear_on_delete(&alert_toast);
+  lv_obj_delete_delayed(alert_toast, (seconds > 0 ? seconds : 3) * 1000);
+}
+
+static lv_obj_t *alert_banner = NULL;
+static lv_obj_t *alert_banner_label = NULL;
+
+/* Strip across the top layer for the highest-priority active alert. It
+ * overlays whatever screen is up without touching it, and lets touches
+ * through. NULL text hides it. */
+static void show_banner(const char *text, int32_t arg) {
+  static const uint32_t colors[] = { 0x1565c0, 0xef6c00, 0xc62828 };  // Info, warning, critical
+
+  if(!text) {
+    if(alert_banner) lv_obj_add_flag(alert_banner, LV_OBJ_FLAG_HIDDEN);
+    return;
+  }
+
+  if(!alert_banner) {
+    alert_banner = lv_obj_create(lv_layer_top());
+    lv_obj_remove_style_all(alert_banner);
+    lv_obj_remove_flag(alert_banner, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_remove_flag(alert_banner, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(alert_banner, LV_PCT(100), ui_px(26));
+    lv_obj_align(alert_banner, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_bg_opa(alert_banner, LV_OPA_90, 0);
+
+    alert_banner_label = lv_label_create(alert_banner);
+    lv_obj_set_style_text_font(alert_banner_label, ui_font_px(16), 0);
+    lv_obj_set_style_text_color(alert_banner_label, lv_color_white(), 0);
+    lv_obj_center(alert_banner_label);
+  }
+
+  uint8_t priority = arg & 0xFF;
+  uint8_t others = arg >> 8;
+  lv_obj_set_style_bg_color(alert_banner, lv_color_hex(colors[priority <= ALERT_CRITICAL ? priority : ALERT_CRITICAL]), 0);
+  if(others) {
+    lv_label_set_text_fmt(alert_banner_label, LV_SYMBOL_WARNING " %s (+%u)", text, others);
+  } else {
+    lv_label_set_text_fmt(alert_banner_label, LV_SYMBOL_WARNING " %s", text);
+  }
+  lv_obj_remove_flag(alert_banner, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Without a TFT_BL pin this does nothing; setup says so once
+static void set_brightness(int32_t level) {
+  power_backlight_write(constrain(level, 0, 255));
+}
+
+/* Backlight, display refresh and touch poll for the current power state.
+ * Idle keeps polling touch often enough to wake within 50 ms. */
+static void power_apply_ui() {
+  bool idle = power.state == POWER_IDLE;
+  set_brightness(power_backlight(&power));
+  lv_timer_set_period(lv_display_get_refr_timer(disp), idle ? POWER_IDLE_REFR_MS : LV_DEF_REFR_PERIOD);
+  lv_timer_set_period(lv_indev_get_read_timer(touch_indev), idle ? POWER_IDLE_TOUCH_POLL_MS : LV_DEF_REFR_PERIOD);
+  if(!idle) lv_timer_ready(lv_display_get_refr_timer(disp));
+}
+
+static void ui_cmd_execute(const UiCmd *cmd) {
+  switch(cmd->type) {
+    case UI_CMD_SCREEN:
+      power_activity(&power, millis());
+      switch_screen(cmd->arg);
+      break;
+    case UI_CMD_BRIGHTNESS:
+      // The requested level applies while active; dim and idle scale from it
+      power_set_brightness(&power, constrain(cmd->arg, 0, 255));
+      power_activity(&power, millis());
+      set_brightness(power_backlight(&power));
+      break;
+    case UI_CMD_ALERT:      show_alert(cmd->text, cmd->arg); break;
+    case UI_CMD_BANNER:
+      power_activity(&power, millis());  // A new or cleared alert should be seen
+      show_banner(cmd->text, cmd->arg);
+      break;
+    default: break;
+  }
+}
+
 /* ===== INSTRUMENTED UI Task ===== */
 void uiTask(void *parameter) {
   Serial.println("UI Task started");
@@ -262,61 +550,21 @@ void uiTask(void *parameter) {
   unsigned long last_time_update = 0;
   
   while(1) {
+    uint32_t loop_start_us = micros();
+
     // Update LVGL tick
     unsigned long tickPeriod = millis() - lastTickMillis;
     lastTickMillis = millis();
     lv_tick_inc(tickPeriod);
     
     // Process LVGL events (callbacks execute here)
-    lv_timer_handler();
+    uint32_t next_timer_ms = lv_timer_handler();
     
-    // **NEW: Handle screen switching AFTER events are done**
-    if(pending_screen >= 0) {
-      int screen_id = pending_screen;
-      pending_screen = -1;  // Clear flag
-      
-      Serial.printf("UI Task: Switching to screen %d\n", screen_id);
-      
-      // Delete sidebar (now safe - event callback has returned)
-       if(sidebar) {
-        lv_obj_delete(sidebar);
-        sidebar = NULL;
-      }
-      if(overlay) {
-        lv_obj_delete(overlay);
-        overlay = NULL;
-      }
-      
-      // Switch screens
-      switch(screen_id) {
-        case 0:
-          Serial.println("Opening Battery Screen...");
-          show_battery_screen();
-          break;
-        case 1:
-          Serial.println("Opening Voltage Screen...");
-          show_voltage_screen();
-          break;
-        case 2:
-          Serial.println("Opening Temperature Screen...");
-          show_temperature_screen();
-          break;
-        case 3:
-          Serial.println("Opening Statistics Screen...");
-          show_statistics_screen();
-          break;
-        case 4:
-          Serial.println("Opening Settings Screen...");
-          show_settings_screen();
-          break;
-        case 5:
-          Serial.println("Returning to Dashboard...");
-          create_ev_dashboard_ui();
-          break;
-      }
-      
-      Serial.println("Screen switch complete");
-      
+    // Commands from other tasks and event callbacks, after events are done
+    UiCmd cmds[UI_CMD_QUEUE_LEN];
+    uint8_t ncmds = ui_cmd_queue_collect(&ui_cmds, cmds, UI_CMD_QUEUE_LEN);
+    for (uint8_t i = 0; i < ncmds; i++) {
+      ui_cmd_execute(&cmds[i]);
     }
     
     // Update time display
@@ -325,28 +573,46 @@ void uiTask(void *parameter) {
       last_time_update = millis();
     }
     
-    // Handle RS485 data updates
-    if(data_updated) {
-      data_updated = false;
+    // Handle RS485 data updates - publish only the fields that changed.
+    // Values are copied under dataMutex, widgets update after it is released.
+    if(dirty_fields) {
+      if(xSemaphoreTake(dataMutex, 10 / portTICK_PERIOD_MS)) {
+        uint32_t dirty = dirty_fields;
+        dirty_fields = 0;
+        int32_t values[DASH_FIELD_COUNT];
+        for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+          if (dirty & DASH_FIELD_BIT(f)) values[f] = field_display_value(f);
+        }
+        xSemaphoreGive(dataMutex);
+
+        for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+          if (dirty & DASH_FIELD_BIT(f)) ui_bind_publish(f, values[f]);
+        }
+        if(dirty & POWER_WAKE_FIELDS) power_activity(&power, millis());
+      }
+    }
+
+    // Cell arrays: a ~600-byte copy under the mutex, repaint after it
+    if(cells_dirty) {
       if(xSemaphoreTake(dataMutex, 10 / portTICK_PERIOD_MS)) {
-        update_ui_element(ID_SPEED);
-        update_ui_element(ID_RANGE);
-        update_ui_element(ID_CONSUMPTION);
-        update_ui_element(ID_TRIP);
-        update_ui_element(ID_ODOMETER);
-        update_ui_element(ID_AVG_SPEED);
-        update_ui_element(ID_TEMP);
-        update_ui_element(ID_AMBIENT_TEMP);
-        update_ui_element(ID_MODE);
-        update_ui_element(ID_ARMED);
-        update_ui_element(ID_SOC);
-        update_ui_element(ID_VOLTAGE);
-        update_ui_element(ID_CURRENT);
+        cells_dirty = false;
+        cell_store_sync(&ui_cells, &cells);
         xSemaphoreGive(dataMutex);
+
+        if(cell_map) cell_view_refresh(cell_map);
+        else cell_store_clear_dirty(&ui_cells);
       }
     }
+
+    // Power state follows activity; a touch wake-up is timed up to here
+    if(power_update(&power, millis())) {
+      power_apply_ui();
+      power_wake_done(&power, micros());
+    }
     
-    vTaskDelay(5 / portTICK_PERIOD_MS);
+    // Sleep until LVGL's next timer is due or a telemetry task has new data
+    uint32_t wait_ms = power_loop_wait(&power, next_timer_ms, micros() - loop_start_us);
+    xSemaphoreTake(ui_wake, pdMS_TO_TICKS(wait_ms));
   }
 }
 
@@ -395,1163 +661,784 @@ bool load_image_to_ram(const char *path) {
   return true;
 }
 
-/* Update time display */
+/* Update time display - only touches the label when the shown minute changes */
 void update_time_display() {
 
   if(!time_label) {
     return;
   }
 
+  uint32_t now = millis();
+  time_source_poll(now);
 
-  unsigned long now = millis() / 1000;
-  int hours = (now / 3600) % 24;
-  int minutes = (now / 60) % 60;
+  int32_t seconds = time_source_seconds_of_day(now);
+  int minute = seconds < 0 ? -2 : seconds / 60;
+  if(minute == time_shown_minute) {
+    return;
+  }
+  time_shown_minute = minute;
 
   char time_str[16];
-  snprintf(time_str, sizeof(time_str), "%d:%02d AM", hours == 0 ? 12 : hours, minutes);
+  format_time_of_day(time_str, sizeof(time_str), seconds, CLOCK_24H);
   lv_label_set_text(time_label, time_str);
 }
 
-/* Update specific UI element based on ID */
-void update_ui_element(uint8_t id) {
-  char buf[32];
-  
-  switch(id) {
-    case ID_SPEED:
-      snprintf(buf, sizeof(buf), "%d", dashData.speed);
-      lv_label_set_text(speed_label, buf);
-      break;
-      
-    case ID_RANGE:
-      snprintf(buf, sizeof(buf), "Range %d km", dashData.range);
-      lv_label_set_text(range_label, buf);
-      break;
-      
-    case ID_CONSUMPTION:
-      snprintf(buf, sizeof(buf), "Avg. %d W/km", dashData.avg_wkm);
-      lv_label_set_text(avg_wkm_label, buf);
-      break;
-      
-    case ID_TRIP:
-      snprintf(buf, sizeof(buf), "TRIP %d km", dashData.trip);
-      lv_label_set_text(trip_label, buf);
-      break;
-      
-    case ID_ODOMETER:
-      snprintf(buf, sizeof(buf), "ODO %d km", dashData.odo);
-      lv_label_set_text(odo_label, buf);
-      break;
-      
-    case ID_AVG_SPEED:
-      snprintf(buf, sizeof(buf), "AVG. %d km/h", dashData.avg_kmh);
-      lv_label_set_text(avg_kmh_label, buf);
-      break;
-      
-    case ID_TEMP:
-      snprintf(buf, sizeof(buf), "Battery %d°C", dashData.battery_temp);
-      lv_label_set_text(battery_temp_label, buf);
-      break;
-      
-    case ID_AMBIENT_TEMP:
-      snprintf(buf, sizeof(buf), "Motor %d°C", dashData.motor_temp);
-      lv_label_set_text(motor_temp_label, buf);
-      break;
-      
-    case ID_MODE:
-      lv_label_set_text(mode_label, dashData.mode.c_str());
-      // Update color based on mode
-      if (dashData.mode == "Eco") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
-      } else if (dashData.mode == "City") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0x0088ff), 0);
-      } else if (dashData.mode == "Sport") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0xff0000), 0);
-      }
-      break;
-      
-    case ID_ARMED:
-      lv_label_set_text(status_label, dashData.status.c_str());
-      break;
-
-      case ID_SOC:
-      snprintf(buf, sizeof(buf), "SoC: %d%%", dashData.soc);
-      lv_label_set_text(soc, buf);
-      break;
-
-    case ID_VOLTAGE:
-      snprintf(buf, sizeof(buf), "Volt: %.2f V", dashData.voltage);
-      lv_label_set_text(voltage, buf);
-      break;
+void time_display_attach(lv_obj_t *label) {
+  time_label = label;
+  ui_bind_clear_on_delete(&time_label);
+  time_shown_minute = -1;  // New label, always set it once
+  update_time_display();
+}
 
-    case ID_CURRENT:
-      snprintf(buf, sizeof(buf), "Curr: %.2f A", dashData.current);
-      lv_label_set_text(current, buf);
-      break;
+/* dashData value of a field in ui_bind display units. Call with dataMutex held. */
+int32_t field_display_value(uint8_t field) {
+  switch(field) {
+    case FIELD_SOC:          return dashData.soc;
+    case FIELD_VOLTAGE:      return (int32_t)lroundf(dashData.voltage * 100);
+    case FIELD_CURRENT:      return (int32_t)lroundf(dashData.current * 100);
+    case FIELD_BATTERY_TEMP: return dashData.battery_temp;
+    case FIELD_SPEED:        return dashData.speed;
+    case FIELD_MODE:         return dashData.mode;
+    case FIELD_ARMED:        return dashData.armed;
+    case FIELD_RANGE:        return dashData.range;
+    case FIELD_CONSUMPTION:  return dashData.avg_wkm;
+    case FIELD_AMBIENT_TEMP: return dashData.motor_temp;
+    case FIELD_TRIP:         return dashData.trip;
+    case FIELD_ODOMETER:     return dashData.odo;
+    case FIELD_AVG_SPEED:    return dashData.avg_kmh;
   }
+  return derived_value(&derived, field);
 }
 
-void toggle_sidebar() {
-    Serial.println("Toggle sidebar called");
-    if(sidebar_open) {
-        Serial.println("Closing sidebar");
-        close_sidebar();
-        sidebar_open = false;
-    } else {
-        Serial.println("Opening sidebar");
-        show_sidebar();
-        sidebar_open = true;
-    }
+/* Grey out values that stopped arriving, and the derived values computed from
+ * them. Runs from an LVGL timer a few times per second; widgets bound to the
+ * fields whose stale state flipped update. */
+static void staleness_timer_cb(lv_timer_t *t) {
+  uint32_t rx_ms[FIELD_COUNT];
+  if(!xSemaphoreTake(dataMutex, 0)) {
+    return;  // Try again next tick
+  }
+  memcpy(rx_ms, dashData.rx_ms, sizeof(rx_ms));
+  xSemaphoreGive(dataMutex);
+
+  ui_bind_publish_stale(derived_stale_fields(link_stale_fields(rx_ms, millis())));
 }
 
-void show_sidebar() {
-    if(!sidebar) {
-        // Create sidebar container
-        sidebar = lv_obj_create(lv_scr_act());
-        lv_obj_set_size(sidebar, 220, TFT_VER_RES);  // Use TFT_VER_RES instead of LV_VER_RES
-        lv_obj_align(sidebar, LV_ALIGN_LEFT_MID, -220, 0);
-        lv_obj_set_style_bg_color(sidebar, lv_color_hex(0x2C3E50), 0);
-        lv_obj_set_style_bg_opa(sidebar, LV_OPA_COVER, 0);
-        lv_obj_set_style_pad_all(sidebar, 10, 0);
-        
-        // Add title
-        lv_obj_t *title = lv_label_create(sidebar);
-        lv_label_set_text(title, "VEHICLE INFO");
-        lv_obj_set_style_text_color(title, lv_color_white(), 0);
-        lv_obj_set_style_text_font(title, &lv_font_montserrat_18, 0);
-        lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 5);
-        
-        // Menu items with icons
-        const char* menu_items[] = {
-            LV_SYMBOL_BATTERY_FULL " Battery",
-            LV_SYMBOL_CHARGE " Voltage",
-            LV_SYMBOL_WARNING " Temperature",
-            // LV_SYMBOL_LIST " Statistics",
-            // LV_SYMBOL_SETTINGS " Settings",
-            // LV_SYMBOL_HOME " Dashboard"
-        };
-        
-        for(int i = 0; i < 3; i++) {
-            lv_obj_t *btn = lv_btn_create(sidebar);
-            lv_obj_set_width(btn, 200);
-            lv_obj_set_height(btn, 45);
-            lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, 40 + i * 50);
-            lv_obj_set_style_bg_color(btn, lv_color_hex(0x34495E), 0);
-            lv_obj_set_style_radius(btn, 8, 0);
-            
-            lv_obj_set_style_bg_color(btn, lv_color_hex(0x4A6278), LV_STATE_PRESSED);
-            
-            lv_obj_t *label = lv_label_create(btn);
-            lv_label_set_text(label, menu_items[i]);
-            lv_obj_set_style_text_color(label, lv_color_white(), 0);
-            lv_obj_align(label, LV_ALIGN_LEFT_MID, 10, 0);
-            
-            lv_obj_add_event_cb(btn, option_cb, LV_EVENT_CLICKED, (void*)(uintptr_t)i);
-        }
-        
-        // Create overlay
-        overlay = lv_obj_create(lv_scr_act());
-        lv_obj_remove_style_all(overlay);
-        lv_obj_set_size(overlay, TFT_HOR_RES, TFT_VER_RES);  // Use TFT_HOR_RES and TFT_VER_RES
-        lv_obj_set_pos(overlay, 220, 0); 
-        lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
-        lv_obj_set_style_bg_opa(overlay, LV_OPA_0, 0);
-        lv_obj_add_event_cb(overlay, overlay_event_cb, LV_EVENT_CLICKED, NULL);
-    }
-    
-    // Show sidebar with animation
-    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_clear_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
-    
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, sidebar);
-    lv_anim_set_values(&a, -220, 0);
-    lv_anim_set_time(&a, 300);
-    lv_anim_set_exec_cb(&a, [](void* var, int32_t v) {
-        lv_obj_set_x((lv_obj_t*)var, v);
-    });
-    lv_anim_start(&a);
+/* Heap watch. The dashboard runs for weeks, so fragmentation is reported as
+ * it builds up instead of showing as a failed allocation much later. */
+#define MEM_WATCH_PERIOD_MS 10000
+
+static void mem_watch_timer_cb(lv_timer_t *t) {
+  uint8_t raised = ui_alloc_check();
+  if(!raised) {
+    return;
+  }
+  UiAllocStats s;
+  ui_alloc_stats(&s);
+  Serial.printf("ERROR: [MEM] Alarm 0x%02X: %lu B free, largest block %lu B (lowest %lu B), %u%% frag, "
+                "%lu pool fallbacks, %lu pinned arenas\n", raised, s.heap_free, s.heap_largest,
+                s.heap_largest_min, s.heap_frag_pct, s.pool_fallbacks, s.arena_pinned);
+  if(raised & UI_ALARM_HEAP_BLOCK) show_alert("Low memory", 5);
 }
 
-void close_sidebar() {
-    if(sidebar) {
-        lv_anim_t a;
-        lv_anim_init(&a);
-        lv_anim_set_var(&a, sidebar);
-        lv_anim_set_values(&a, lv_obj_get_x(sidebar), -200);
-        lv_anim_set_time(&a, 300);
-        lv_anim_set_exec_cb(&a, [](void* var, int32_t v) {
-            lv_obj_set_x((lv_obj_t*)var, v);
-        });
-        lv_anim_set_ready_cb(&a, [](lv_anim_t* a) {
-            lv_obj_add_flag((lv_obj_t*)a->var, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
-        });
-        lv_anim_start(&a);
-    }
+/* Hand the current top alert to uiTask. Returns false if the queue was full. */
+static bool post_alert_banner() {
+  const AlertRule *top = alert_engine_top(&alerts);
+  if (!top) {
+    Serial.println("[ALERT] All clear");
+    return ui_cmd_post(UI_CMD_BANNER, 0, NULL);
+  }
+  Serial.printf("[ALERT] %s (%u active)\n", top->text, alerts.active_count);
+  return ui_cmd_post(UI_CMD_BANNER, top->priority | (alerts.active_count - 1) << 8, top->text);
 }
 
-void overlay_event_cb(lv_event_t *e) {
-    if(lv_event_get_code(e) == LV_EVENT_CLICKED) {  // Use the getter function
-        close_sidebar();
-        sidebar_open = false;
+/* Route one batch from any transport into the shared state. One lock per
+ * batch; the frames are already validated and decoded. Returns true if the UI
+ * has something new to show. */
+static bool ingest_batch(TelemetryTransport *t) {
+  TelemetryBatch *batch = &t->batch;
+  bool wake_ui = false;
+  uint32_t now = millis();
+
+  if(!xSemaphoreTake(dataMutex, portMAX_DELAY)) {
+    return false;
+  }
+  for (uint8_t k = 0; k < batch->count; k++) {
+    TelemetryFrame &frame = batch->frame[k];
+
+    // Record the wire bytes (the lock keeps the SD ring single-producer);
+    // transports without framing get a frame built for them
+    if (batch->raw[k]) {
+      sd_log_frame(batch->raw[k], batch->raw_len[k], now);
+    } else if (sdLog.active) {
+      uint8_t wire[TRANSPORT_LOG_FRAME_LEN];
+      uint16_t len = telemetry_encode_frame(wire, sizeof(wire), &frame, &batch->hdr[k]);
+      if (len) sd_log_frame(wire, len, now);
     }
-}
 
-// static void option_cb(lv_event_t *e) {
-//     uint32_t id = (uint32_t)(uintptr_t)lv_event_get_user_data(e);
-    
-//     // Close sidebar with callback
-//     close_sidebar();
-//     sidebar_open = false;
-    
-//     // **CRITICAL: Wait for animation, THEN switch screen**
-//     // Store the target screen ID
-//     static uint32_t pending_screen = 0;
-//     pending_screen = id;
-    
-//     // Create a timer to switch screen after animation completes
-//     lv_timer_t *timer = lv_timer_create([](lv_timer_t *t) {
-//         uint32_t screen_id = (uint32_t)(uintptr_t)t->user_data;
-        
-//         switch(screen_id) {
-//             case 0:
-//                 Serial.println("Opening Battery Screen...");
-//                 show_battery_screen();
-//                 break;
-//             case 1:
-//                 Serial.println("Opening Voltage Screen...");
-//                 show_voltage_screen();
-//                 break;
-//             case 2:
-//                 Serial.println("Opening Temperature Screen...");
-//                 show_temperature_screen();
-//                 break;
-//             case 3:
-//                 Serial.println("Opening Statistics Screen...");
-//                 show_statistics_screen();
-//                 break;
-//             case 4:
-//                 Serial.println("Opening Settings Screen...");
-//                 show_settings_screen();
-//                 break;
-//             case 5:
-//                 Serial.println("Returning to Dashboard...");
-//                 create_ev_dashboard_ui();
-//                 break;
-//         }
-        
-//         lv_timer_delete(t);  // Delete the timer after running once
-//     }, 350, (void*)(uintptr_t)id);  // 350ms = 300ms animation + 50ms buffer
-    
-//     lv_timer_set_repeat_count(timer, 1);  // Run only once
-// }
+    if (frame.has_time) {
+      time_source_set_from_bus(frame.time_of_day, now);
+    }
 
+    // Unknown nodes and message types are only counted: housekeeping reports them
+    NodeRoute *route = telemetry_route_frame(&batch->hdr[k], &frame, now);
+    if (!route) continue;
+
+    // Flag only the fields this node drives that actually changed
+    frame.present &= route->dash_fields;
+    uint32_t changed = apply_telemetry(&frame);
+
+    // Power, energy and averages integrate over real arrival times
+    DerivedInputs inputs = {
+      dashData.voltage, dashData.current, dashData.speed_kmh,
+      dashData.soc, dashData.range, dashData.avg_wkm
+    };
+    changed |= derived_update(&derived, now, &inputs);
+    dirty_fields |= changed;
+    if (changed) wake_ui = true;
+    if (alert_engine_update(&alerts, changed, field_display_value, now)) {
+      banner_dirty = true;
+    }
+    // Deltas only carry what changed since the previous frame: after a gap,
+    // the node's fields no frame has carried since may have changed unseen.
+    // They show as stale until they arrive again or a keyframe resyncs them.
+    bool resyncing = route->state.seq.awaiting_keyframe;
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+      if (frame.present & FIELD_BIT(f)) dashData.rx_ms[f] = now;
+      else if (resyncing && (route->dash_fields & FIELD_BIT(f))) dashData.rx_ms[f] = 0;
+    }
+    link_health_frame_ok(frame.present, now);
 
-static void option_cb(lv_event_t *e) {
-    uint32_t id = (uint32_t)(uintptr_t)lv_event_get_user_data(e);
-    
-    // ONLY hide, set flag, and return
-    if(sidebar) {
-        lv_obj_add_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+    for (uint8_t b = 0; b < frame.block_count; b++) {
+      if (cell_store_apply_block(&cells, &frame.blocks[b])) cells_dirty = wake_ui = true;
     }
-    if(overlay) {
-        lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+
+    if (route->state.seq.gap) {
+      Serial.printf("[%s] %s: sequence gap before #%u, %lu frame(s) lost total%s\n",
+                    t->name, route->name, frame.seq, route->state.seq.lost_frames,
+                    resyncing ? " - waiting for keyframe" : "");
     }
-    
-    sidebar_open = false;
-    pending_screen = id;  // Let UI task handle it
-    
-    // DON'T call show_battery_screen() here!
+  }
+  xSemaphoreGive(dataMutex);
+  return wake_ui;
 }
 
-// static void option_cb(lv_event_t *e) {
-//     uint32_t id = (uint32_t)(uintptr_t)lv_event_get_user_data(e);
-    
-//     Serial.printf("Screen button %d pressed\n", id);
-    
-//     // **Use async delete - LVGL deletes it AFTER event finishes**
-//     if(sidebar) {
-//         lv_obj_delete_async(sidebar);  // ← Safe!
-//         sidebar = NULL;
-//     }
-//     if(overlay) {
-//         lv_obj_delete_async(overlay);  // ← Safe!
-//         overlay = NULL;
-//     }
-//     sidebar_open = false;
-    
-//     // Now safe to switch screens
-//     switch(id) {
-//         case 0:
-//             Serial.println("Opening Battery Screen...");
-//             show_battery_screen();
-//             break;
-//         case 1:
-//             Serial.println("Opening Voltage Screen...");
-//             show_voltage_screen();
-//             break;
-//         case 2:
-//             Serial.println("Opening Temperature Screen...");
-//             show_temperature_screen();
-//             break;
-//         case 3:
-//             Serial.println("Opening Statistics Screen...");
-//             show_statistics_screen();
-//             break;
-//         case 4:
-//             Serial.println("Opening Settings Screen...");
-//             show_settings_screen();
-//             break;
-//         case 5:
-//             Serial.println("Returning to Dashboard...");
-//             create_ev_dashboard_ui();
-//             break;
-//     }
-// }
+#define DROP_REPORT_MS 1000   // Dropped frames are summed up at most this often
 
-/* Create EV Dashboard UI */
-void create_ev_dashboard_ui() {
-  Serial.println("Creating EV dashboard UI...");
+static uint32_t drops_reported = 0;     // telemetry_unrouted_frames() at the last report
+static uint32_t drops_report_ms = 0;
 
-  lv_obj_t *scr = lv_scr_act();
-  lv_obj_clean(scr);
-  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
-
-  /* Top bar */
-  lv_obj_t *top_bar = lv_obj_create(scr);
-  lv_obj_set_size(top_bar, TFT_HOR_RES, 45);
-  lv_obj_align(top_bar, LV_ALIGN_TOP_MID, 0, 0);
-  lv_obj_set_style_bg_color(top_bar, lv_color_white(), 0);
-  lv_obj_set_style_border_width(top_bar, 0, 0);
-  lv_obj_set_style_radius(top_bar, 0, 0);
-  lv_obj_set_style_pad_all(top_bar, 0, 0);
-
-  // Create menu button
-  menu_btn = lv_btn_create(top_bar);
-  lv_obj_set_size(menu_btn, 50, 45);
-  lv_obj_align(menu_btn, LV_ALIGN_LEFT_MID, 0, 0);
-  lv_obj_add_flag(menu_btn, LV_OBJ_FLAG_CLICKABLE);
-  lv_obj_clear_flag(menu_btn, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
-  lv_obj_set_style_bg_color(menu_btn, lv_color_hex(0x333333), 0);
-
-  // Create menu symbol
-  lv_obj_t *menu_label = lv_label_create(menu_btn);
-  lv_label_set_text(menu_label, LV_SYMBOL_BARS);
-  lv_obj_set_style_text_font(menu_label, &lv_font_montserrat_20, 0);
-  lv_obj_center(menu_label);
-
-  // Add event handler - Simplified version
-  lv_obj_add_event_cb(menu_btn, [](lv_event_t *e) {
-      Serial.println("Menu button event received");
-      if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-          Serial.println("Menu button clicked!");
-          toggle_sidebar();
+/* Timers that run without new data: link rate, debounced alerts, node
+ * staleness, dropped frames. Every transport task calls it; dataMutex keeps
+ * them in turn. */
+static bool telemetry_housekeeping(const char *name) {
+  bool wake_ui = false;
+  if(!xSemaphoreTake(dataMutex, portMAX_DELAY)) {
+    return false;
+  }
+  uint32_t now = millis();
+  link_health_tick(now);
+
+  // Read under the lock, printed after it
+  uint32_t dropped = 0, drops_total = 0;
+  if (now - drops_report_ms >= DROP_REPORT_MS) {
+    drops_total = telemetry_unrouted_frames();
+    if (drops_total < drops_reported) drops_reported = 0;   // Routes were reset
+    dropped = drops_total - drops_reported;
+    drops_reported = drops_total;
+    drops_report_ms = now;
+  }
+
+  // Debounced alerts come due without a new value; the banner is re-posted
+  // until the UI queue has room for it
+  if (alert_engine_tick(&alerts, now)) banner_dirty = true;
+  if (banner_dirty) {
+    banner_dirty = !post_alert_banner();
+    wake_ui = true;
+  }
+
+  // Per-node staleness - a handful of timestamp compares
+  if (telemetry_check_staleness(now)) {
+    uint8_t count;
+    NodeRoute *routes = telemetry_routes(&count);
+    for (uint8_t r = 0; r < count; r++) {
+      if (routes[r].state.seen) {
+        Serial.printf("[%s] %s: %s\n", name, routes[r].name, routes[r].state.stale ? "STALE" : "fresh");
       }
-  }, LV_EVENT_CLICKED, NULL);
-  
-  time_label = lv_label_create(top_bar);
-  // lv_label_set_text(time_label, "9:41 AM");
-  lv_obj_set_style_text_color(time_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(time_label, &lv_font_montserrat_18, 0);
-  lv_obj_align(time_label, LV_ALIGN_CENTER, 0, 0);
-  update_time_display();
+    }
+  }
+  xSemaphoreGive(dataMutex);
 
-  // TEMPORARY TEST: Click anywhere on screen
-  lv_obj_add_event_cb(scr, [](lv_event_t *e) {
-  if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-    Serial.println("[TEST] Screen clicked!");
+  if (dropped) {
+    // Counted across all transports, so not tagged with this one
+    Serial.printf("[Telemetry] %lu frame(s) from unknown nodes or of unknown types dropped, %lu total\n",
+                  dropped, drops_total);
   }
-  }, LV_EVENT_CLICKED, NULL);
-  
-  // lv_obj_t *menu_btn = lv_label_create(top_bar);
-  // lv_label_set_text(menu_btn, "Menu");
-  // lv_obj_set_style_text_font(menu_btn, &lv_font_montserrat_16, 0);
-  // lv_obj_align(menu_btn, LV_ALIGN_LEFT_MID, 10, 0);
-
-  lv_obj_t *map_btn = lv_label_create(top_bar);
-  lv_label_set_text(map_btn, "Map");
-  lv_obj_set_style_text_font(map_btn, &lv_font_montserrat_16, 0);
-  lv_obj_align(map_btn, LV_ALIGN_RIGHT_MID, -10, 0);
-
-  /* Status badge */
-  lv_obj_t *status_badge = lv_obj_create(scr);
-  lv_obj_set_size(status_badge, 140, 49);
-  lv_obj_align(status_badge, LV_ALIGN_TOP_MID, 0, 60);
-  lv_obj_set_style_bg_color(status_badge, lv_color_hex(0x333333), 0);
-  lv_obj_set_style_radius(status_badge, 20, 0);
-  lv_obj_set_style_border_width(status_badge, 0, 0);
-
-  status_label = lv_label_create(status_badge);
-  lv_label_set_text(status_label, dashData.status.c_str());
-  lv_obj_set_style_text_color(status_label, lv_color_white(), 0);
-  lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
-  lv_obj_center(status_label);
-
-  /* Main speed display */
-  speed_label = lv_label_create(scr);
-  char buf[32];
-  snprintf(buf, sizeof(buf), "%d", dashData.speed);
-  lv_label_set_text(speed_label, buf);
-  lv_obj_set_style_text_color(speed_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(speed_label, &lv_font_montserrat_48, 0);
-  lv_obj_align(speed_label, LV_ALIGN_CENTER, 0, -20);
-
-  lv_obj_t *kmh_label = lv_label_create(scr);
-  lv_label_set_text(kmh_label, "Km/h");
-  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(kmh_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(kmh_label, LV_ALIGN_CENTER, 0, 20);
-
-  /* Mode selector */
-  lv_obj_t *mode_container = lv_obj_create(scr);
-  lv_obj_set_size(mode_container, 200, 90);
-  lv_obj_align(mode_container, LV_ALIGN_CENTER, 0, 80);
-  lv_obj_set_style_bg_color(mode_container, lv_color_white(), 0);
-  lv_obj_set_style_radius(mode_container, 10, 0);
-  lv_obj_set_style_border_width(mode_container, 0, 0);
-
-  lv_obj_t *mode_text = lv_label_create(mode_container);
-  lv_label_set_text(mode_text, "Mode");
-  lv_obj_set_style_text_color(mode_text, lv_color_black(), 0);
-  lv_obj_set_style_text_font(mode_text, &lv_font_montserrat_16, 0);
-  lv_obj_align(mode_text, LV_ALIGN_TOP_MID, 0, 3);
-
-  mode_label = lv_label_create(mode_container);
-  lv_label_set_text(mode_label, dashData.mode.c_str());
-  lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
-  lv_obj_set_style_text_font(mode_label, &lv_font_montserrat_20, 0);
-  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, 15);
-
-  /* Left side info */
-  range_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Range: %d km", dashData.range);
-  lv_label_set_text(range_label, buf);
-  lv_obj_set_style_text_color(range_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(range_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(range_label, LV_ALIGN_LEFT_MID, 10, -60);
-
-  avg_wkm_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Avg. con: %d W/km", dashData.avg_wkm);
-  lv_label_set_text(avg_wkm_label, buf);
-  lv_obj_set_style_text_color(avg_wkm_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_wkm_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(avg_wkm_label, LV_ALIGN_LEFT_MID, 10, -20);
-
-  voltage = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Volt: %.2f V", dashData.voltage);
-  lv_label_set_text(voltage, buf);
-  lv_obj_set_style_text_color(voltage, lv_color_black(), 0);
-  lv_obj_set_style_text_font(voltage, &lv_font_montserrat_16, 0);
-  lv_obj_align(voltage, LV_ALIGN_LEFT_MID, 10, 60);
-
-  current = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Current: %.2f A", dashData.current); 
-  lv_label_set_text(current, buf);
-  lv_obj_set_style_text_color(current, lv_color_black(), 0);
-  lv_obj_set_style_text_font(current, &lv_font_montserrat_16, 0);
-  lv_obj_align(current, LV_ALIGN_LEFT_MID, 10, 90);
-
-  /* Right side info */
-  motor_temp_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Motor: %d°C", dashData.motor_temp);
-  lv_label_set_text(motor_temp_label, buf);
-  lv_obj_set_style_text_color(motor_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(motor_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(motor_temp_label, LV_ALIGN_RIGHT_MID, -10, -60);
-
-  battery_temp_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Battery: %d°C", dashData.battery_temp);
-  lv_label_set_text(battery_temp_label, buf);
-  lv_obj_set_style_text_color(battery_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(battery_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(battery_temp_label, LV_ALIGN_RIGHT_MID, -10, -20);
-
-  soc =lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "SoC: %d%%", dashData.soc);
-  lv_label_set_text(soc, buf);
-  lv_obj_set_style_text_color(soc, lv_color_black(), 0);
-  lv_obj_set_style_text_font(soc, &lv_font_montserrat_16, 0);
-  lv_obj_align(soc, LV_ALIGN_RIGHT_MID, -10, 60);
-
-  /* Bottom bar */
-  lv_obj_t *bottom_bar = lv_obj_create(scr);
-  lv_obj_set_size(bottom_bar, TFT_HOR_RES, 50);
-  lv_obj_align(bottom_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-  lv_obj_set_style_bg_color(bottom_bar, lv_color_white(), 0);
-  lv_obj_set_style_border_width(bottom_bar, 0, 0);
-  lv_obj_set_style_radius(bottom_bar, 0, 0);
-
-  trip_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "TRIP: %d km", dashData.trip);
-  lv_label_set_text(trip_label, buf);
-  lv_obj_set_style_text_color(trip_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(trip_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(trip_label, LV_ALIGN_LEFT_MID, 5, 0);
-
-  odo_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "ODO: %d km", dashData.odo);
-  lv_label_set_text(odo_label, buf);
-  lv_obj_set_style_text_color(odo_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(odo_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(odo_label, LV_ALIGN_CENTER, 0, 0);
-
-  avg_kmh_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "Avg. SPEED: %d km/h", dashData.avg_kmh);
-  lv_label_set_text(avg_kmh_label, buf);
-  lv_obj_set_style_text_color(avg_kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_kmh_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(avg_kmh_label, LV_ALIGN_RIGHT_MID, -2, 0);
-
-  Serial.println("EV dashboard UI created!");
+  return wake_ui;
 }
 
-void clear_dashboard_pointers() {
-    speed_label = NULL;
-    range_label = NULL;
-    avg_wkm_label = NULL;
-    trip_label = NULL;
-    odo_label = NULL;
-    avg_kmh_label = NULL;
-    motor_temp_label = NULL;
-    battery_temp_label = NULL;
-    mode_label = NULL;
-    status_label = NULL;
-    soc = NULL;
-    voltage = NULL;
-    current = NULL;
-    time_label = NULL;
-    menu_btn = NULL;
-}
+// Telemetry task, one per started transport - runs on Core 0
+void telemetryTask(void *parameter) {
+  TelemetryTransport *t = (TelemetryTransport *)parameter;
+  Serial.printf("[%s Task] Started on Core 0\n", t->name);
+  t->last_rx_ms = millis();
+  power_bus_active(true);
 
-// RS485 Task - runs on Core 0
-void rs485Task(void *parameter) {
-  Serial.println("[RS485 Task] Started on Core 0");
-  
   while(1) {
-    // Read available bytes from Serial1
-    while (Serial1.available()) {
-      if (bufferPos < sizeof(serialBuffer)) {
-        serialBuffer[bufferPos++] = Serial1.read();
-      } else {
-        memmove(serialBuffer, serialBuffer+1, sizeof(serialBuffer)-1);
-        bufferPos--;
-        serialBuffer[bufferPos++] = Serial1.read();
-      }
+    bool wake_ui = false;
+    if (t->receive(t, TRANSPORT_WAIT_MS)) wake_ui = ingest_batch(t);
+
+    // A silent bus is polled slowly and may let the chip light-sleep
+    if (t->quiet != (millis() - t->last_rx_ms > POWER_BUS_QUIET_MS)) {
+      t->quiet = !t->quiet;
+      power_bus_active(!t->quiet);
+      Serial.printf("[%s] Bus %s\n", t->name, t->quiet ? "quiet" : "active");
     }
-    
-    // Process complete frames
-    bool frameFound = true; 
-    while (frameFound && bufferPos >= 6) {
-      frameFound = false;
-      
-      for (uint16_t i = 0; i < bufferPos-1; i++) {
-        if (serialBuffer[i] == STX1 && serialBuffer[i+1] == STX2) {
-          if (i+3 >= bufferPos) break;
-          
-          uint16_t declaredLength = (serialBuffer[i+2] << 8) | serialBuffer[i+3];
-          uint16_t frameLength = declaredLength + 6;
-          
-          if (i + frameLength <= bufferPos) {
-            if (validateFrame(&serialBuffer[i], frameLength)) {
-              Serial.println("\n[RS485] Valid frame received");
-              
-              uint8_t infoEnd = i + 4 + declaredLength - 5;
-              
-              // Lock mutex before updating shared data
-              if(xSemaphoreTake(dataMutex, portMAX_DELAY)) {
-                
-                // Parse all data fields
-                for (uint8_t j = i+11; j < infoEnd;) {
-                  uint8_t id = serialBuffer[j++];
-                  
-                  switch (id) {
-                    case ID_SOC:
-                      dashData.soc = serialBuffer[j++];
-                      break;
-                      
-                    case ID_VOLTAGE: {
-                      uint16_t v = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.voltage = v * 0.01f;
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_CURRENT: {
-                      uint16_t c = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.current = (c & 0x8000) ? -(c & 0x7FFF) * 0.01f : c * 0.01f;
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_TEMP: {
-                      uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.battery_temp = (int)(t * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_SPEED: {
-                      uint16_t s = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.speed = (int)(s * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_MODE: {
-                      uint8_t m = serialBuffer[j++];
-                      if (m == MODE_ECO) dashData.mode = "Eco";
-                      else if (m == MODE_CITY) dashData.mode = "City";
-                      else if (m == MODE_SPORT) dashData.mode = "Sport";
-                      break;
-                    }
-                    
-                    case ID_ARMED: {
-                      uint8_t a = serialBuffer[j++];
-                      dashData.status = a ? "ARMED" : "DISARMED";
-                      break;
-                    }
-                    
-                    case ID_RANGE: {
-                      uint16_t r = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.range = (int)(r * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_CONSUMPTION: {
-                      uint16_t c = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.avg_wkm = (int)(c * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_AMBIENT_TEMP: {
-                      uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.motor_temp = (int)(t * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_TRIP: {
-                      uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.trip = (int)(t * 0.1f);
-                      j += 2;
-                      break;
-                    }
-                    
-                    case ID_ODOMETER: {
-                      uint32_t o = (serialBuffer[j] << 24) | (serialBuffer[j+1] << 16) | 
-                                  (serialBuffer[j+2] << 8) | serialBuffer[j+3];
-                      dashData.odo = (int)(o * 0.1f);
-                      j += 4;
-                      break;
-                    }
-                    
-                    case ID_AVG_SPEED: {
-                      uint16_t as = (serialBuffer[j] << 8) | serialBuffer[j+1];
-                      dashData.avg_kmh = (int)(as * 0.1f);
-                      j += 2;
-                      break;
-                    }
-
-                    default:
-                      if (id == ID_ODOMETER) j += 4;
-                      else if (id >= 0x80 && id <= 0x8F) j += 2;
-                      else j++;
-                      break;
-                  }
-                }
-                
-                // Set flag to update UI
-                data_updated = true;
-                
-                xSemaphoreGive(dataMutex);
-              }
-              
-              Serial.println("[RS485] Data updated");
-              
-              // Remove processed frame
-              memmove(serialBuffer, &serialBuffer[i + frameLength], 
-                      bufferPos - (i + frameLength));
-              bufferPos -= (i + frameLength);
-              frameFound = true;
-              break;
-            } else {
-              i++; 
-            }
-          } else {
-            break;
-          }
-        }
-      }
-      
-      if (!frameFound && bufferPos > 200) {
-        Serial.println("[WARNING] Buffer full, clearing");
-        bufferPos = 0;
-      }
+
+    if (telemetry_housekeeping(t->name)) wake_ui = true;
+    if (wake_ui) xSemaphoreGive(ui_wake);
+  }
+}
+
+static const char *field_short_names[FIELD_COUNT] = {
+  "SoC", "Volt", "Curr", "BatT", "Spd", "Mode", "Arm",
+  "Rng", "Cons", "MotT", "Trip", "Odo", "AvgS"
+};
+
+#define PERF_PERIOD_MS 500  // 2 Hz refresh of the diagnostics text
+
+static lv_obj_t *diag_perf_label = NULL;
+static lv_obj_t *diag_mem_label = NULL;
+static lv_obj_t *diag_link_label = NULL;
+static lv_obj_t *diag_nodes_label = NULL;
+static lv_obj_t *diag_fields_label = NULL;
+static lv_obj_t *diag_power_label = NULL;
+static lv_obj_t *diag_bus_label = NULL;
+static lv_obj_t *hud_label = NULL;
+static lv_timer_t *perf_timer = NULL;
+
+static uint32_t perf_window_ms = 0;
+static uint32_t idle_calls_prev[2] = {0, 0};
+static uint32_t power_loops_prev = 0;
+static uint32_t power_busy_prev = 0;
+static SpiBusStats spi_prev = {};
+static uint32_t sd_bytes_prev = 0;
+
+static void power_loop_totals(uint32_t *loops, uint32_t *busy_us) {
+  *loops = 0;
+  *busy_us = 0;
+  for(int s = 0; s < POWER_STATE_COUNT; s++) {
+    *loops += power.stats.loops[s];
+    *busy_us += power.stats.busy_us[s];
+  }
+}
+
+/* Render and flush timing from display events */
+static void perf_display_event_cb(lv_event_t *e) {
+  uint32_t now = micros();
+
+  switch(lv_event_get_code(e)) {
+    case LV_EVENT_RENDER_START:
+      perf.render_start_us = now;
+      break;
+    case LV_EVENT_FLUSH_START:
+      perf.flush_start_us = now;
+      break;
+    case LV_EVENT_FLUSH_FINISH:
+      perf.flush_us += now - perf.flush_start_us;
+      break;
+    case LV_EVENT_RENDER_READY: {
+      uint32_t dt = now - perf.render_start_us;
+      perf.render_us += dt;
+      if(dt > perf.render_max_us) perf.render_max_us = dt;
+      perf.frames++;
+      break;
     }
-    
-    vTaskDelay(5 / portTICK_PERIOD_MS);
+    default:
+      break;
   }
 }
 
-void show_battery_screen() {
-    Serial.println("=== Entering show_battery_screen ===");
-    
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    clear_dashboard_pointers();  // ← ONE LINE!
+static void diagnostics_refresh_link() {
+  LinkHealth link;
+  NodeRoute nodes[NODE_COUNT];
+  uint8_t node_count;
 
-    lv_obj_set_style_bg_color(scr, lv_color_hex(0x0f1419), 0);
-    
-    // Back button
-    lv_obj_t *back_btn = lv_btn_create(scr);
-    lv_obj_set_size(back_btn, 80, 40);
-    lv_obj_align(back_btn, LV_ALIGN_TOP_LEFT, 10, 10);
-    lv_obj_t *back_label = lv_label_create(back_btn);
-    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
-    lv_obj_set_style_bg_color(back_btn, lv_color_hex(0x333333), 0);
-    lv_obj_center(back_label);
-    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
-        if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            create_ev_dashboard_ui();
-            lv_refr_now(disp);
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    // Title
-    lv_obj_t *title = lv_label_create(scr);
-    lv_label_set_text(title, "BATTERY INFO");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 15);
-    
-    // Battery SOC Arc
-    lv_obj_t *arc = lv_arc_create(scr);
-    lv_obj_set_size(arc, 200, 200);
-    lv_obj_center(arc);
-    lv_arc_set_range(arc, 0, 100);
-    lv_arc_set_value(arc, dashData.soc);
-    lv_obj_set_style_arc_color(arc, lv_color_hex(0x00ff00), LV_PART_INDICATOR);
-    lv_obj_set_style_arc_width(arc, 20, LV_PART_INDICATOR);
-    
-    // SOC percentage
-    lv_obj_t *soc_label = lv_label_create(scr);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%d%%", dashData.soc);
-    lv_label_set_text(soc_label, buf);
-    lv_obj_set_style_text_font(soc_label, &lv_font_montserrat_48, 0);
-    lv_obj_set_style_text_color(soc_label, lv_color_white(), 0);
-    lv_obj_align(soc_label, LV_ALIGN_CENTER, 0, 0);
-    
-    // Details
-    lv_obj_t *voltage_label = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Voltage: %.2f V", dashData.voltage);
-    lv_label_set_text(voltage_label, buf);
-    lv_obj_set_style_text_color(voltage_label, lv_color_white(), 0);
-    lv_obj_set_style_text_font(voltage_label, &lv_font_montserrat_18, 0);
-    lv_obj_align(voltage_label, LV_ALIGN_BOTTOM_LEFT, 20, -60);
-    
-    lv_obj_t *current_label = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Current: %.2f A", dashData.current);
-    lv_label_set_text(current_label, buf);
-    lv_obj_set_style_text_color(current_label, lv_color_white(), 0);
-    lv_obj_set_style_text_font(current_label, &lv_font_montserrat_18, 0);
-    lv_obj_align(current_label, LV_ALIGN_BOTTOM_LEFT, 20, -30);
-    
-    lv_obj_t *temp_label = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Temp: %d°C", dashData.battery_temp);
-    lv_label_set_text(temp_label, buf);
-    lv_obj_set_style_text_color(temp_label, lv_color_white(), 0);
-    lv_obj_set_style_text_font(temp_label, &lv_font_montserrat_18, 0);
-    lv_obj_align(temp_label, LV_ALIGN_BOTTOM_RIGHT, -20, -60);
-    
-    lv_refr_now(disp);
+  if(!xSemaphoreTake(dataMutex, 0)) {
+    return;
+  }
+  link = linkHealth;
+  NodeRoute *routes = telemetry_routes(&node_count);
+  if (node_count > NODE_COUNT) node_count = NODE_COUNT;
+  memcpy(nodes, routes, node_count * sizeof(NodeRoute));
+  xSemaphoreGive(dataMutex);
+
+  uint32_t now = millis();
+  char buf[256];
+
+  snprintf(buf, sizeof(buf),
+           "Link: %s\nFrames/s: %.1f\nCRC errors: %lu (%.1f%%)\nLast frame: %lu ms ago\nDropped bytes: %lu",
+           link_is_down(now) ? "DOWN" : "UP",
+           link.frame_rate,
+           link.crc_errors, link.crc_error_rate * 100.0f,
+           link.last_valid_ms ? now - link.last_valid_ms : 0,
+           link.bytes_dropped);
+  lv_label_set_text(diag_link_label, buf);
+
+  int n = 0;
+  for (uint8_t r = 0; r < node_count && n < (int)sizeof(buf); r++) {
+    n += snprintf(buf + n, sizeof(buf) - n, "%s: %s, %lu frames, %lu gaps\n",
+                  nodes[r].name,
+                  !nodes[r].state.seen ? "--" : (nodes[r].state.stale ? "STALE" : "fresh"),
+                  nodes[r].state.frames, nodes[r].state.seq.gaps);
+  }
+  lv_label_set_text(diag_nodes_label, buf);
+
+  n = 0;
+  for (uint8_t f = 0; f < FIELD_COUNT && n < (int)sizeof(buf); f++) {
+    n += snprintf(buf + n, sizeof(buf) - n, "%s %.1f%s", field_short_names[f],
+                  link.field_rate[f], (f % 5 == 4) ? "\n" : "   ");
+  }
+  lv_label_set_text(diag_fields_label, buf);
 }
 
-void show_voltage_screen() {
+/* Close the measurement window and update whatever is on screen. The labels
+ * are built once; only their text changes here. */
+static void perf_timer_cb(lv_timer_t *t) {
+  uint32_t now = millis();
+  uint32_t elapsed = now - perf_window_ms;
+  if(elapsed == 0) {
+    return;
+  }
 
+  PerfStats p = perf;
+  memset(&perf, 0, sizeof(perf));
+  perf_window_ms = now;
+
+  float fps = p.frames * 1000.0f / elapsed;
+  float render_ms = p.frames ? (p.render_us - p.flush_us) / 1000.0f / p.frames : 0;
+  float flush_ms = p.frames ? p.flush_us / 1000.0f / p.frames : 0;
+  float touch_ms = p.touch_reads ? p.touch_us / 1000.0f / p.touch_reads : 0;
+
+  int cpu[2];
+  float ticks = elapsed * (float)configTICK_RATE_HZ / 1000.0f;
+  for(int c = 0; c < 2; c++) {
+    uint32_t calls = idle_calls[c];
+    int idle = (int)((calls - idle_calls_prev[c]) * 100.0f / ticks);
+    idle_calls_prev[c] = calls;
+    cpu[c] = 100 - (idle > 100 ? 100 : idle);
+  }
 
+  char buf[200];
 
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    clear_dashboard_pointers();  // ← ONE LINE!
-    
-    lv_obj_set_style_bg_color(scr, lv_color_hex(0x0f1419), 0);
-    
-    lv_obj_t *back_btn = lv_btn_create(scr);
-    lv_obj_set_size(back_btn, 80, 40);
-    lv_obj_align(back_btn, LV_ALIGN_TOP_LEFT, 10, 10);
-    lv_obj_t *back_label = lv_label_create(back_btn);
-    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
-    lv_obj_center(back_label);
-    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
-        if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            create_ev_dashboard_ui();
-            lv_refr_now(disp);
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *title = lv_label_create(scr);
-    lv_label_set_text(title, "VOLTAGE MONITOR");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 15);
-    
-    lv_obj_t *voltage_display = lv_label_create(scr);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%.2f V", dashData.voltage);
-    lv_label_set_text(voltage_display, buf);
-    lv_obj_set_style_text_font(voltage_display, &lv_font_montserrat_48, 0);
-    lv_obj_set_style_text_color(voltage_display, lv_color_hex(0x00ffff), 0);
-    lv_obj_align(voltage_display, LV_ALIGN_CENTER, 0, -20);
-    
-    lv_obj_t *current_display = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Current: %.2f A", dashData.current);
-    lv_label_set_text(current_display, buf);
-    lv_obj_set_style_text_color(current_display, lv_color_white(), 0);
-    lv_obj_set_style_text_font(current_display, &lv_font_montserrat_20, 0);
-    lv_obj_align(current_display, LV_ALIGN_CENTER, 0, 40);
-    
-    float power = dashData.voltage * dashData.current;
-    lv_obj_t *power_display = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Power: %.2f W", power);
-    lv_label_set_text(power_display, buf);
-    lv_obj_set_style_text_color(power_display, lv_color_white(), 0);
-    lv_obj_set_style_text_font(power_display, &lv_font_montserrat_20, 0);
-    lv_obj_align(power_display, LV_ALIGN_CENTER, 0, 80);
-    
-    lv_refr_now(disp);
+  if(hud_label) {
+    snprintf(buf, sizeof(buf), "%.0f FPS  R %.1f ms  C0 %d%%  C1 %d%%", fps, render_ms, cpu[0], cpu[1]);
+    lv_label_set_text(hud_label, buf);
+  }
+
+  if(!diag_perf_label) {
+    return;
+  }
+
+  snprintf(buf, sizeof(buf),
+           "FPS: %.1f\nRender: %.1f ms (max %.1f)\nFlush: %.1f ms\nCPU0: %d%%  CPU1: %d%%\nTouch read: %.2f ms (max %.2f)",
+           fps, render_ms, p.render_max_us / 1000.0f, flush_ms, cpu[0], cpu[1],
+           touch_ms, p.touch_max_us / 1000.0f);
+  lv_label_set_text(diag_perf_label, buf);
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  UiAllocStats as;
+  ui_alloc_stats(&as);
+  snprintf(buf, sizeof(buf),
+           "Heap: %u KB (blk %u, low %lu KB)\nDMA: %u KB\nLVGL: %d%% used, %d%% frag\n"
+           "Arena: %lu B, %lu fallbacks",
+           heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024,
+           heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024,
+           as.heap_largest_min / 1024,
+           heap_caps_get_free_size(MALLOC_CAP_DMA) / 1024,
+           mon.used_pct, mon.frag_pct, as.arena_used, as.pool_fallbacks);
+  lv_label_set_text(diag_mem_label, buf);
+
+  // Power state and the UI loop's wake-ups; touch wake-ups out of dim or idle
+  uint32_t loops, busy, wakes = 0, wake_us = 0, wake_max = 0;
+  power_loop_totals(&loops, &busy);
+  for(int s = 0; s < POWER_STATE_COUNT; s++) {
+    wakes += power.stats.wakes[s];
+    wake_us += power.stats.wake_us[s];
+    if(power.stats.wake_max_us[s] > wake_max) wake_max = power.stats.wake_max_us[s];
+  }
+  snprintf(buf, sizeof(buf),
+           "Power: %s  %lu MHz  BL %u\nLoop %lu/s  busy %lu%%  wake %.1f/%.1f ms",
+           power_state_name(power.state), power_cpu_mhz(), power_backlight(&power),
+           (loops - power_loops_prev) * 1000 / elapsed, (busy - power_busy_prev) / 10 / elapsed,
+           wakes ? wake_us / 1000.0f / wakes : 0, wake_max / 1000.0f);
+  power_loops_prev = loops;
+  power_busy_prev = busy;
+  lv_label_set_text(diag_power_label, buf);
+
+  // Shared SPI bus: share of the window it was held, flush waits for the SD writer
+  SpiBusStats spi = spiBusStats;
+  uint32_t busy_disp = spi.busy_us[SPI_CLIENT_DISPLAY] - spi_prev.busy_us[SPI_CLIENT_DISPLAY];
+  uint32_t busy_sd = spi.busy_us[SPI_CLIENT_SD] - spi_prev.busy_us[SPI_CLIENT_SD];
+  uint32_t flushes = spi.acquires[SPI_CLIENT_DISPLAY] - spi_prev.acquires[SPI_CLIENT_DISPLAY];
+  uint32_t flush_wait = spi.wait_us[SPI_CLIENT_DISPLAY] - spi_prev.wait_us[SPI_CLIENT_DISPLAY];
+  if(sdLog.active) {
+    snprintf(buf, sizeof(buf), "SPI %lu%% (SD %lu%%)  log %.1f KB/s\nFlush wait %.2f/%.2f ms  drop %lu",
+             (busy_disp + busy_sd) / 10 / elapsed, busy_sd / 10 / elapsed,
+             (sdLog.bytes_written - sd_bytes_prev) / 1.024f / elapsed,
+             flushes ? flush_wait / 1000.0f / flushes : 0, spi.wait_max_us[SPI_CLIENT_DISPLAY] / 1000.0f,
+             sdLog.dropped);
+  } else {
+    snprintf(buf, sizeof(buf), "SPI %lu%%  log off\nFlush wait %.2f/%.2f ms",
+             (busy_disp + busy_sd) / 10 / elapsed,
+             flushes ? flush_wait / 1000.0f / flushes : 0, spi.wait_max_us[SPI_CLIENT_DISPLAY] / 1000.0f);
+  }
+  spi_prev = spi;
+  sd_bytes_prev = sdLog.bytes_written;
+  lv_label_set_text(diag_bus_label, buf);
+
+  diagnostics_refresh_link();
 }
 
-void show_temperature_screen() {
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    show_statistics_screen();
-    clear_dashboard_pointers();  // ← ONE LINE!
-    lv_obj_set_style_bg_color(scr, lv_color_hex(0x2a1a1a), 0);
-    
-    lv_obj_t *back_btn = lv_btn_create(scr);
-    lv_obj_set_size(back_btn, 80, 40);
-    lv_obj_align(back_btn, LV_ALIGN_TOP_LEFT, 10, 10);
-    lv_obj_t *back_label = lv_label_create(back_btn);
-    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
-    lv_obj_center(back_label);
-    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
-        if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            create_ev_dashboard_ui();
-            lv_refr_now(disp);
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *title = lv_label_create(scr);
-    lv_label_set_text(title, "TEMPERATURE");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 15);
-    
-    // Battery temp
-    lv_obj_t *battery_container = lv_obj_create(scr);
-    lv_obj_set_size(battery_container, 200, 100);
-    lv_obj_align(battery_container, LV_ALIGN_CENTER, 0, -40);
-    lv_obj_set_style_bg_color(battery_container, lv_color_hex(0x3a2a2a), 0);
-    
-    lv_obj_t *batt_title = lv_label_create(battery_container);
-    lv_label_set_text(batt_title, "Battery");
-    lv_obj_set_style_text_color(batt_title, lv_color_white(), 0);
-    lv_obj_align(batt_title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *batt_temp = lv_label_create(battery_container);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%d°C", dashData.battery_temp);
-    lv_label_set_text(batt_temp, buf);
-    lv_obj_set_style_text_font(batt_temp, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(batt_temp, lv_color_hex(0xff6600), 0);
-    lv_obj_align(batt_temp, LV_ALIGN_CENTER, 0, 10);
-    
-    // Motor temp
-    lv_obj_t *motor_container = lv_obj_create(scr);
-    lv_obj_set_size(motor_container, 200, 100);
-    lv_obj_align(motor_container, LV_ALIGN_CENTER, 0, 80);
-    lv_obj_set_style_bg_color(motor_container, lv_color_hex(0x2a2a3a), 0);
-    
-    lv_obj_t *motor_title = lv_label_create(motor_container);
-    lv_label_set_text(motor_title, "Motor");
-    lv_obj_set_style_text_color(motor_title, lv_color_white(), 0);
-    lv_obj_align(motor_title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *motor_temp = lv_label_create(motor_container);
-    snprintf(buf, sizeof(buf), "%d°C", dashData.motor_temp);
-    lv_label_set_text(motor_temp, buf);
-    lv_obj_set_style_text_font(motor_temp, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(motor_temp, lv_color_hex(0x00ccff), 0);
-    lv_obj_align(motor_temp, LV_ALIGN_CENTER, 0, 10);
-    
-    lv_refr_now(disp);
+/* Counters, display hook and timer exist only while something shows them */
+static void perf_monitor_update() {
+  bool wanted = diag_perf_label != NULL || hud_label != NULL;
+
+  if(wanted && !perf_timer) {
+    memset(&perf, 0, sizeof(perf));
+    perf_window_ms = millis();
+    idle_calls_prev[0] = idle_calls[0];
+    idle_calls_prev[1] = idle_calls[1];
+    power_loop_totals(&power_loops_prev, &power_busy_prev);
+    spi_prev = spiBusStats;
+    sd_bytes_prev = sdLog.bytes_written;
+    lv_display_add_event_cb(disp, perf_display_event_cb, LV_EVENT_ALL, NULL);
+    perf_timer = lv_timer_create(perf_timer_cb, PERF_PERIOD_MS, NULL);
+    perf_active = true;
+  } else if(!wanted && perf_timer) {
+    perf_active = false;
+    lv_timer_delete(perf_timer);
+    perf_timer = NULL;
+    lv_display_remove_event_cb_with_user_data(disp, perf_display_event_cb, NULL);
+  }
 }
 
-void show_statistics_screen() {
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    lv_obj_set_style_bg_color(scr, lv_color_hex(0x1a1a2a), 0);
-    
-    lv_obj_t *back_btn = lv_btn_create(scr);
-    lv_obj_set_size(back_btn, 80, 40);
-    lv_obj_align(back_btn, LV_ALIGN_TOP_LEFT, 10, 10);
-    lv_obj_t *back_label = lv_label_create(back_btn);
-    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
-    lv_obj_center(back_label);
-    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
-        if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            create_ev_dashboard_ui();
-            lv_refr_now(disp);
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *title = lv_label_create(scr);
-    lv_label_set_text(title, "STATISTICS");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 15);
-    
-    char buf[64];
-    int y_pos = 70;
-    
-    lv_obj_t *trip_info = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Trip: %d km", dashData.trip);
-    lv_label_set_text(trip_info, buf);
-    lv_obj_set_style_text_color(trip_info, lv_color_white(), 0);
-    lv_obj_set_style_text_font(trip_info, &lv_font_montserrat_18, 0);
-    lv_obj_align(trip_info, LV_ALIGN_TOP_LEFT, 20, y_pos);
-    
-    y_pos += 40;
-    lv_obj_t *odo_info = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Odometer: %d km", dashData.odo);
-    lv_label_set_text(odo_info, buf);
-    lv_obj_set_style_text_color(odo_info, lv_color_white(), 0);
-    lv_obj_set_style_text_font(odo_info, &lv_font_montserrat_18, 0);
-    lv_obj_align(odo_info, LV_ALIGN_TOP_LEFT, 20, y_pos);
-    
-    y_pos += 40;
-    lv_obj_t *avg_speed_info = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Avg Speed: %d km/h", dashData.avg_kmh);
-    lv_label_set_text(avg_speed_info, buf);
-    lv_obj_set_style_text_color(avg_speed_info, lv_color_white(), 0);
-    lv_obj_set_style_text_font(avg_speed_info, &lv_font_montserrat_18, 0);
-    lv_obj_align(avg_speed_info, LV_ALIGN_TOP_LEFT, 20, y_pos);
-    
-    y_pos += 40;
-    lv_obj_t *range_info = lv_label_create(scr);
-    snprintf(buf, sizeof(buf), "Range: %d km", dashData.range);
-    lv_label_set_text(range_info, buf);
-    lv_obj_set_style_text_color(range_info, lv_color_white(), 0);
-    lv_obj_set_style_text_font(range_info, &lv_font_montserrat_18, 0);
-    lv_obj_align(range_info, LV_ALIGN_TOP_LEFT, 20, y_pos);
-    
-    lv_refr_now(disp);
+/* Compact FPS/render/CPU line on the top layer, visible over every screen */
+static void toggle_hud() {
+  if(hud_label) {
+    lv_obj_delete(hud_label);
+    hud_label = NULL;
+  } else {
+    hud_label = lv_label_create(lv_layer_top());
+    lv_label_set_text(hud_label, "");
+    lv_obj_set_style_text_color(hud_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(hud_label, ui_font_px(14), 0);
+    lv_obj_set_style_bg_color(hud_label, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(hud_label, LV_OPA_60, 0);
+    lv_obj_set_style_pad_all(hud_label, 3, 0);
+    lv_obj_align(hud_label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+  }
+  perf_monitor_update();
 }
 
-void show_settings_screen() {
-    lv_obj_t *scr = lv_scr_act();
-    lv_obj_clean(scr);
-    clear_dashboard_pointers();  // ← ONE LINE!
+static lv_obj_t *create_diag_label(lv_obj_t *parent, lv_color_t color, uint8_t col, uint8_t row) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, "");
+    lv_obj_set_style_text_color(label, color, 0);
+    lv_obj_set_style_text_font(label, ui_font_px(14), 0);
+    lv_obj_set_grid_cell(label, LV_GRID_ALIGN_START, col, 1, LV_GRID_ALIGN_START, row, 1);
+    return label;
+}
 
-    lv_obj_set_style_bg_color(scr, lv_color_hex(0x1a1a1a), 0);
-    
-    lv_obj_t *back_btn = lv_btn_create(scr);
-    lv_obj_set_size(back_btn, 80, 40);
-    lv_obj_align(back_btn, LV_ALIGN_TOP_LEFT, 10, 10);
-    lv_obj_t *back_label = lv_label_create(back_btn);
-    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
-    lv_obj_center(back_label);
-    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
+void show_diagnostics_screen() {
+    lv_obj_t *header_right;
+    lv_obj_t *content = screen_frame("DIAGNOSTICS", 0x1a1a1a, &header_right);
+    lv_obj_set_flex_align(content, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
+
+    lv_obj_t *hud_btn = lv_btn_create(header_right);
+    lv_obj_set_size(hud_btn, ui_px(80), ui_layout.touch);
+    lv_obj_set_style_bg_color(hud_btn, lv_color_hex(0x333333), 0);
+    lv_obj_t *hud_btn_label = lv_label_create(hud_btn);
+    lv_label_set_text(hud_btn_label, "HUD");
+    lv_obj_set_style_text_font(hud_btn_label, ui_font_px(14), 0);
+    lv_obj_center(hud_btn_label);
+    lv_obj_add_event_cb(hud_btn, [](lv_event_t *e) {
         if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            create_ev_dashboard_ui();
-            lv_refr_now(disp);
+            toggle_hud();
         }
     }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *title = lv_label_create(scr);
-    lv_label_set_text(title, "SETTINGS");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_24, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 15);
-    
-    lv_obj_t *info = lv_label_create(scr);
-    lv_label_set_text(info, "Settings Page\n\nAdd your options here");
-    lv_obj_set_style_text_color(info, lv_color_white(), 0);
-    lv_obj_set_style_text_font(info, &lv_font_montserrat_18, 0);
-    lv_obj_center(info);
+
+    // Two columns of readouts, the per-field rates across the bottom
+    static const int32_t diag_cols[] = { LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+    static const int32_t diag_rows[] = { LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_FR(1),
+                                         LV_GRID_TEMPLATE_LAST };
+    lv_obj_t *grid = ui_layout_grid(content, diag_cols, diag_rows);
+    lv_obj_set_width(grid, LV_PCT(100));
+    lv_obj_set_flex_grow(grid, 1);
+    diag_perf_label = create_diag_label(grid, lv_color_white(), 0, 0);
+    diag_link_label = create_diag_label(grid, lv_color_white(), 1, 0);
+    diag_mem_label = create_diag_label(grid, lv_color_white(), 0, 1);
+    diag_nodes_label = create_diag_label(grid, lv_color_white(), 1, 1);
+    diag_power_label = create_diag_label(grid, lv_color_white(), 0, 2);
+    diag_bus_label = create_diag_label(grid, lv_color_white(), 1, 2);
+    diag_fields_label = create_diag_label(grid, lv_color_hex(0xaaaaaa), 0, 3);
+    lv_obj_set_grid_cell(diag_fields_label, LV_GRID_ALIGN_START, 0, 2, LV_GRID_ALIGN_END, 3, 1);
+
+    // Stop measuring as soon as the screen's widgets go away
+    lv_obj_add_event_cb(diag_perf_label, [](lv_event_t *e) {
+        diag_perf_label = NULL;
+        diag_mem_label = NULL;
+        diag_link_label = NULL;
+        diag_nodes_label = NULL;
+        diag_fields_label = NULL;
+        diag_power_label = NULL;
+        diag_bus_label = NULL;
+        perf_monitor_update();
+    }, LV_EVENT_DELETE, NULL);
+
+    ui_alloc_arena_end();     // The perf timer may outlive the screen
+    perf_monitor_update();
+    diagnostics_refresh_link();
     
     lv_refr_now(disp);
 }
 
+/* ===== Boot =====
+ * SD card + splash load and touch bring-up run as short-lived tasks on core 0
+ * while setup() initialises LVGL. The panel shares VSPI with the SD card, so it
+ * is created as soon as the SD task lets go of the bus. The splash then stays
+ * up only until the first valid RS485 frame or BOOT_SPLASH_MAX_MS. */
+#define BOOT_SPLASH_MAX_MS  1500   // Leave the splash after this even without RS485 data
+
+static uint32_t boot_start_ms = 0;
+static SemaphoreHandle_t boot_sd_done = NULL;      // Given when the SD task is off the SPI bus
+static SemaphoreHandle_t boot_touch_done = NULL;   // Given when touch and RTC are up
+
+static void boot_mark(const char *phase) {
+  Serial.printf("[BOOT] %5lu ms  %s\n", millis() - boot_start_ms, phase);
+}
+
+/* Mount the SD card and pull the splash image into RAM. A missing card or
+ * image only costs the splash picture. */
+static void boot_sd_task(void *parameter) {
+  SPIClass spi = SPIClass(VSPI);
+  spi.begin(18, 19, 23, SD_CS);
+
+  if (!SD.begin(SD_CS, spi)) {
+    Serial.println("ERROR: SD Card mount failed, booting without splash image");
+  } else {
+    if (!load_image_to_ram("/lvgl/logo1.bin")) {
+      Serial.println("ERROR: Failed to load image, booting without splash image");
+    }
+    SD.end();
+  }
+
+  boot_mark("SD card done");
+  xSemaphoreGive(boot_sd_done);
+  vTaskDelete(NULL);
+}
+
+/* GT911 reset/config and the RTC probe, holding the I2C bus throughout */
+static void boot_touch_task(void *parameter) {
+  xSemaphoreTake(i2c_mutex, portMAX_DELAY);
+  Wire.begin(TOUCH_SDA, TOUCH_SCL);
+  Wire.setClock(400000);
+  ts.begin(TOUCH_INT, TOUCH_RST);
+  delay(200); // Give touch sensor time to initialize
+  xSemaphoreGive(i2c_mutex);
+  boot_mark("touch ready");
+
+  // Wall clock: RTC on the touch I2C bus if fitted, RS485 time otherwise
+  time_source_begin(i2c_mutex);
+
+  xSemaphoreGive(boot_touch_done);
+  vTaskDelete(NULL);
+}
+
 void setup() {
+  boot_start_ms = millis();
   Serial.begin(115200);
-  delay(100);
 
-  // Initialize RS485
+  // Initialize RS485. The UART ring must hold a whole large frame between polls.
+  Serial1.setRxBufferSize(RS485_RX_BUF_LEN);
   Serial1.begin(115200, SERIAL_8N1, SERIAL1_RX, SERIAL1_TX);
 
   Serial.println("\n=== EV Dashboard ===");
 
-  // update_time_display();
-
   // Initialize data structure
   init_dashboard_data();
 
-  /* Initialize SD Card */
-  Serial.println("Initializing SD Card...");
-  SPIClass spi = SPIClass(VSPI);
-  spi.begin(18, 19, 23, SD_CS);
+  // UI command queue, before any task can post to it
+  ui_cmd_queue_init(&ui_cmds);
 
-  if (!SD.begin(SD_CS, spi)) {
-    Serial.println("ERROR: SD Card mount failed!");
-    while (1) delay(1000);
+  // Create mutex for protecting shared data
+  dataMutex = xSemaphoreCreateMutex();
+  i2c_mutex = xSemaphoreCreateMutex();
+  boot_sd_done = xSemaphoreCreateBinary();
+  boot_touch_done = xSemaphoreCreateBinary();
+  ui_wake = xSemaphoreCreateBinary();
+  if(dataMutex == NULL || i2c_mutex == NULL || boot_sd_done == NULL || boot_touch_done == NULL ||
+     ui_wake == NULL || !spi_bus_init()) {
+    Serial.println("ERROR: Failed to create mutexes!");
+    while(1) delay(1000);
   }
 
-  /* Load splash image */
-  if (!load_image_to_ram("/lvgl/logo1.bin")) {
-    Serial.println("ERROR: Failed to load image!");
-    while (1) delay(1000);
-  }
+  /* Splash picture from the flash asset partition, SD card as fallback */
+  asset_store_begin();
+  const lv_image_dsc_t *splash_asset = asset_image("logo");
 
-  SD.end();
+  /* SD card and touch come up in the background */
+  if (splash_asset) {
+    xSemaphoreGive(boot_sd_done);  // Nothing to read, panel can have the bus now
+  } else {
+    xTaskCreatePinnedToCore(boot_sd_task, "Boot_SD", 4096, NULL, 1, NULL, 0);
+  }
+  xTaskCreatePinnedToCore(boot_touch_task, "Boot_Touch", 3072, NULL, 1, NULL, 0);
+  boot_mark("init tasks started");
 
   /* Initialize LVGL */
   lv_init();
 
-  /* Initialize touch */
-  Wire.begin(TOUCH_SDA, TOUCH_SCL);
-  Wire.setClock(400000);
-  Serial.println("I2C bus initialized");
-
-  ts.begin(TOUCH_INT, TOUCH_RST);
-  delay(200); // Give touch sensor time to initialize
-  Serial.println("Touch sensor initialized");
+  /* Telemetry subjects start from the defaults; RS485 is not running yet */
+  ui_bind_init();
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    ui_bind_publish(f, field_display_value(f));
+  }
 
   /* Allocate draw buffer */
-  draw_buf = heap_caps_malloc(
-      TFT_HOR_RES * 40 * (LV_COLOR_DEPTH / 8),
-      MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  draw_buf = heap_caps_malloc(DRAW_BUF_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
 
   if (!draw_buf) {
     Serial.println("ERROR: Draw buffer allocation failed!");
     while (1) delay(1000);
   }
 
-  /* Create display */
-  disp = lv_tft_espi_create(
-      TFT_HOR_RES, TFT_VER_RES, draw_buf,
-      TFT_HOR_RES * 40 * (LV_COLOR_DEPTH / 8));
-
-  TFT_eSPI().setRotation(3);
-
-   // VERIFY input device still registered
-  // if(touch_indev) {
-  //   lv_display_t *assoc_disp = lv_indev_get_display(touch_indev);
-  //   Serial.printf("After UI creation - Input still on display: 0x%08X\n", 
-  //                 (uint32_t)assoc_disp);
-  // }
-
-  // dataMutex = xSemaphoreCreateMutex();
-  lvgl_mutex = xSemaphoreCreateMutex();
-
-  /* CRITICAL: Create I2C mutex BEFORE setting up touch input */
-  i2c_mutex = xSemaphoreCreateMutex();
-  if(i2c_mutex == NULL) {
-    Serial.println("ERROR: Failed to create I2C mutex!");
-    while(1) delay(1000);
-  }
-  Serial.println("I2C mutex created");
-
-  /* Initialize touch input device - CRITICAL: Do this before UI creation */
+  /* Initialize touch input device - the read callback waits on i2c_mutex
+   * until the touch task has finished */
   touch_indev = lv_indev_create();
   lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(touch_indev, my_touch_read);
-  lv_indev_set_display(touch_indev, disp);
+  boot_mark("LVGL ready");
 
-  Serial.printf("Touch input device created: 0x%08X\n", (uint32_t)touch_indev);
+  /* Create display once the SD card is off the shared SPI bus */
+  xSemaphoreTake(boot_sd_done, portMAX_DELAY);
+  disp = lv_tft_espi_create(TFT_HOR_RES, TFT_VER_RES, draw_buf, DRAW_BUF_BYTES);
+  ui_layout_init(disp);
+  Serial.printf("[LAYOUT] %ldx%ld, %s, scale %.2f\n", ui_layout.hor_res, ui_layout.ver_res,
+                ui_size_class_name(ui_layout.size_class), ui_layout.scale / 256.0f);
 
-  /* Show splash screen */
+  TFT_eSPI().setRotation(3);
+  lv_indev_set_display(touch_indev, disp);
+  panel_flush_cb = disp->flush_cb;
+  lv_display_set_flush_cb(disp, shared_bus_flush_cb);
+  boot_mark("display ready");
+
+  /* Show splash screen, picture only if the SD card provided one */
   lv_obj_t *scr = lv_scr_act();
   lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
 
   lv_obj_t *label = lv_label_create(scr);
   lv_label_set_text(label, "Charge Into The Future");
   lv_obj_set_style_text_color(label, lv_color_black(), 0);
-  lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, -64);
+  lv_obj_set_style_text_font(label, ui_font_px(14), 0);
+  lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, -ui_px(64));
 
   static lv_image_dsc_t img_dsc;
-  img_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
-  img_dsc.header.w = 148;
-  img_dsc.header.h = 148;
-  img_dsc.data_size = image_size;
-  img_dsc.data = image_data;
-
-  lv_obj_t *img = lv_image_create(scr);
-  lv_image_set_src(img, &img_dsc);
-  lv_obj_align(img, LV_ALIGN_CENTER, 0, 4);
-
-  // Test that LVGL works BEFORE splash
-  Serial.println("\nTesting LVGL before splash...");
-  for(int i = 0; i < 5; i++) {
-    lv_timer_handler();
-    Serial.printf("  lv_timer_handler() call %d - touch callbacks: %lu\n", i+1, touch_callback_count);
-    delay(10);
+  lv_obj_t *img = NULL;
+  if (splash_asset) {
+    img = lv_image_create(scr);
+    lv_image_set_src(img, splash_asset);  // Straight from mapped flash
+    lv_obj_align(img, LV_ALIGN_CENTER, 0, 4);
+  } else if (image_data) {
+    img_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+    img_dsc.header.w = 148;
+    img_dsc.header.h = 148;
+    img_dsc.data_size = image_size;
+    img_dsc.data = image_data;
+
+    img = lv_image_create(scr);
+    lv_image_set_src(img, &img_dsc);
+    lv_obj_align(img, LV_ALIGN_CENTER, 0, 4);
   }
 
   lv_refr_now(disp);
-  delay(3000);
+  boot_mark("splash shown");
+
+  /* Clock scaling and sleep locks, before the tasks that take them */
+  power_init(&power, millis());
+#ifdef TFT_BL
+  power_backlight_begin(TFT_BL);
+#else
+  Serial.println("[POWER] No TFT_BL pin, backlight levels are ignored");
+#endif
+
+  /* Start listening on RS485 right away, the first valid frame ends the splash */
+  rs485_transport_init(&rs485_transport, &rs485_link, &Serial1, UART_NUM_1);
+  rs485_transport.begin(&rs485_transport);
+  xTaskCreatePinnedToCore(
+    telemetryTask,       // Task function
+    "RS485_Task",        // Task name
+    4096,                // Stack size
+    &rs485_transport,    // Parameters
+    2,                   // Priority (lower than UI)
+    &rs485TaskHandle,    // Task handle
+    0                    // Core 0
+  );
+#ifdef DASH_CAN
+  can_transport_init(&can_transport, &can_link, can_signals,
+                     sizeof(can_signals) / sizeof(can_signals[0]), CAN_TX_PIN, CAN_RX_PIN);
+  if (can_transport.begin(&can_transport)) {
+    xTaskCreatePinnedToCore(telemetryTask, "CAN_Task", 4096, &can_transport, 2, &canTaskHandle, 0);
+  }
+#endif
+
+  uint32_t splash_ms = millis();
+  while (linkHealth.frames_ok == 0 && millis() - splash_ms < BOOT_SPLASH_MAX_MS) {
+    delay(10);
+  }
+  boot_mark(linkHealth.frames_ok ? "first RS485 frame" : "splash timeout, no RS485 data yet");
+
+  xSemaphoreTake(boot_touch_done, portMAX_DELAY);
 
   /* Cleanup splash */
-  lv_obj_delete(img);
+  if (img) lv_obj_delete(img);
   lv_obj_delete(label);
   if (image_data) {
     free(image_data);
     image_data = NULL;
   }
 
-  /* Create dashboard with initial values */
+  /* Create dashboard with initial values (or the first frame's) */
   create_ev_dashboard_ui();
   lv_refr_now(disp);
+  boot_mark("dashboard shown");
 
   Serial.println("\n=== Setup Complete ===");
 
-  /* Check I2C bus health */
-  // check_i2c_bus();
-  // This is the test code for touch:
-
-  Serial.println("Touch test: Please touch the screen in the next 5 seconds...");
-  // testTouch();
-
-  // Create LVGL mutex 
-  // lvgl_mutex = xSemaphoreCreateMutex();
-  // if(lvgl_mutex == NULL) {
-  //   Serial.println("ERROR: Failed to create LVGL mutex!");
-  //   while(1) delay(1000);
-  // }
-  // Serial.println("LVGL mutex created");
-
-  // Create mutex for protecting shared data
-  dataMutex = xSemaphoreCreateMutex();
-  if(dataMutex == NULL) {
-    Serial.println("ERROR: Failed to create data mutex!");
-    while(1) delay(1000);
-  }
-  Serial.println("Data mutex created");
-
-    // Create RS485 task on Core 0
-  xTaskCreatePinnedToCore(
-    rs485Task,           // Task function
-    "RS485_Task",        // Task name
-    4096,                // Stack size
-    NULL,                // Parameters
-    2,                   // Priority (lower than UI)
-    &rs485TaskHandle,    // Task handle
-    0                    // Core 0
-  );
+#ifdef DASH_BENCH
+  // Keep live traffic out of the simulations; park the telemetry tasks while
+  // they hold nothing
+  xSemaphoreTake(dataMutex, portMAX_DELAY);
+  vTaskSuspend(rs485TaskHandle);
+  if (canTaskHandle) vTaskSuspend(canTaskHandle);
+  xSemaphoreGive(dataMutex);
+  run_benchmarks();
+  if (canTaskHandle) vTaskResume(canTaskHandle);
+  vTaskResume(rs485TaskHandle);
+#endif
+
+  // Record telemetry to SD on the panel's SPI bus, in the gaps between flushes
+  sd_log_begin(SD_CS, TFT_eSPI::getSPIinstance());
+
+  // Stale-value greying, a few times per second instead of per frame
+  lv_timer_create(staleness_timer_cb, 250, NULL);
+  lv_timer_create(mem_watch_timer_cb, MEM_WATCH_PERIOD_MS, NULL);
+  mem_watch_timer_cb(NULL);   // First sample now, for the low-water mark
+
+  // CPU load estimate for the diagnostics screen
+  esp_register_freertos_idle_hook_for_cpu(idle_hook_core0, 0);
+  esp_register_freertos_idle_hook_for_cpu(idle_hook_core1, 1);
 
   // Create UI task on Core 1
   xTaskCreatePinnedToCore(
@@ -1564,9 +1451,7 @@ void setup() {
     1                    // Core 1
   );
   Serial.println("RTOS Tasks Created!");
-  Serial.println("Touch should work now!");
   Serial.println("Waiting for RS485 data...");
-  Serial.println("Try touching the menu button...");
 }
 
 
@@ -0,0 +1,252 @@
+#include <Arduino.h>
+#include <string.h>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+#include "power_manager.h"
+
+// esp_pm config struct was made chip-independent in IDF 5
+#if ESP_IDF_VERSION_MAJOR >= 5
+typedef esp_pm_config_t power_pm_config_t;
+#else
+typedef esp_pm_config_esp32_t power_pm_config_t;
+#endif
+
+PowerManager power;
+
+static esp_pm_lock_handle_t cpu_lock = NULL;        // Full clock, held while ACTIVE
+static esp_pm_lock_handle_t ui_sleep_lock = NULL;   // No light sleep unless IDLE
+static esp_pm_lock_handle_t bus_sleep_lock = NULL;  // No light sleep while a bus carries traffic (one hold per bus)
+static bool light_sleep = false;
+static bool backlight_on = false;                   // LEDC channel configured
+
+#define POWER_UART_WAKE_EDGES  3                    // Fewest RX edges the UART wake-up accepts
+
+// The RC_FAST clock went by its old name (RTC8M) before IDF 5
+#if ESP_IDF_VERSION_MAJOR >= 5
+#define POWER_LEDC_SLEEP_CLK   LEDC_USE_RC_FAST_CLK
+#define POWER_PD_SLEEP_CLK     ESP_PD_DOMAIN_RC_FAST
+#else
+#define POWER_LEDC_SLEEP_CLK   LEDC_USE_RTC8M_CLK
+#define POWER_PD_SLEEP_CLK     ESP_PD_DOMAIN_RTC8M
+#endif
+
+static const char *state_names[POWER_STATE_COUNT] = { "ACTIVE", "DIM", "IDLE" };
+
+const char *power_state_name(PowerState s) {
+  return s < POWER_STATE_COUNT ? state_names[s] : "?";
+}
+
+/* Dynamic frequency scaling between POWER_CPU_MHZ_MAX and _MIN, with automatic
+ * light sleep when the core supports it. Returns false when the framework was
+ * built without power management. */
+static bool pm_begin() {
+  power_pm_config_t cfg = {};
+  cfg.max_freq_mhz = POWER_CPU_MHZ_MAX;
+  cfg.min_freq_mhz = POWER_CPU_MHZ_MIN;
+  cfg.light_sleep_enable = true;
+
+  esp_err_t err = esp_pm_configure(&cfg);
+  if (err != ESP_OK && err != ESP_ERR_NOT_SUPPORTED) {
+    // PM is there but tickless idle is not: scale the clock, never sleep
+    cfg.light_sleep_enable = false;
+    err = esp_pm_configure(&cfg);
+  }
+  if (err == ESP_ERR_NOT_SUPPORTED) {
+    Serial.println("[POWER] Built without power management, switching the CPU clock directly");
+    return false;
+  }
+  if (err != ESP_OK) {
+    Serial.printf("ERROR: [POWER] esp_pm_configure failed (%s), switching the CPU clock directly\n",
+                  esp_err_to_name(err));
+    return false;
+  }
+  light_sleep = cfg.light_sleep_enable;
+
+  if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ui_cpu", &cpu_lock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "ui_sleep", &ui_sleep_lock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "bus_sleep", &bus_sleep_lock) != ESP_OK) {
+    Serial.println("ERROR: [POWER] PM lock creation failed, staying at full clock");
+    cfg.min_freq_mhz = POWER_CPU_MHZ_MAX;
+    cfg.light_sleep_enable = false;
+    esp_pm_configure(&cfg);
+    cpu_lock = ui_sleep_lock = bus_sleep_lock = NULL;
+    light_sleep = false;
+    return false;
+  }
+
+  // Start ACTIVE; each bus takes its own hold on the bus lock when its task starts
+  esp_pm_lock_acquire(cpu_lock);
+  esp_pm_lock_acquire(ui_sleep_lock);
+  if (light_sleep) esp_sleep_enable_gpio_wakeup();
+
+  Serial.printf("[POWER] Frequency scaling %d-%d MHz, light sleep %s\n",
+                POWER_CPU_MHZ_MIN, POWER_CPU_MHZ_MAX, light_sleep ? "on" : "off");
+  return true;
+}
+
+/* Clock and sleep permissions for a state. With esp_pm the locks only set
+ * limits and the clock drops whenever every task blocks; without it the
+ * clock is switched outright. */
+static void apply_state(PowerManager *pm, PowerState from, PowerState to) {
+  if (!pm->dfs) {
+    setCpuFrequencyMhz(to == POWER_ACTIVE ? POWER_CPU_MHZ_MAX : POWER_CPU_MHZ_MIN);
+    return;
+  }
+  if (from == POWER_ACTIVE) esp_pm_lock_release(cpu_lock);
+  if (to == POWER_ACTIVE) esp_pm_lock_acquire(cpu_lock);
+  if (to == POWER_IDLE) esp_pm_lock_release(ui_sleep_lock);
+  if (from == POWER_IDLE) esp_pm_lock_acquire(ui_sleep_lock);
+}
+
+void power_init(PowerManager *pm, uint32_t now_ms) {
+  memset(pm, 0, sizeof(*pm));
+  pm->state = POWER_ACTIVE;
+  pm->brightness = 255;
+  pm->last_activity_ms = now_ms;
+  pm->state_since_ms = now_ms;
+  pm->stats.entries[POWER_ACTIVE] = 1;
+
+  pm->dfs = pm_begin();
+  if (!pm->dfs) setCpuFrequencyMhz(POWER_CPU_MHZ_MAX);
+}
+
+void power_activity(PowerManager *pm, uint32_t now_ms) {
+  pm->last_activity_ms = now_ms;
+}
+
+/* A touch out of DIM or IDLE starts a wake-up measurement */
+void power_touch(PowerManager *pm, uint32_t now_ms, uint32_t sample_us) {
+  if (pm->state != POWER_ACTIVE && !pm->wake_start_us) {
+    pm->wake_start_us = sample_us ? sample_us : 1;
+    pm->wake_from = pm->state;
+  }
+  pm->last_activity_ms = now_ms;
+}
+
+void power_set_brightness(PowerManager *pm, uint8_t level) {
+  pm->brightness = level;
+}
+
+bool power_update(PowerManager *pm, uint32_t now_ms) {
+  uint32_t quiet = now_ms - pm->last_activity_ms;
+  PowerState next = quiet >= POWER_IDLE_AFTER_MS ? POWER_IDLE
+                  : quiet >= POWER_DIM_AFTER_MS  ? POWER_DIM
+                  : POWER_ACTIVE;
+  if (next == pm->state) return false;
+
+  PowerState prev = pm->state;
+  pm->stats.state_ms[prev] += now_ms - pm->state_since_ms;
+  pm->stats.entries[next]++;
+  pm->state = next;
+  pm->state_since_ms = now_ms;
+  apply_state(pm, prev, next);
+
+  // What the state just left costs: loop wake-ups and the UI's awake share,
+  // the firmware-side proxies for its current draw
+  const PowerStats *st = &pm->stats;
+  uint32_t ms = st->state_ms[prev] ? st->state_ms[prev] : 1;
+  Serial.printf("[POWER] %s -> %s after %lu ms quiet; %s so far: %lu s, %lu loops/s, UI busy %lu.%lu%%\n",
+                state_names[prev], state_names[next], quiet, state_names[prev], st->state_ms[prev] / 1000,
+                (uint32_t)((uint64_t)st->loops[prev] * 1000 / ms), st->busy_us[prev] / ms / 10, st->busy_us[prev] / ms % 10);
+  return true;
+}
+
+void power_wake_done(PowerManager *pm, uint32_t now_us) {
+  if (!pm->wake_start_us) return;
+
+  uint32_t dt = now_us - pm->wake_start_us;
+  PowerState s = pm->wake_from;
+  pm->stats.wakes[s]++;
+  pm->stats.wake_us[s] += dt;
+  if (dt > pm->stats.wake_max_us[s]) pm->stats.wake_max_us[s] = dt;
+  pm->wake_start_us = 0;
+
+  Serial.printf("[POWER] Touch wake from %s in %lu us\n", state_names[s], dt);
+}
+
+uint8_t power_backlight(const PowerManager *pm) {
+  switch (pm->state) {
+    case POWER_DIM: {
+      uint8_t level = pm->brightness / POWER_BACKLIGHT_DIM_DIV;
+      return level > POWER_BACKLIGHT_IDLE ? level : POWER_BACKLIGHT_IDLE;
+    }
+    case POWER_IDLE:
+      return pm->brightness < POWER_BACKLIGHT_IDLE ? pm->brightness : POWER_BACKLIGHT_IDLE;
+    default:
+      return pm->brightness;
+  }
+}
+
+bool power_backlight_begin(int pin) {
+  ledc_timer_config_t timer = {};
+  timer.speed_mode = LEDC_LOW_SPEED_MODE;        // RC_FAST only drives the low-speed timers
+  timer.duty_resolution = LEDC_TIMER_8_BIT;
+  timer.timer_num = POWER_BACKLIGHT_TIMER;
+  timer.freq_hz = POWER_BACKLIGHT_PWM_HZ;
+  timer.clk_cfg = POWER_LEDC_SLEEP_CLK;
+
+  ledc_channel_config_t channel = {};
+  channel.gpio_num = pin;
+  channel.speed_mode = LEDC_LOW_SPEED_MODE;
+  channel.channel = POWER_BACKLIGHT_CHANNEL;
+  channel.timer_sel = POWER_BACKLIGHT_TIMER;
+  channel.duty = 255;
+
+  esp_err_t err = ledc_timer_config(&timer);
+  if (err == ESP_OK) err = ledc_channel_config(&channel);
+  if (err != ESP_OK) {
+    Serial.printf("ERROR: [POWER] Backlight PWM on pin %d failed (%s), left as the display driver set it\n",
+                  pin, esp_err_to_name(err));
+    return false;
+  }
+  // Keep the PWM clock powered through light sleep
+  if (light_sleep) esp_sleep_pd_config(POWER_PD_SLEEP_CLK, ESP_PD_OPTION_ON);
+  backlight_on = true;
+  return true;
+}
+
+void power_backlight_write(uint8_t level) {
+  if (!backlight_on) return;
+  ledc_set_duty(LEDC_LOW_SPEED_MODE, POWER_BACKLIGHT_CHANNEL, level);
+  ledc_update_duty(LEDC_LOW_SPEED_MODE, POWER_BACKLIGHT_CHANNEL);
+}
+
+uint32_t power_cpu_mhz() {
+  return getCpuFrequencyMhz();
+}
+
+uint32_t power_loop_wait(PowerManager *pm, uint32_t lvgl_next_ms, uint32_t busy_us) {
+  pm->stats.loops[pm->state]++;
+  pm->stats.busy_us[pm->state] += busy_us;
+
+  if (lvgl_next_ms < POWER_LOOP_MIN_MS) return POWER_LOOP_MIN_MS;
+  if (lvgl_next_ms > POWER_LOOP_MAX_MS) return POWER_LOOP_MAX_MS;  // Also LV_NO_TIMER_READY
+  return lvgl_next_ms;
+}
+
+/* Light sleep stops the UART and TWAI clocks, so each bus is a wake-up
+ * source. The UART counts RX edges in sleep and wakes the chip after a few;
+ * only the character that woke it is lost, and the bus lock is back on for
+ * the frames that follow. */
+void power_bus_wake_uart(uart_port_t uart) {
+  if (!light_sleep) return;
+  if (uart_set_wakeup_threshold(uart, POWER_UART_WAKE_EDGES) != ESP_OK ||
+      esp_sleep_enable_uart_wakeup(uart) != ESP_OK) {
+    Serial.printf("ERROR: [POWER] UART%d cannot wake from light sleep, bus kept awake\n", (int)uart);
+    power_bus_active(true);        // Never released: this bus holds light sleep off for good
+  }
+}
+
+// TWAI has no wake-up of its own: its RX line idles high and a dominant bit pulls it low
+void power_bus_wake_pin(int rx_pin) {
+  if (light_sleep) gpio_wakeup_enable((gpio_num_t)rx_pin, GPIO_INTR_LOW_LEVEL);
+}
+
+void power_bus_active(bool active) {
+  if (!bus_sleep_lock) return;
+  if (active) esp_pm_lock_acquire(bus_sleep_lock);
+  else esp_pm_lock_release(bus_sleep_lock);
+}
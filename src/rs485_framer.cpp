@@ -0,0 +1,87 @@
+#include <string.h>
+
+#include "rs485_framer.h"
+#include "link_health.h"
+#include "hot_path.h"
+
+void rs485_framer_init(Rs485Framer *f) {
+  f->pos = 0;
+  f->consumed = 0;
+  f->truncated = 0;
+}
+
+// Drop what the last decode used up; only once its batch has been ingested
+HOT_CODE void rs485_framer_compact(Rs485Framer *f) {
+  if (f->consumed == 0) return;
+  memmove(f->buf, f->buf + f->consumed, f->pos - f->consumed);
+  f->pos -= f->consumed;
+  f->consumed = 0;
+}
+
+/* Frames are decoded where they lie. Junk in front of a frame (or in front of
+ * an incomplete frame still arriving) is counted as dropped; nothing before
+ * the frame being waited for can start one. A trailing STX1 is kept in case
+ * its STX2 is still on the wire. The buffer only fills up with a complete
+ * frame in it, so decoding always makes progress. */
+HOT_CODE uint8_t rs485_framer_decode(Rs485Framer *f, TelemetryBatch *batch) {
+  uint8_t *buf = f->buf;
+  uint16_t pos = f->pos;
+  uint16_t start = f->consumed;    // End of the last frame decoded
+  uint16_t waitFrom = pos;         // Start of an incomplete frame, if any
+  uint8_t decoded = 0;
+  uint16_t i = start;
+
+  while (i + 1 < pos) {
+    if (buf[i] != STX1 || buf[i+1] != STX2) {
+      i++;
+      continue;
+    }
+    if (i + 3 >= pos) {
+      waitFrom = i;
+      break;
+    }
+
+    uint16_t declaredLength = (buf[i+2] << 8) | buf[i+3];
+    uint32_t frameLength = (uint32_t)declaredLength + 6;
+
+    // A length we could never buffer is a false STX, not a frame to wait for
+    if (frameLength > FRAME_MAX_LEN || frameLength < FRAME_OVERHEAD) {
+      link_health_crc_error();
+      i++;
+      continue;
+    }
+    if (i + frameLength > pos) {
+      waitFrom = i;
+      break;
+    }
+    if (!validateFrame(&buf[i], frameLength)) {
+      link_health_crc_error();
+      i++;
+      continue;
+    }
+
+    uint8_t k = telemetry_batch_add(batch);
+    if (k == TRANSPORT_BATCH_MAX) {
+      waitFrom = i;                // Next call picks it up
+      break;
+    }
+    telemetry_parse_header(&buf[i], &batch->hdr[k]);
+    if (!telemetry_decode_fields(&buf[i + FRAME_INFO_OFFSET], frameLength - FRAME_OVERHEAD,
+                                 &batch->frame[k])) {
+      f->truncated++;              // Reported by the transport that owns the framer
+    }
+    batch->raw[k] = &buf[i];
+    batch->raw_len[k] = frameLength;
+    decoded++;
+
+    link_health_bytes_dropped(i - start);
+    i += frameLength;
+    start = i;
+  }
+
+  if (waitFrom == pos && pos > start && buf[pos-1] == STX1) waitFrom--;
+  if (waitFrom < start) waitFrom = start;
+  link_health_bytes_dropped(waitFrom - start);
+  f->consumed = waitFrom;
+  return decoded;
+}
@@ -0,0 +1,47 @@
+#include <Arduino.h>
+#include <string.h>
+
+#include "rs485_transport.h"
+#include "power_manager.h"
+
+/* One UART poll: sleep a poll period, then take everything the UART ring
+ * holds. A quiet bus is polled slowly; the ring covers the gap. */
+static uint8_t rs485_receive(TelemetryTransport *t, uint32_t wait_ms) {
+  Rs485Transport *r = (Rs485Transport *)t->ctx;
+  uint32_t poll_ms = t->quiet ? POWER_BUS_POLL_MS : RS485_POLL_MS;
+  vTaskDelay(pdMS_TO_TICKS(poll_ms < wait_ms ? poll_ms : wait_ms));
+
+  Rs485Framer *f = &r->framer;
+  rs485_framer_compact(f);
+  while (r->port->available() && f->pos < sizeof(f->buf)) {
+    int n = r->port->read(f->buf + f->pos, sizeof(f->buf) - f->pos);
+    if (n <= 0) break;
+    f->pos += n;
+    t->last_rx_ms = millis();
+  }
+
+  t->batch.count = 0;
+  uint32_t truncated = f->truncated;
+  uint8_t decoded = rs485_framer_decode(f, &t->batch);
+  if (f->truncated != truncated) {
+    Serial.printf("ERROR: [RS485] Truncated TLV, %lu frame(s) so far\n", (unsigned long)f->truncated);
+  }
+  return decoded;
+}
+
+static bool rs485_begin(TelemetryTransport *t) {
+  Rs485Transport *r = (Rs485Transport *)t->ctx;
+  rs485_framer_init(&r->framer);
+  power_bus_wake_uart(r->uart);
+  return true;
+}
+
+void rs485_transport_init(TelemetryTransport *t, Rs485Transport *ctx, HardwareSerial *port, uart_port_t uart) {
+  memset(t, 0, sizeof(*t));
+  ctx->port = port;
+  ctx->uart = uart;
+  t->name = "RS485";
+  t->begin = rs485_begin;
+  t->receive = rs485_receive;
+  t->ctx = ctx;
+}
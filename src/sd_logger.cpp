@@ -0,0 +1,175 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "sd_logger.h"
+#include "spi_bus.h"
+
+#define SD_LOG_RING_MASK  (SD_LOG_RING_LEN - 1)
+
+static_assert((SD_LOG_RING_LEN & SD_LOG_RING_MASK) == 0, "SD_LOG_RING_LEN must be a power of two");
+
+SdLogStats sdLog = {};
+
+// Single producer (telemetry ingest, under dataMutex), single consumer (writer task)
+static uint8_t ring[SD_LOG_RING_LEN];
+static std::atomic<uint32_t> ring_head(0);
+static std::atomic<uint32_t> ring_tail(0);
+
+static uint8_t staging[SD_LOG_BLOCK * SD_LOG_BATCH_BLOCKS];
+static File log_file;
+static uint32_t log_pos = 0;       // Bytes written to log_file
+static uint8_t log_cs;
+static SPIClass *log_spi = NULL;
+
+static void ring_put(uint32_t pos, const uint8_t *src, uint32_t n) {
+  uint32_t at = pos & SD_LOG_RING_MASK;
+  uint32_t first = n < SD_LOG_RING_LEN - at ? n : SD_LOG_RING_LEN - at;
+  memcpy(&ring[at], src, first);
+  memcpy(ring, src + first, n - first);
+}
+
+static void ring_get(uint32_t pos, uint8_t *dst, uint32_t n) {
+  uint32_t at = pos & SD_LOG_RING_MASK;
+  uint32_t first = n < SD_LOG_RING_LEN - at ? n : SD_LOG_RING_LEN - at;
+  memcpy(dst, &ring[at], first);
+  memcpy(dst + first, ring, n - first);
+}
+
+bool sd_log_frame(const uint8_t *frame, uint16_t len, uint32_t now_ms) {
+  if (!sdLog.active) return false;
+
+  uint32_t head = ring_head.load(std::memory_order_relaxed);
+  uint32_t need = 4 + len;
+  if (need > SD_LOG_RING_LEN - (head - ring_tail.load(std::memory_order_acquire))) {
+    sdLog.dropped++;
+    return false;
+  }
+
+  uint8_t stamp[4] = {
+    (uint8_t)now_ms, (uint8_t)(now_ms >> 8), (uint8_t)(now_ms >> 16), (uint8_t)(now_ms >> 24)
+  };
+  ring_put(head, stamp, 4);
+  ring_put(head + 4, frame, len);
+  ring_head.store(head + need, std::memory_order_release);
+  sdLog.records++;
+  return true;
+}
+
+/* Write n staged bytes a block at a time, holding the bus across blocks until
+ * the display asks for it. Returns the bytes written; short on a bus timeout
+ * (retried next period) or a write error (logging stops). */
+static uint32_t write_staged(uint32_t n) {
+  uint32_t done = 0;
+  while (done < n) {
+    if (!spi_bus_acquire(SPI_CLIENT_SD, SD_LOG_SYNC_MS)) break;
+
+    uint32_t t0 = micros();
+    bool failed = false;
+    do {
+      // Up to the next sector boundary of the file
+      uint32_t chunk = SD_LOG_BLOCK - log_pos % SD_LOG_BLOCK;
+      if (chunk > n - done) chunk = n - done;
+      if (log_file.write(&staging[done], chunk) != chunk) {
+        failed = true;
+        break;
+      }
+      done += chunk;
+      log_pos += chunk;
+    } while (done < n && !spi_bus_contended(SPI_CLIENT_SD));
+
+    uint32_t held = micros() - t0;
+    if (held > sdLog.hold_max_us) sdLog.hold_max_us = held;
+    if (done < n && !failed) spiBusStats.yields++;
+    spi_bus_release(SPI_CLIENT_SD);
+
+    if (failed) {
+      sdLog.write_errors++;
+      sdLog.active = false;
+      break;
+    }
+  }
+  sdLog.bytes_written += done;
+  return done;
+}
+
+static bool open_log_file() {
+  if (!SD.begin(log_cs, *log_spi, SD_LOG_SPI_HZ)) return false;
+
+  for (uint16_t n = 0; n < 10000; n++) {
+    snprintf(sdLog.path, sizeof(sdLog.path), "/tlm_%04u.bin", n);
+    if (!SD.exists(sdLog.path)) {
+      log_file = SD.open(sdLog.path, FILE_WRITE);
+      return (bool)log_file;
+    }
+  }
+  return false;
+}
+
+/* Ring to card. Staging copies happen off the bus; only the transfers and the
+ * periodic sync hold it. */
+static void sd_log_task(void *parameter) {
+  bool ok = false;
+  if (spi_bus_acquire(SPI_CLIENT_SD, SD_LOG_SYNC_MS)) {
+    ok = open_log_file();
+    if (!ok) SD.end();
+    spi_bus_release(SPI_CLIENT_SD);
+  }
+  if (!ok) {
+    Serial.println("ERROR: [SDLOG] No SD card or log file, telemetry recording off");
+    vTaskDelete(NULL);
+    return;
+  }
+  Serial.printf("[SDLOG] Recording telemetry to %s\n", sdLog.path);
+  sdLog.active = true;
+
+  uint32_t last_sync_ms = millis();
+  while (sdLog.active) {
+    vTaskDelay(pdMS_TO_TICKS(SD_LOG_PERIOD_MS));
+
+    bool sync_due = millis() - last_sync_ms >= SD_LOG_SYNC_MS;
+    uint32_t tail = ring_tail.load(std::memory_order_relaxed);
+    uint32_t pending = ring_head.load(std::memory_order_acquire) - tail;
+
+    // Between syncs, writes end on a sector boundary of the file; the sync
+    // writes the remainder and leaves the file mid-sector, and the next write
+    // completes that sector first. The rest waits for the next sync.
+    while (pending >= SD_LOG_BLOCK - log_pos % SD_LOG_BLOCK || (sync_due && pending)) {
+      uint32_t n = pending < sizeof(staging) ? pending : sizeof(staging);
+      if (!sync_due) n -= (log_pos + n) % SD_LOG_BLOCK;
+      ring_get(tail, staging, n);
+
+      uint32_t written = write_staged(n);
+      tail += written;
+      pending -= written;
+      ring_tail.store(tail, std::memory_order_release);
+      if (written < n) break;
+    }
+
+    if (sync_due && sdLog.active && spi_bus_acquire(SPI_CLIENT_SD, SD_LOG_SYNC_MS)) {
+      uint32_t t0 = micros();
+      log_file.flush();
+      uint32_t held = micros() - t0;
+      if (held > sdLog.hold_max_us) sdLog.hold_max_us = held;
+      spi_bus_release(SPI_CLIENT_SD);
+      last_sync_ms = millis();
+    }
+  }
+
+  Serial.println("ERROR: [SDLOG] SD write failed, telemetry recording stopped");
+  if (spi_bus_acquire(SPI_CLIENT_SD, SD_LOG_SYNC_MS)) {
+    log_file.close();
+    SD.end();
+    spi_bus_release(SPI_CLIENT_SD);
+  }
+  vTaskDelete(NULL);
+}
+
+void sd_log_begin(uint8_t cs_pin, SPIClass &spi) {
+  log_cs = cs_pin;
+  log_spi = &spi;
+  // Below the telemetry tasks on the same core: the ring absorbs the wait
+  xTaskCreatePinnedToCore(sd_log_task, "SD_Log", 4096, NULL, 1, NULL, 0);
+}
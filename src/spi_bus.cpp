@@ -0,0 +1,63 @@
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "spi_bus.h"
+
+SpiBusStats spiBusStats = {};
+
+static SemaphoreHandle_t bus_mutex = NULL;
+static volatile bool waiting[SPI_CLIENT_COUNT];
+static uint32_t held_since_us[SPI_CLIENT_COUNT];
+
+bool spi_bus_init() {
+  bus_mutex = xSemaphoreCreateMutex();
+  return bus_mutex != NULL;
+}
+
+bool spi_bus_contended(SpiClient c) {
+  for (uint8_t hi = 0; hi < c; hi++) {
+    if (waiting[hi]) return true;
+  }
+  return false;
+}
+
+/* The mutex's priority inheritance lifts the SD writer while a flush waits on
+ * it, so the flush is held up by at most the block in progress. */
+bool spi_bus_acquire(SpiClient c, uint32_t timeout_ms) {
+  uint32_t t0 = micros();
+  TickType_t start = xTaskGetTickCount();
+  TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+  bool ok = true;
+
+  waiting[c] = true;
+  while (spi_bus_contended(c)) {
+    if (xTaskGetTickCount() - start >= timeout) {
+      ok = false;
+      break;
+    }
+    vTaskDelay(1);
+  }
+  if (ok) {
+    TickType_t spent = xTaskGetTickCount() - start;
+    ok = xSemaphoreTake(bus_mutex, spent < timeout ? timeout - spent : 0) == pdTRUE;
+  }
+  waiting[c] = false;
+
+  uint32_t now = micros();
+  uint32_t dt = now - t0;
+  spiBusStats.wait_us[c] += dt;
+  if (dt > spiBusStats.wait_max_us[c]) spiBusStats.wait_max_us[c] = dt;
+  if (!ok) {
+    spiBusStats.timeouts[c]++;
+    return false;
+  }
+  spiBusStats.acquires[c]++;
+  held_since_us[c] = now;
+  return true;
+}
+
+void spi_bus_release(SpiClient c) {
+  spiBusStats.busy_us[c] += micros() - held_since_us[c];
+  xSemaphoreGive(bus_mutex);
+}
@@ -0,0 +1,140 @@
+#include "telemetry_nodes.h"
+
+BmsData bmsData = {};
+MotorData motorData = {};
+ChargerData chargerData = {};
+
+static uint32_t unrouted_frames = 0;
+
+#define BMS_FIELDS     (FIELD_BIT(FIELD_SOC) | FIELD_BIT(FIELD_VOLTAGE) | \
+                        FIELD_BIT(FIELD_CURRENT) | FIELD_BIT(FIELD_BATTERY_TEMP))
+#define MOTOR_FIELDS   (FIELD_MASK_ALL & ~BMS_FIELDS)
+
+// Routing table. The charger has no dashboard fields of its own: its voltage
+// and current are charger output, not pack values.
+static NodeRoute routes[] = {
+  { NODE_ADDR_LEGACY,  NODE_LEGACY,  "Legacy",  FIELD_MASK_ALL, 1000, {} },
+  { NODE_ADDR_BMS,     NODE_BMS,     "BMS",     BMS_FIELDS,     1000, {} },
+  { NODE_ADDR_MOTOR,   NODE_MOTOR,   "Motor",   MOTOR_FIELDS,   500,  {} },
+  { NODE_ADDR_CHARGER, NODE_CHARGER, "Charger", 0,              3000, {} },
+};
+
+#define ROUTE_COUNT (sizeof(routes) / sizeof(routes[0]))
+
+NodeRoute *telemetry_find_route(uint8_t address) {
+  for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+    if (routes[r].address == address) return &routes[r];
+  }
+  return nullptr;
+}
+
+static void store_bms(const TelemetryFrame *frame) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (!(frame->present & FIELD_BIT(f))) continue;
+    float v = telemetry_scale(f, frame->raw[f]);
+    switch (f) {
+      case FIELD_SOC:          bmsData.soc = (int)v; break;
+      case FIELD_VOLTAGE:      bmsData.voltage = v; break;
+      case FIELD_CURRENT:      bmsData.current = v; break;
+      case FIELD_BATTERY_TEMP: bmsData.temp = (int)v; break;
+    }
+  }
+}
+
+static void store_motor(const TelemetryFrame *frame) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (!(frame->present & FIELD_BIT(f))) continue;
+    float v = telemetry_scale(f, frame->raw[f]);
+    switch (f) {
+      case FIELD_SPEED:        motorData.speed = (int)v; break;
+      case FIELD_AMBIENT_TEMP: motorData.motor_temp = (int)v; break;
+      case FIELD_MODE:         motorData.mode = (uint8_t)frame->raw[f]; break;
+      case FIELD_ARMED:        motorData.armed = frame->raw[f] != 0; break;
+      case FIELD_RANGE:        motorData.range = (int)v; break;
+      case FIELD_CONSUMPTION:  motorData.avg_wkm = (int)v; break;
+      case FIELD_TRIP:         motorData.trip = (int)v; break;
+      case FIELD_ODOMETER:     motorData.odo = (int)v; break;
+      case FIELD_AVG_SPEED:    motorData.avg_kmh = (int)v; break;
+    }
+  }
+}
+
+static void store_charger(const TelemetryFrame *frame) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (!(frame->present & FIELD_BIT(f))) continue;
+    float v = telemetry_scale(f, frame->raw[f]);
+    switch (f) {
+      case FIELD_VOLTAGE:      chargerData.voltage = v; break;
+      case FIELD_CURRENT:      chargerData.current = v; break;
+      case FIELD_BATTERY_TEMP: chargerData.temp = (int)v; break;
+    }
+  }
+}
+
+/* Dispatch a decoded telemetry frame to its node store and refresh that
+ * node's freshness. Returns the route, or nullptr if the frame was dropped.
+ * The caller applies route->dash_fields of the frame to the dashboard. */
+NodeRoute *telemetry_route_frame(const FrameHeader *hdr, const TelemetryFrame *frame, uint32_t now_ms) {
+  NodeRoute *route = telemetry_find_route(hdr->source);
+  if (!route) {
+#if ROUTE_UNKNOWN_TO_LEGACY
+    route = &routes[0];
+#else
+    unrouted_frames++;
+    return nullptr;
+#endif
+  }
+
+  // Registered nodes must say what they are sending; legacy senders don't
+  if (route->kind != NODE_LEGACY && hdr->msg_type != MSG_TELEMETRY &&
+      hdr->msg_type != MSG_TELEMETRY_BULK) {
+    unrouted_frames++;
+    return nullptr;
+  }
+
+  switch (route->kind) {
+    case NODE_BMS:     store_bms(frame); break;
+    case NODE_MOTOR:   store_motor(frame); break;
+    case NODE_CHARGER: store_charger(frame); break;
+    default: break;
+  }
+
+  telemetry_seq_track(&route->state.seq, frame);
+  route->state.last_rx_ms = now_ms;
+  route->state.frames++;
+  route->state.seen = true;
+  return route;
+}
+
+/* Update the stale flag of every node that has ever been heard from.
+ * Returns how many nodes changed state. */
+uint8_t telemetry_check_staleness(uint32_t now_ms) {
+  uint8_t transitions = 0;
+  for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+    NodeRouteState *st = &routes[r].state;
+    if (!st->seen) continue;
+    bool stale = now_ms - st->last_rx_ms > routes[r].stale_after_ms;
+    if (stale != st->stale) {
+      st->stale = stale;
+      transitions++;
+    }
+  }
+  return transitions;
+}
+
+NodeRoute *telemetry_routes(uint8_t *count) {
+  *count = ROUTE_COUNT;
+  return routes;
+}
+
+uint32_t telemetry_unrouted_frames() {
+  return unrouted_frames;
+}
+
+/* Forget all freshness and sequence state (used by the bench simulation) */
+void telemetry_reset_routes() {
+  for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+    routes[r].state = NodeRouteState();
+  }
+  unrouted_frames = 0;
+}
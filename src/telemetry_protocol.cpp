@@ -0,0 +1,329 @@
+#include <string.h>
+
+#include "telemetry_protocol.h"
+#include "hot_path.h"
+
+// Wire ID for each TelemetryField, in field order
+HOT_DATA static const uint8_t field_ids[FIELD_COUNT] = {
+  ID_SOC, ID_VOLTAGE, ID_CURRENT, ID_TEMP, ID_SPEED, ID_MODE, ID_ARMED,
+  ID_RANGE, ID_CONSUMPTION, ID_AMBIENT_TEMP, ID_TRIP, ID_ODOMETER, ID_AVG_SPEED
+};
+
+// Payload size in bytes for each TelemetryField
+HOT_DATA static const uint8_t field_sizes[FIELD_COUNT] = {
+  1, 2, 2, 2, 2, 1, 1, 2, 2, 2, 2, 4, 2
+};
+
+// ===== CRC-16 Modbus Calculation =====
+// Byte-at-a-time table for the reflected polynomial 0xA001
+HOT_DATA static const uint16_t crc16_table[256] = {
+  0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+  0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+  0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+  0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+  0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+  0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+  0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+  0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+  0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+  0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+  0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+  0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+  0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+  0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+  0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+  0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+  0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+  0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+  0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+  0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+  0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+  0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+  0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+  0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+  0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+  0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+  0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+  0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+  0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+  0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+  0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+  0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+HOT_CODE uint16_t calculateChecksum(const uint8_t *data, uint16_t length) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t pos = 0; pos < length; pos++) {
+    crc = (crc >> 8) ^ crc16_table[(crc ^ data[pos]) & 0xFF];
+  }
+  return crc;
+}
+
+// ===== Frame Validation =====
+HOT_CODE bool validateFrame(const uint8_t* frame, uint16_t len) {
+  if (len < FRAME_OVERHEAD || len > FRAME_MAX_LEN || frame[0] != STX1 || frame[1] != STX2) {
+    return false;
+  }
+
+  uint16_t declaredLength = (frame[2] << 8) | frame[3];
+  uint32_t expectedLength = (uint32_t)declaredLength + 6;
+
+  if (len != expectedLength) {
+    return false;
+  }
+
+  uint16_t etxPos = 4 + declaredLength - 1;
+  if (frame[etxPos] != ETX) {
+    return false;
+  }
+
+  uint16_t calculatedChecksum = calculateChecksum(&frame[2], declaredLength + 2);
+  uint16_t receivedChecksum = (frame[len-2] << 8) | frame[len-1];
+
+  if (receivedChecksum != calculatedChecksum) {
+    return false;
+  }
+
+  return true;
+}
+
+HOT_CODE int8_t telemetry_field_for_id(uint8_t id) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (field_ids[f] == id) return (int8_t)f;
+  }
+  return -1;
+}
+
+uint8_t telemetry_id_for_field(uint8_t field) {
+  return field < FIELD_COUNT ? field_ids[field] : 0;
+}
+
+uint8_t telemetry_field_size(uint8_t field) {
+  return field < FIELD_COUNT ? field_sizes[field] : 0;
+}
+
+/* Engineering value for a raw wire value (see the ID_* precision notes) */
+float telemetry_scale(uint8_t field, uint32_t raw) {
+  switch (field) {
+    case FIELD_VOLTAGE:
+      return raw * 0.01f;
+    case FIELD_CURRENT:
+      // Sign-magnitude: bit 15 set means negative (regen/charging)
+      return (raw & 0x8000) ? -(int)(raw & 0x7FFF) * 0.01f : raw * 0.01f;
+    case FIELD_SOC:
+    case FIELD_MODE:
+    case FIELD_ARMED:
+      return (float)raw;
+    default:
+      return raw * 0.1f;
+  }
+}
+
+HOT_CODE void telemetry_parse_header(const uint8_t *frame, FrameHeader *hdr) {
+  hdr->source = frame[FRAME_HDR_SOURCE];
+  hdr->dest = frame[FRAME_HDR_DEST];
+  hdr->msg_type = frame[FRAME_HDR_MSG_TYPE];
+}
+
+/* Walk the TLV section of a validated frame. Only the fields actually present
+ * are marked in out->present, so delta frames leave everything else alone.
+ * Every read is checked against len; a TLV running past the end stops the
+ * walk and returns false, keeping whatever decoded before it. */
+HOT_CODE bool telemetry_decode_fields(const uint8_t *info, uint16_t len, TelemetryFrame *out) {
+  out->present = 0;
+  out->has_seq = false;
+  out->keyframe = true;
+  out->seq = 0;
+  out->has_time = false;
+  out->block_count = 0;
+
+  uint32_t j = 0;
+  while (j < len) {
+    uint8_t id = info[j++];
+    uint32_t left = len - j;
+
+    if (id >= ID_BLOCK_FIRST && id <= ID_BLOCK_LAST) {
+      if (left < 2) return false;
+      uint16_t n = (info[j] << 8) | info[j+1];
+      j += 2;
+      if (n > left - 2) return false;
+      if (out->block_count < TELEMETRY_MAX_BLOCKS) {
+        TelemetryBlock *b = &out->blocks[out->block_count++];
+        b->id = id;
+        b->len = n;
+        b->data = &info[j];
+      }
+      j += n;
+      continue;
+    }
+
+    if (id == ID_FRAME_SEQ) {
+      if (left < 2) return false;
+      uint16_t s = (info[j] << 8) | info[j+1];
+      out->has_seq = true;
+      out->keyframe = (s & FRAME_SEQ_KEYFRAME) != 0;
+      out->seq = s & FRAME_SEQ_MASK;
+      j += 2;
+      continue;
+    }
+
+    if (id == ID_TIME_OF_DAY) {
+      if (left < 2) return false;
+      out->has_time = true;
+      out->time_of_day = ((info[j] << 8) | info[j+1]) * 2UL;
+      j += 2;
+      continue;
+    }
+
+    int8_t field = telemetry_field_for_id(id);
+    if (field < 0) {
+      uint8_t skip = (id >= 0x80 && id <= 0x8F) ? 2 : 1;
+      if (left < skip) return false;
+      j += skip;
+      continue;
+    }
+
+    if (left < field_sizes[field]) return false;
+    uint32_t v = 0;
+    for (uint8_t k = 0; k < field_sizes[field]; k++) {
+      v = (v << 8) | info[j++];
+    }
+    out->raw[field] = v;
+    out->present |= FIELD_BIT(field);
+  }
+  return true;
+}
+
+/* Build a complete frame (header, TLVs for every present field, bulk blocks,
+ * trailer, CRC). Returns the frame length, or 0 if it does not fit in cap,
+ * exceeds FRAME_MAX_LEN or carries blocks without a MSG_TELEMETRY_BULK header. */
+uint16_t telemetry_encode_frame(uint8_t *out, uint16_t cap, const TelemetryFrame *frame,
+                                const FrameHeader *hdr) {
+  if (frame->block_count && (!hdr || hdr->msg_type != MSG_TELEMETRY_BULK)) return 0;
+
+  uint32_t info_len = (frame->has_seq ? 3 : 0) + (frame->has_time ? 3 : 0);
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (frame->present & FIELD_BIT(f)) info_len += 1 + field_sizes[f];
+  }
+  for (uint8_t b = 0; b < frame->block_count && b < TELEMETRY_MAX_BLOCKS; b++) {
+    info_len += 3 + frame->blocks[b].len;
+  }
+
+  uint32_t total = FRAME_OVERHEAD + info_len;
+  if (total > cap || total > FRAME_MAX_LEN) return 0;
+
+  uint16_t declaredLength = total - 6;
+  uint16_t p = 0;
+  out[p++] = STX1;
+  out[p++] = STX2;
+  out[p++] = declaredLength >> 8;
+  out[p++] = declaredLength & 0xFF;
+  memset(&out[p], 0, FRAME_HEADER_SIZE);
+  if (hdr) {
+    out[FRAME_HDR_SOURCE] = hdr->source;
+    out[FRAME_HDR_DEST] = hdr->dest;
+    out[FRAME_HDR_MSG_TYPE] = hdr->msg_type;
+  }
+  p += FRAME_HEADER_SIZE;
+
+  if (frame->has_seq) {
+    uint16_t s = (frame->seq & FRAME_SEQ_MASK) | (frame->keyframe ? FRAME_SEQ_KEYFRAME : 0);
+    out[p++] = ID_FRAME_SEQ;
+    out[p++] = s >> 8;
+    out[p++] = s & 0xFF;
+  }
+
+  if (frame->has_time) {
+    uint16_t t = (frame->time_of_day % 86400) / 2;
+    out[p++] = ID_TIME_OF_DAY;
+    out[p++] = t >> 8;
+    out[p++] = t & 0xFF;
+  }
+
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (!(frame->present & FIELD_BIT(f))) continue;
+    out[p++] = field_ids[f];
+    for (int8_t k = field_sizes[f] - 1; k >= 0; k--) {
+      out[p++] = (frame->raw[f] >> (8 * k)) & 0xFF;
+    }
+  }
+
+  for (uint8_t b = 0; b < frame->block_count && b < TELEMETRY_MAX_BLOCKS; b++) {
+    const TelemetryBlock *blk = &frame->blocks[b];
+    out[p++] = blk->id;
+    out[p++] = blk->len >> 8;
+    out[p++] = blk->len & 0xFF;
+    memcpy(&out[p], blk->data, blk->len);
+    p += blk->len;
+  }
+
+  memset(&out[p], 0, FRAME_TRAILER_SIZE);
+  p += FRAME_TRAILER_SIZE;
+  out[p++] = ETX;
+
+  uint16_t crc = calculateChecksum(&out[2], declaredLength + 2);
+  out[p++] = crc >> 8;
+  out[p++] = crc & 0xFF;
+  return p;
+}
+
+void telemetry_encoder_init(TelemetryEncoder *enc, uint16_t keyframe_interval) {
+  memset(enc, 0, sizeof(*enc));
+  enc->fields = FIELD_MASK_ALL;
+  enc->keyframe_interval = keyframe_interval ? keyframe_interval : 1;
+  enc->force_keyframe = true;
+}
+
+/* Encode the next frame for the given values: a keyframe on the interval (or
+ * when forced), otherwise a delta holding only the fields that changed since
+ * the previous frame. A receiver that misses a delta is out of date until the
+ * next keyframe; TelemetrySeqTracker flags that. */
+uint16_t telemetry_encoder_next(TelemetryEncoder *enc, const uint32_t *values,
+                                uint8_t *out, uint16_t cap) {
+  TelemetryFrame frame;
+  frame.has_seq = true;
+  frame.seq = enc->seq;
+  frame.keyframe = enc->force_keyframe || enc->since_keyframe + 1 >= enc->keyframe_interval;
+  frame.has_time = false;
+  frame.present = 0;
+  frame.block_count = 0;
+
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    frame.raw[f] = values[f];
+    if (!(enc->fields & FIELD_BIT(f))) continue;
+    if (frame.keyframe || values[f] != enc->last[f]) {
+      frame.present |= FIELD_BIT(f);
+    }
+  }
+
+  uint16_t len = telemetry_encode_frame(out, cap, &frame, &enc->header);
+  if (len == 0) return 0;
+
+  memcpy(enc->last, values, sizeof(enc->last));
+  enc->seq = (enc->seq + 1) & FRAME_SEQ_MASK;
+  enc->since_keyframe = frame.keyframe ? 0 : enc->since_keyframe + 1;
+  enc->force_keyframe = false;
+  return len;
+}
+
+void telemetry_seq_track(TelemetrySeqTracker *trk, const TelemetryFrame *frame) {
+  if (frame->keyframe) trk->keyframes++;
+  else trk->deltas++;
+
+  trk->gap = false;
+  if (frame->has_seq) {
+    uint16_t expected = (trk->last_seq + 1) & FRAME_SEQ_MASK;
+    if (trk->synced && frame->seq != expected) {
+      trk->gap = true;
+      trk->gaps++;
+      trk->lost_frames += (frame->seq - expected) & FRAME_SEQ_MASK;
+      trk->awaiting_keyframe = true;
+    }
+    trk->last_seq = frame->seq;
+    trk->synced = true;
+  }
+
+  if (frame->keyframe) {
+    trk->awaiting_keyframe = false;
+  }
+}
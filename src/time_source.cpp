@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "time_source.h"
+
+// Reference point: seconds_of_day was true at millis() == base_ms
+struct ClockBase {
+  bool     valid;
+  uint32_t seconds_of_day;
+  uint32_t base_ms;
+};
+
+static ClockBase bus_clock = {};
+static ClockBase rtc_clock = {};
+static portMUX_TYPE clock_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static SemaphoreHandle_t rtc_i2c_mutex = NULL;
+static bool rtc_present = false;
+static uint32_t rtc_last_read_ms = 0;
+static uint32_t rtc_last_write_ms = 0;
+static bool rtc_written = false;
+
+static uint8_t bcd_to_bin(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+static uint8_t bin_to_bcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+
+static uint32_t clock_now(const ClockBase *c, uint32_t now_ms) {
+  return (c->seconds_of_day + (now_ms - c->base_ms) / 1000) % 86400;
+}
+
+/* Probe for an RTC. Call after Wire.begin(); touch already shares the bus. */
+void time_source_begin(SemaphoreHandle_t i2c_mutex) {
+  rtc_i2c_mutex = i2c_mutex;
+
+  if(xSemaphoreTake(rtc_i2c_mutex, pdMS_TO_TICKS(50))) {
+    Wire.beginTransmission(RTC_I2C_ADDR);
+    rtc_present = Wire.endTransmission() == 0;
+    xSemaphoreGive(rtc_i2c_mutex);
+  }
+  Serial.printf("RTC %s\n", rtc_present ? "found" : "not found");
+}
+
+/* Called by the RS485 task when a frame carries ID_TIME_OF_DAY */
+void time_source_set_from_bus(uint32_t seconds_of_day, uint32_t now_ms) {
+  portENTER_CRITICAL(&clock_mux);
+  bus_clock.valid = true;
+  bus_clock.seconds_of_day = seconds_of_day % 86400;
+  bus_clock.base_ms = now_ms;
+  portEXIT_CRITICAL(&clock_mux);
+}
+
+static bool rtc_read(uint32_t now_ms) {
+  uint8_t regs[3];
+
+  Wire.beginTransmission(RTC_I2C_ADDR);
+  Wire.write(0x00);
+  if(Wire.endTransmission(false) != 0 || Wire.requestFrom(RTC_I2C_ADDR, 3) != 3) {
+    return false;
+  }
+  for(uint8_t k = 0; k < 3; k++) regs[k] = Wire.read();
+
+  uint8_t sec = bcd_to_bin(regs[0] & 0x7F);
+  uint8_t min = bcd_to_bin(regs[1] & 0x7F);
+  uint8_t hour;
+  if(regs[2] & 0x40) {
+    // 12 h mode: bit 5 = PM
+    hour = bcd_to_bin(regs[2] & 0x1F) % 12 + ((regs[2] & 0x20) ? 12 : 0);
+  } else {
+    hour = bcd_to_bin(regs[2] & 0x3F);
+  }
+  if(sec > 59 || min > 59 || hour > 23) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&clock_mux);
+  rtc_clock.valid = true;
+  rtc_clock.seconds_of_day = hour * 3600UL + min * 60UL + sec;
+  rtc_clock.base_ms = now_ms;
+  portEXIT_CRITICAL(&clock_mux);
+  return true;
+}
+
+static bool rtc_write(uint32_t seconds_of_day) {
+  Wire.beginTransmission(RTC_I2C_ADDR);
+  Wire.write(0x00);
+  Wire.write(bin_to_bcd(seconds_of_day % 60));
+  Wire.write(bin_to_bcd((seconds_of_day / 60) % 60));
+  Wire.write(bin_to_bcd(seconds_of_day / 3600));  // Bit 6 clear = 24 h mode
+  return Wire.endTransmission() == 0;
+}
+
+/* UI task, about once per second. Never waits for the I2C bus: if touch holds
+ * it, the RTC work is simply retried on the next call. */
+void time_source_poll(uint32_t now_ms) {
+  if(!rtc_present) {
+    return;
+  }
+
+  bool want_read = !rtc_clock.valid || now_ms - rtc_last_read_ms > RTC_RESYNC_MS;
+  bool want_write = time_source_kind(now_ms) == TIME_SRC_BUS &&
+                    (!rtc_written || now_ms - rtc_last_write_ms > RTC_WRITEBACK_MS);
+  if(!want_read && !want_write) {
+    return;
+  }
+
+  if(!xSemaphoreTake(rtc_i2c_mutex, 0)) {
+    return;
+  }
+  if(want_write) {
+    if(rtc_write(time_source_seconds_of_day(now_ms))) {
+      rtc_written = true;
+      rtc_last_write_ms = now_ms;
+      want_read = true;
+    }
+  }
+  if(want_read) {
+    rtc_read(now_ms);
+    rtc_last_read_ms = now_ms;
+  }
+  xSemaphoreGive(rtc_i2c_mutex);
+}
+
+TimeSourceKind time_source_kind(uint32_t now_ms) {
+  if(bus_clock.valid && now_ms - bus_clock.base_ms < BUS_TIME_VALID_MS) return TIME_SRC_BUS;
+  if(rtc_clock.valid) return TIME_SRC_RTC;
+  return TIME_SRC_NONE;
+}
+
+int32_t time_source_seconds_of_day(uint32_t now_ms) {
+  int32_t result = -1;
+  TimeSourceKind kind = time_source_kind(now_ms);
+
+  portENTER_CRITICAL(&clock_mux);
+  if(kind == TIME_SRC_BUS) result = clock_now(&bus_clock, now_ms);
+  else if(kind == TIME_SRC_RTC) result = clock_now(&rtc_clock, now_ms);
+  portEXIT_CRITICAL(&clock_mux);
+
+  return result;
+}
+
+void format_time_of_day(char *buf, size_t len, int32_t seconds_of_day, bool use_24h) {
+  if(seconds_of_day < 0) {
+    snprintf(buf, len, "--:--");
+    return;
+  }
+
+  int hours = seconds_of_day / 3600;
+  int minutes = (seconds_of_day / 60) % 60;
+
+  if(use_24h) {
+    snprintf(buf, len, "%d:%02d", hours, minutes);
+  } else {
+    int h12 = hours % 12;
+    snprintf(buf, len, "%d:%02d %s", h12 == 0 ? 12 : h12, minutes, hours < 12 ? "AM" : "PM");
+  }
+}
@@ -0,0 +1,282 @@
+#include <Arduino.h>
+#include <string.h>
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+
+#include "ui_alloc.h"
+
+#if LV_USE_STDLIB_MALLOC != LV_STDLIB_CUSTOM
+#error "ui_alloc.cpp is LVGL's allocator: build with -D LV_USE_STDLIB_MALLOC=LV_STDLIB_CUSTOM"
+#endif
+
+#define ALLOC_ALIGN   8
+
+struct PoolClass {
+  uint16_t size;
+  uint16_t blocks;
+};
+
+// Sized from a dashboard build: objects and their style arrays are 16-64 B
+static const PoolClass pool_classes[UI_POOL_CLASSES] = {
+  { 16, 256 }, { 32, 384 }, { 64, 256 }, { 128, 96 },
+};
+#define POOL_BYTES   (16 * 256 + 32 * 384 + 64 * 256 + 128 * 96)   // 44 KB
+
+struct Pool {
+  uint8_t *base;
+  uint8_t *end;
+  void    *free_list;          // Each free block holds the next one's address
+};
+
+// Arena blocks carry their size, for realloc; 8 bytes keeps the payload aligned
+struct ArenaHeader {
+  uint32_t size;
+  uint32_t reserved;
+};
+
+static uint8_t pool_mem[POOL_BYTES] __attribute__((aligned(ALLOC_ALIGN)));
+static uint8_t arena_mem[UI_ARENA_BYTES] __attribute__((aligned(ALLOC_ALIGN)));
+static Pool pools[UI_POOL_CLASSES];
+static bool arena_open = false;
+static TaskHandle_t arena_owner = NULL;   // Task building the screen; draw threads stay out
+static bool have_psram = false;
+static uint8_t alarms_reported = 0;
+static uint32_t fallbacks_seen = 0;
+static uint32_t pinned_seen = 0;
+
+static UiAllocStats stats;     // Counters; everything but the heap sample under alloc_lock
+static portMUX_TYPE alloc_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void lv_mem_init(void) {
+  uint8_t *p = pool_mem;
+  for (uint8_t c = 0; c < UI_POOL_CLASSES; c++) {
+    Pool *pool = &pools[c];
+    pool->base = p;
+    pool->free_list = NULL;
+    for (uint16_t i = 0; i < pool_classes[c].blocks; i++) {
+      *(void **)p = pool->free_list;
+      pool->free_list = p;
+      p += pool_classes[c].size;
+    }
+    pool->end = p;
+    stats.class_size[c] = pool_classes[c].size;
+    stats.class_blocks[c] = pool_classes[c].blocks;
+  }
+  have_psram = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+  stats.heap_largest_min = UINT32_MAX;
+}
+
+void lv_mem_deinit(void) {
+}
+
+// Pools are fixed; LVGL's extra-pool API has nothing to add them to
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes) {
+  LV_UNUSED(mem);
+  LV_UNUSED(bytes);
+  return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool) {
+  LV_UNUSED(pool);
+}
+
+static int8_t pool_of(const void *p) {
+  for (uint8_t c = 0; c < UI_POOL_CLASSES; c++) {
+    if (p >= pools[c].base && p < pools[c].end) return c;
+  }
+  return -1;
+}
+
+static bool in_arena(const void *p) {
+  return p >= arena_mem && p < arena_mem + UI_ARENA_BYTES;
+}
+
+// Smallest class that fits and has a free block
+static void *pool_alloc(size_t size) {
+  void *p = NULL;
+  portENTER_CRITICAL(&alloc_lock);
+  for (uint8_t c = 0; c < UI_POOL_CLASSES && !p; c++) {
+    if (size > pool_classes[c].size || !pools[c].free_list) continue;
+    p = pools[c].free_list;
+    pools[c].free_list = *(void **)p;
+    if (++stats.class_used[c] > stats.class_peak[c]) stats.class_peak[c] = stats.class_used[c];
+  }
+  if (!p) stats.pool_fallbacks++;
+  portEXIT_CRITICAL(&alloc_lock);
+  return p;
+}
+
+static void *arena_alloc(size_t size) {
+  uint32_t need = sizeof(ArenaHeader) + ((size + ALLOC_ALIGN - 1) & ~(ALLOC_ALIGN - 1));
+  ArenaHeader *h = NULL;
+  portENTER_CRITICAL(&alloc_lock);
+  if (arena_open && stats.arena_used + need <= UI_ARENA_BYTES) {
+    h = (ArenaHeader *)(arena_mem + stats.arena_used);
+    h->size = size;
+    stats.arena_used += need;
+    stats.arena_live++;
+    if (stats.arena_used > stats.arena_peak) stats.arena_peak = stats.arena_used;
+  } else if (arena_open) {
+    stats.arena_overflows++;
+  }
+  portEXIT_CRITICAL(&alloc_lock);
+  return h ? h + 1 : NULL;
+}
+
+void *lv_malloc_core(size_t size) {
+  if (size == 0) size = 1;
+  void *p = NULL;
+  if (arena_open && size <= UI_ARENA_MAX_ALLOC && xTaskGetCurrentTaskHandle() == arena_owner) {
+    p = arena_alloc(size);
+  }
+  if (!p && size <= pool_classes[UI_POOL_CLASSES - 1].size) p = pool_alloc(size);
+  if (p) return p;
+
+  bool psram = have_psram && size >= UI_PSRAM_MIN_ALLOC;
+  if (psram) p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!p) {
+    psram = false;
+    p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+
+  portENTER_CRITICAL(&alloc_lock);
+  if (p) stats.heap_live++;
+  else stats.failed++;
+  if (psram) stats.psram_allocs++;
+  portEXIT_CRITICAL(&alloc_lock);
+  return p;
+}
+
+void lv_free_core(void *p) {
+  if (!p) return;
+
+  if (in_arena(p)) {
+    // The last block out takes the whole arena with it
+    portENTER_CRITICAL(&alloc_lock);
+    if (--stats.arena_live == 0) {
+      stats.arena_used = 0;
+      stats.arena_resets++;
+    }
+    portEXIT_CRITICAL(&alloc_lock);
+    return;
+  }
+
+  int8_t c = pool_of(p);
+  if (c >= 0) {
+    portENTER_CRITICAL(&alloc_lock);
+    *(void **)p = pools[c].free_list;
+    pools[c].free_list = p;
+    stats.class_used[c]--;
+    portEXIT_CRITICAL(&alloc_lock);
+    return;
+  }
+
+  heap_caps_free(p);
+  portENTER_CRITICAL(&alloc_lock);
+  stats.heap_live--;
+  portEXIT_CRITICAL(&alloc_lock);
+}
+
+void *lv_realloc_core(void *p, size_t new_size) {
+  if (!p) return lv_malloc_core(new_size);
+
+  // Pool and arena blocks stay put while the new size fits, else move
+  size_t old_size = 0;
+  int8_t c = pool_of(p);
+  if (c >= 0) old_size = pool_classes[c].size;
+  else if (in_arena(p)) old_size = ((ArenaHeader *)p - 1)->size;
+  else return heap_caps_realloc(p, new_size, MALLOC_CAP_8BIT);
+
+  if (new_size <= old_size) return p;
+  void *q = lv_malloc_core(new_size);
+  if (!q) return NULL;
+  memcpy(q, p, old_size);
+  lv_free_core(p);
+  return q;
+}
+
+/* LVGL's view: the pools and the arena. frag_pct is the internal heap's, the
+ * only place fragmentation can build up. */
+void lv_mem_monitor_core(lv_mem_monitor_t *mon) {
+  UiAllocStats s;
+  ui_alloc_stats(&s);
+  memset(mon, 0, sizeof(*mon));
+  mon->total_size = POOL_BYTES + UI_ARENA_BYTES;
+
+  uint32_t used = s.arena_used, peak = s.arena_peak;
+  mon->free_biggest_size = UI_ARENA_BYTES - s.arena_used;
+  for (uint8_t c = 0; c < UI_POOL_CLASSES; c++) {
+    used += s.class_used[c] * s.class_size[c];
+    peak += s.class_peak[c] * s.class_size[c];
+    mon->free_cnt += s.class_blocks[c] - s.class_used[c];
+    mon->used_cnt += s.class_used[c];
+  }
+  mon->used_cnt += s.arena_live + s.heap_live;
+  mon->free_size = mon->total_size - used;
+  mon->max_used = peak;
+  mon->used_pct = used * 100 / mon->total_size;
+  mon->frag_pct = s.heap_frag_pct;
+}
+
+// Every free list stays inside its pool and no longer than the pool
+lv_result_t lv_mem_test_core(void) {
+  lv_result_t res = LV_RESULT_OK;
+  portENTER_CRITICAL(&alloc_lock);
+  for (uint8_t c = 0; c < UI_POOL_CLASSES && res == LV_RESULT_OK; c++) {
+    uint16_t n = 0;
+    for (void *p = pools[c].free_list; p; p = *(void **)p) {
+      if (pool_of(p) != c || ((uint8_t *)p - pools[c].base) % pool_classes[c].size ||
+          ++n > pool_classes[c].blocks) {
+        res = LV_RESULT_INVALID;
+        break;
+      }
+    }
+  }
+  portEXIT_CRITICAL(&alloc_lock);
+  return res;
+}
+
+void ui_alloc_arena_begin() {
+  portENTER_CRITICAL(&alloc_lock);
+  if (stats.arena_live) stats.arena_pinned++;   // New blocks stack on top of them
+  arena_owner = xTaskGetCurrentTaskHandle();
+  arena_open = true;
+  portEXIT_CRITICAL(&alloc_lock);
+}
+
+void ui_alloc_arena_end() {
+  arena_open = false;
+}
+
+void ui_alloc_stats(UiAllocStats *s) {
+  portENTER_CRITICAL(&alloc_lock);
+  *s = stats;
+  portEXIT_CRITICAL(&alloc_lock);
+}
+
+uint8_t ui_alloc_check() {
+  uint32_t free_b = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  uint8_t frag = free_b ? 100 - (uint64_t)largest * 100 / free_b : 0;
+
+  portENTER_CRITICAL(&alloc_lock);
+  stats.heap_free = free_b;
+  stats.heap_largest = largest;
+  if (largest < stats.heap_largest_min) stats.heap_largest_min = largest;
+  stats.heap_frag_pct = frag;
+
+  uint8_t alarms = 0;
+  if (largest < UI_HEAP_BLOCK_ALARM) alarms |= UI_ALARM_HEAP_BLOCK;
+  if (frag > UI_HEAP_FRAG_ALARM) alarms |= UI_ALARM_HEAP_FRAG;
+  if (stats.pool_fallbacks != fallbacks_seen) alarms |= UI_ALARM_POOL_FULL;
+  if (stats.arena_pinned != pinned_seen) alarms |= UI_ALARM_ARENA_PINNED;
+  fallbacks_seen = stats.pool_fallbacks;
+  pinned_seen = stats.arena_pinned;
+  stats.alarms = alarms;
+  portEXIT_CRITICAL(&alloc_lock);
+
+  // Report each alarm once when it goes up, again only after it cleared
+  uint8_t raised = alarms & ~alarms_reported;
+  alarms_reported = alarms;
+  return raised;
+}
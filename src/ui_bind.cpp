@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "ui_bind.h"
+
+static lv_subject_t field_subjects[DASH_FIELD_COUNT];
+static lv_subject_t stale_subject;   // DASH_FIELD_BIT mask of stale fields
+
+static bool field_is_centi(uint8_t field) {
+  return field == FIELD_VOLTAGE || field == FIELD_CURRENT ||
+         field == DERIVED_ENERGY_USED || field == DERIVED_ENERGY_REGEN;
+}
+
+void ui_bind_init() {
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    lv_subject_init_int(&field_subjects[f], 0);
+  }
+  lv_subject_init_int(&stale_subject, 0);
+}
+
+lv_subject_t *ui_bind_subject(uint8_t field) {
+  return field < DASH_FIELD_COUNT ? &field_subjects[field] : NULL;
+}
+
+int32_t ui_bind_value(uint8_t field) {
+  return field < DASH_FIELD_COUNT ? lv_subject_get_int(&field_subjects[field]) : 0;
+}
+
+void ui_bind_publish(uint8_t field, int32_t value) {
+  if (field >= DASH_FIELD_COUNT || lv_subject_get_int(&field_subjects[field]) == value) return;
+  lv_subject_set_int(&field_subjects[field], value);
+}
+
+void ui_bind_publish_stale(uint32_t stale_fields) {
+  if ((uint32_t)lv_subject_get_int(&stale_subject) == stale_fields) return;
+  lv_subject_set_int(&stale_subject, (int32_t)stale_fields);
+}
+
+static void stale_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  uint32_t fields = (uint32_t)(uintptr_t)lv_observer_get_user_data(observer);
+  lv_obj_t *obj = lv_observer_get_target_obj(observer);
+  lv_opa_t opa = ((uint32_t)lv_subject_get_int(subject) & fields) ? LV_OPA_40 : LV_OPA_COVER;
+  if (lv_obj_get_style_text_opa(obj, LV_PART_MAIN) != opa) {
+    lv_obj_set_style_text_opa(obj, opa, 0);
+  }
+}
+
+static void label_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  const char *fmt = (const char *)lv_observer_get_user_data(observer);
+  lv_obj_t *label = lv_observer_get_target_obj(observer);
+  int32_t v = lv_subject_get_int(subject);
+
+  char buf[48];
+  if (field_is_centi(subject - field_subjects)) snprintf(buf, sizeof(buf), fmt, v * 0.01f);
+  else snprintf(buf, sizeof(buf), fmt, (int)v);
+
+  if (strcmp(lv_label_get_text(label), buf) != 0) {
+    lv_label_set_text(label, buf);
+  }
+}
+
+void ui_bind_label(lv_obj_t *label, uint8_t field, const char *fmt) {
+  if (field >= DASH_FIELD_COUNT) return;
+  ui_bind_obj(label, DASH_FIELD_BIT(field), label_observer_cb, (void *)fmt);
+}
+
+void ui_bind_obj(lv_obj_t *obj, uint32_t fields, lv_observer_cb_t cb, void *user_data) {
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    if (fields & DASH_FIELD_BIT(f)) {
+      lv_subject_add_observer_obj(&field_subjects[f], cb, obj, user_data);
+    }
+  }
+  lv_subject_add_observer_obj(&stale_subject, stale_observer_cb, obj, (void *)(uintptr_t)fields);
+}
+
+static void clear_ref_cb(lv_event_t *e) {
+  lv_obj_t **ref = (lv_obj_t **)lv_event_get_user_data(e);
+  if (*ref == lv_event_get_target(e)) *ref = NULL;
+}
+
+void ui_bind_clear_on_delete(lv_obj_t **ref) {
+  if (*ref) lv_obj_add_event_cb(*ref, clear_ref_cb, LV_EVENT_DELETE, ref);
+}
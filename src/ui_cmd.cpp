@@ -0,0 +1,74 @@
+#include "ui_cmd.h"
+
+#define UI_CMD_QUEUE_MASK  (UI_CMD_QUEUE_LEN - 1)
+
+static_assert((UI_CMD_QUEUE_LEN & UI_CMD_QUEUE_MASK) == 0, "UI_CMD_QUEUE_LEN must be a power of two");
+
+UiCmdQueue ui_cmds;
+
+void ui_cmd_queue_init(UiCmdQueue *q) {
+  for (uint32_t i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+    q->slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+  q->head.store(0, std::memory_order_relaxed);
+  q->tail = 0;
+  q->dropped.store(0, std::memory_order_relaxed);
+}
+
+bool ui_cmd_queue_push(UiCmdQueue *q, const UiCmd *cmd) {
+  uint32_t pos = q->head.load(std::memory_order_relaxed);
+  UiCmdQueue::Slot *slot;
+  for (;;) {
+    slot = &q->slots[pos & UI_CMD_QUEUE_MASK];
+    int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      // Slot free for this lap: claim it (pos is reloaded on failure)
+      if (q->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      // Still holds last lap's command: full
+      q->dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = q->head.load(std::memory_order_relaxed);
+    }
+  }
+  slot->cmd = *cmd;
+  slot->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool ui_cmd_queue_pop(UiCmdQueue *q, UiCmd *out) {
+  UiCmdQueue::Slot *slot = &q->slots[q->tail & UI_CMD_QUEUE_MASK];
+  if (slot->seq.load(std::memory_order_acquire) != q->tail + 1) {
+    return false;  // Empty, or the producer has not finished writing it
+  }
+  *out = slot->cmd;
+  slot->seq.store(q->tail + UI_CMD_QUEUE_LEN, std::memory_order_release);
+  q->tail++;
+  return true;
+}
+
+static bool ui_cmd_coalesces(UiCmdType type) {
+  return type == UI_CMD_SCREEN || type == UI_CMD_BRIGHTNESS || type == UI_CMD_BANNER;
+}
+
+uint8_t ui_cmd_queue_collect(UiCmdQueue *q, UiCmd *out, uint8_t cap) {
+  uint8_t n = 0;
+  UiCmd cmd;
+  while (n < cap && ui_cmd_queue_pop(q, &cmd)) {
+    if (ui_cmd_coalesces(cmd.type)) {
+      uint8_t k = 0;
+      for (uint8_t i = 0; i < n; i++) {
+        if (out[i].type != cmd.type) out[k++] = out[i];
+      }
+      n = k;
+    }
+    out[n++] = cmd;
+  }
+  return n;
+}
+
+bool ui_cmd_post(UiCmdType type, int32_t arg, const char *text) {
+  UiCmd cmd = { type, arg, text };
+  return ui_cmd_queue_push(&ui_cmds, &cmd);
+}
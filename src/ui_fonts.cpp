@@ -0,0 +1,30 @@
+#include <stdio.h>
+
+#include "ui_fonts.h"
+#include "asset_store.h"
+
+#ifdef DASH_ASSET_FONTS
+
+const lv_font_t *ui_font(uint8_t px) {
+  char name[ASSET_NAME_LEN];
+  snprintf(name, sizeof(name), "montserrat_%u", px);
+  const lv_font_t *font = asset_font(name);
+  return font ? font : LV_FONT_DEFAULT;
+}
+
+#else
+
+const lv_font_t *ui_font(uint8_t px) {
+  switch(px) {
+    case 14: return &lv_font_montserrat_14;
+    case 16: return &lv_font_montserrat_16;
+    case 18: return &lv_font_montserrat_18;
+    case 20: return &lv_font_montserrat_20;
+    case 24: return &lv_font_montserrat_24;
+    case 32: return &lv_font_montserrat_32;
+    case 48: return &lv_font_montserrat_48;
+    default: return LV_FONT_DEFAULT;
+  }
+}
+
+#endif
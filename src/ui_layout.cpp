@@ -0,0 +1,95 @@
+#include "ui_layout.h"
+#include "ui_fonts.h"
+
+UiLayout ui_layout = {
+  UI_DESIGN_HOR_RES, UI_DESIGN_VER_RES, 256, UI_SIZE_COMPACT, 10, 6, 40, 10
+};
+
+// Font sizes ui_font() provides, ascending
+static const uint8_t font_sizes[] = { 14, 16, 18, 20, 24, 32, 48 };
+
+struct SizeTokens {
+  int32_t pad;
+  int32_t gap;
+  int32_t touch;
+  int32_t radius;
+};
+
+// Tokens grow slower than the scale: bigger panels get more content, not just bigger content
+static const SizeTokens size_tokens[UI_SIZE_CLASS_COUNT] = {
+  { 10,  6, 40, 10 },   // COMPACT
+  { 16, 10, 56, 14 },   // REGULAR
+  { 20, 12, 64, 16 },   // LARGE
+};
+
+static const char *size_class_names[UI_SIZE_CLASS_COUNT] = { "compact", "regular", "large" };
+
+const char *ui_size_class_name(UiSizeClass c) {
+  return c < UI_SIZE_CLASS_COUNT ? size_class_names[c] : "?";
+}
+
+void ui_layout_init(lv_display_t *disp) {
+  UiLayout *l = &ui_layout;
+  l->hor_res = lv_display_get_horizontal_resolution(disp);
+  l->ver_res = lv_display_get_vertical_resolution(disp);
+
+  uint32_t sx = l->hor_res * 256 / UI_DESIGN_HOR_RES;
+  uint32_t sy = l->ver_res * 256 / UI_DESIGN_VER_RES;
+  l->scale = sx < sy ? sx : sy;
+
+  int32_t short_side = l->hor_res < l->ver_res ? l->hor_res : l->ver_res;
+  l->size_class = short_side < 400 ? UI_SIZE_COMPACT : short_side < 560 ? UI_SIZE_REGULAR : UI_SIZE_LARGE;
+
+  const SizeTokens *t = &size_tokens[l->size_class];
+  l->pad = t->pad;
+  l->gap = t->gap;
+  l->touch = t->touch;
+  l->radius = t->radius;
+}
+
+int32_t ui_px(int32_t design_px) {
+  int32_t v = design_px * ui_layout.scale;
+  return v >= 0 ? (v + 128) / 256 : (v - 128) / 256;
+}
+
+const lv_font_t *ui_font_px(uint8_t design_px) {
+  int32_t want = ui_px(design_px);
+  uint8_t px = font_sizes[0];
+  for (uint8_t i = 0; i < sizeof(font_sizes); i++) {
+    if (font_sizes[i] <= want) px = font_sizes[i];
+  }
+  return ui_font(px);
+}
+
+static lv_obj_t *layout_box(lv_obj_t *parent) {
+  lv_obj_t *box = lv_obj_create(parent);
+  lv_obj_remove_style_all(box);
+  lv_obj_remove_flag(box, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_remove_flag(box, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_set_size(box, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+  return box;
+}
+
+lv_obj_t *ui_layout_row(lv_obj_t *parent, lv_flex_align_t main_place) {
+  lv_obj_t *row = layout_box(parent);
+  lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+  lv_obj_set_flex_align(row, main_place, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+  lv_obj_set_style_pad_column(row, ui_layout.gap, 0);
+  return row;
+}
+
+lv_obj_t *ui_layout_column(lv_obj_t *parent, lv_flex_align_t main_place, lv_flex_align_t cross_place) {
+  lv_obj_t *col = layout_box(parent);
+  lv_obj_set_flex_flow(col, LV_FLEX_FLOW_COLUMN);
+  lv_obj_set_flex_align(col, main_place, cross_place, cross_place);
+  lv_obj_set_style_pad_row(col, ui_layout.gap, 0);
+  return col;
+}
+
+lv_obj_t *ui_layout_grid(lv_obj_t *parent, const int32_t *col_dsc, const int32_t *row_dsc) {
+  lv_obj_t *grid = layout_box(parent);
+  lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
+  lv_obj_set_style_pad_column(grid, ui_layout.gap, 0);
+  lv_obj_set_style_pad_row(grid, ui_layout.gap, 0);
+  return grid;
+}
@@ -0,0 +1,102 @@
+#include <lvgl.h>
+
+#include "ui_os.h"
+
+#if LV_USE_OS != LV_OS_CUSTOM
+#error "ui_os.cpp is LVGL's OS layer: build with -D LV_USE_OS=LV_OS_CUSTOM"
+#endif
+
+/* A FreeRTOS task must not return: run the thread, then delete the task */
+static void thread_entry(void *arg) {
+  lv_thread_t *thread = (lv_thread_t *)arg;
+  thread->callback(thread->user_data);
+  thread->task = NULL;
+  vTaskDelete(NULL);
+}
+
+// Threads created so far; lv_init() creates the draw units one after another
+static uint8_t threads_created = 0;
+
+lv_result_t lv_thread_init(lv_thread_t *thread, const char *const name, lv_thread_prio_t prio,
+                           void (*callback)(void *), size_t stack_size, void *user_data) {
+  thread->callback = callback;
+  thread->user_data = user_data;
+  BaseType_t core = threads_created == 0 ? UI_OS_FIRST_THREAD_CORE
+                  : threads_created == 1 ? UI_OS_SECOND_THREAD_CORE
+                  : tskNO_AFFINITY;
+  BaseType_t ok = xTaskCreatePinnedToCore(thread_entry, name, stack_size / sizeof(StackType_t), thread,
+                                          tskIDLE_PRIORITY + prio, &thread->task, core);
+  if (ok != pdPASS) {
+    LV_LOG_ERROR("thread %s not created", name);
+    return LV_RESULT_INVALID;
+  }
+  threads_created++;
+  return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_delete(lv_thread_t *thread) {
+  if (thread->task) vTaskDelete(thread->task);
+  thread->task = NULL;
+  return LV_RESULT_OK;
+}
+
+lv_result_t lv_mutex_init(lv_mutex_t *mutex) {
+  mutex->sem = xSemaphoreCreateRecursiveMutex();
+  return mutex->sem ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_mutex_lock(lv_mutex_t *mutex) {
+  return xSemaphoreTakeRecursive(mutex->sem, portMAX_DELAY) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+// A recursive mutex cannot be taken from an ISR, and nothing calls LVGL from one
+lv_result_t lv_mutex_lock_isr(lv_mutex_t *mutex) {
+  LV_UNUSED(mutex);
+  return LV_RESULT_INVALID;
+}
+
+lv_result_t lv_mutex_unlock(lv_mutex_t *mutex) {
+  return xSemaphoreGiveRecursive(mutex->sem) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_mutex_delete(lv_mutex_t *mutex) {
+  vSemaphoreDelete(mutex->sem);
+  mutex->sem = NULL;
+  return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_init(lv_thread_sync_t *sync) {
+  sync->sem = xSemaphoreCreateBinary();
+  return sync->sem ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_thread_sync_wait(lv_thread_sync_t *sync) {
+  return xSemaphoreTake(sync->sem, portMAX_DELAY) == pdTRUE ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+lv_result_t lv_thread_sync_signal(lv_thread_sync_t *sync) {
+  xSemaphoreGive(sync->sem);       // Already signalled is fine: the waiter wakes once
+  return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_signal_isr(lv_thread_sync_t *sync) {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(sync->sem, &woken);
+  portYIELD_FROM_ISR(woken);
+  return LV_RESULT_OK;
+}
+
+lv_result_t lv_thread_sync_delete(lv_thread_sync_t *sync) {
+  vSemaphoreDelete(sync->sem);
+  sync->sem = NULL;
+  return LV_RESULT_OK;
+}
+
+void lv_sleep_ms(uint32_t ms) {
+  vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// Idle share of the LVGL timer loop, as without an OS; the HUD measures the cores itself
+uint32_t lv_os_get_idle_percent(void) {
+  return lv_timer_get_idle();
+}
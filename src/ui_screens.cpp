@@ -0,0 +1,607 @@
+#include <lvgl.h>
+
+#include "ui_screens.h"
+#include "ui_layout.h"
+#include "ui_fonts.h"
+#include "ui_alloc.h"
+#include "ui_bind.h"
+#include "ui_cmd.h"
+#include "cell_view.h"
+#include "digit_display.h"
+#include "layer_cache.h"
+
+#define SPEED_DIGITS 3
+#define SPEED_DIGIT_HEIGHT 68  // As tall as the digits of 96 px Montserrat (0.7 em)
+
+CellStore ui_cells;
+lv_obj_t *cell_map = NULL;
+
+static lv_obj_t *menu_btn = NULL;
+static lv_obj_t *sidebar = NULL;
+static lv_obj_t *overlay = NULL;
+bool sidebar_open = false;
+static lv_obj_t *sidebar_img = NULL;  // Sidebar snapshot while sliding (see SIDEBAR_SNAPSHOT_ANIM)
+static int32_t sidebar_img_ext = 0;   // Snapshot margin around the sidebar
+
+static void overlay_event_cb(lv_event_t *e);
+static void option_cb(lv_event_t *e);
+
+static void speed_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  digit_display_set_value(lv_observer_get_target_obj(observer), lv_subject_get_int(subject));
+}
+
+static void mode_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  static const char *const names[] = {"Eco", "City", "Sport"};
+  static const uint32_t colors[] = {0x00cc00, 0x0088ff, 0xff0000};
+  lv_obj_t *label = lv_observer_get_target_obj(observer);
+  int32_t mode = lv_subject_get_int(subject);
+  if (mode < MODE_ECO || mode > MODE_SPORT) return;
+  lv_label_set_text_static(label, names[mode]);
+  lv_obj_set_style_text_color(label, lv_color_hex(colors[mode]), 0);
+}
+
+static void armed_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+  lv_label_set_text_static(lv_observer_get_target_obj(observer),
+                           lv_subject_get_int(subject) ? "ARMED" : "DISARMED");
+}
+
+/* Sidebar slide. With SIDEBAR_SNAPSHOT_ANIM the sidebar is rendered into an
+ * RGB565 snapshot and the bitmap slides instead of the live widget tree, so a
+ * step draws one image rather than every button, label and rounded corner.
+ * Moving the image still invalidates its whole old and new area on each step;
+ * the frame rate of the slide has not been measured on the panel. The
+ * snapshot (about 140 KB of internal RAM at 480x320) exists only while the
+ * sidebar moves: it is taken when a slide starts and freed when it stops, and
+ * the live sidebar takes over. If it does not fit in RAM the live sidebar
+ * slides instead. */
+#define SIDEBAR_WIDTH           ui_px(220)
+#define SIDEBAR_ANIM_MS         300
+#define SIDEBAR_SNAPSHOT_ANIM   1
+
+static void sidebar_img_delete_cb(lv_event_t *e) {
+    lv_draw_buf_t *snap = (lv_draw_buf_t *)lv_event_get_user_data(e);
+    lv_image_cache_drop(snap);
+    lv_draw_buf_destroy(snap);
+    sidebar_img = NULL;
+}
+
+/* x in sidebar coordinates, for either the live sidebar or its bitmap */
+static void sidebar_anim_x_cb(void *var, int32_t v) {
+    lv_obj_set_x((lv_obj_t *)var, var == sidebar_img ? v - sidebar_img_ext : v);
+}
+
+/* Bitmap to slide in place of the live sidebar, NULL to slide the live one */
+static lv_obj_t *sidebar_slide_target() {
+#if SIDEBAR_SNAPSHOT_ANIM
+    if(!sidebar_img) {
+        lv_obj_update_layout(sidebar);
+        lv_draw_buf_t *snap = layer_cache_snapshot(sidebar);
+        if(!snap) {
+            LV_LOG_WARN("sidebar snapshot failed, sliding live");
+            return NULL;
+        }
+        sidebar_img_ext = lv_obj_get_ext_draw_size(sidebar);
+        sidebar_img = lv_image_create(lv_obj_get_parent(sidebar));
+        lv_image_set_src(sidebar_img, snap);
+        lv_obj_add_flag(sidebar_img, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(sidebar_img, LV_OBJ_FLAG_IGNORE_LAYOUT);
+        lv_obj_set_y(sidebar_img, lv_obj_get_y(sidebar) - sidebar_img_ext);
+        lv_obj_add_event_cb(sidebar_img, sidebar_img_delete_cb, LV_EVENT_DELETE, snap);
+    }
+    return sidebar_img;
+#else
+    return NULL;
+#endif
+}
+
+void toggle_sidebar() {
+    if(sidebar_open) {
+        close_sidebar();
+        sidebar_open = false;
+    } else {
+        show_sidebar();
+        sidebar_open = true;
+    }
+}
+
+void show_sidebar() {
+    if(!sidebar) {
+        // Create sidebar container
+        sidebar = lv_obj_create(lv_scr_act());
+        ui_bind_clear_on_delete(&sidebar);   // Goes with the screen when it is rebuilt
+        lv_obj_set_size(sidebar, SIDEBAR_WIDTH, LV_PCT(100));
+        lv_obj_align(sidebar, LV_ALIGN_LEFT_MID, -SIDEBAR_WIDTH, 0);
+        lv_obj_set_style_bg_color(sidebar, lv_color_hex(0x2C3E50), 0);
+        lv_obj_set_style_bg_opa(sidebar, LV_OPA_COVER, 0);
+        lv_obj_set_style_pad_all(sidebar, ui_layout.pad, 0);
+        lv_obj_set_flex_flow(sidebar, LV_FLEX_FLOW_COLUMN);
+        lv_obj_set_flex_align(sidebar, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+        lv_obj_set_style_pad_row(sidebar, ui_px(5), 0);
+        
+        // Add title
+        lv_obj_t *title = lv_label_create(sidebar);
+        lv_label_set_text(title, "VEHICLE INFO");
+        lv_obj_set_style_text_color(title, lv_color_white(), 0);
+        lv_obj_set_style_text_font(title, ui_font_px(18), 0);
+        lv_obj_set_style_pad_ver(title, ui_px(5), 0);
+        
+        // Menu items with icons
+        const char* menu_items[] = {
+            LV_SYMBOL_BATTERY_FULL " Battery",
+            LV_SYMBOL_CHARGE " Voltage",
+            LV_SYMBOL_WARNING " Temperature",
+            // LV_SYMBOL_LIST " Statistics",
+            // LV_SYMBOL_SETTINGS " Settings",
+            // LV_SYMBOL_HOME " Dashboard"
+            LV_SYMBOL_EYE_OPEN " Diagnostics",
+        };
+        const int menu_screens[] = { SCREEN_BATTERY, SCREEN_VOLTAGE, SCREEN_TEMPERATURE, SCREEN_DIAGNOSTICS };
+        
+        for(int i = 0; i < 4; i++) {
+            lv_obj_t *btn = lv_btn_create(sidebar);
+            lv_obj_set_width(btn, LV_PCT(100));
+            lv_obj_set_height(btn, ui_px(45));
+            lv_obj_set_style_bg_color(btn, lv_color_hex(0x34495E), 0);
+            lv_obj_set_style_radius(btn, ui_px(8), 0);
+            
+            lv_obj_set_style_bg_color(btn, lv_color_hex(0x4A6278), LV_STATE_PRESSED);
+            
+            lv_obj_t *label = lv_label_create(btn);
+            lv_label_set_text(label, menu_items[i]);
+            lv_obj_set_style_text_color(label, lv_color_white(), 0);
+            lv_obj_set_style_text_font(label, ui_font_px(14), 0);
+            lv_obj_align(label, LV_ALIGN_LEFT_MID, ui_px(10), 0);
+            
+            lv_obj_add_event_cb(btn, option_cb, LV_EVENT_CLICKED, (void*)(uintptr_t)menu_screens[i]);
+        }
+        
+        // Create overlay
+        overlay = lv_obj_create(lv_scr_act());
+        ui_bind_clear_on_delete(&overlay);
+        lv_obj_remove_style_all(overlay);
+        lv_obj_set_size(overlay, LV_PCT(100), LV_PCT(100));
+        lv_obj_set_pos(overlay, SIDEBAR_WIDTH, 0); 
+        lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(overlay, LV_OPA_0, 0);
+        lv_obj_add_event_cb(overlay, overlay_event_cb, LV_EVENT_CLICKED, NULL);
+    }
+    
+    // Show sidebar with animation
+    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_t *target = sidebar_slide_target();
+    if(target) {
+        // Live sidebar waits, hidden, at its final position
+        lv_obj_add_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_x(sidebar, 0);
+        lv_obj_clear_flag(target, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_clear_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+        target = sidebar;
+    }
+    
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, target);
+    lv_anim_set_values(&a, -SIDEBAR_WIDTH, 0);
+    lv_anim_set_time(&a, SIDEBAR_ANIM_MS);
+    lv_anim_set_exec_cb(&a, sidebar_anim_x_cb);
+    lv_anim_set_ready_cb(&a, [](lv_anim_t* a) {
+        if(a->var == sidebar_img) {
+            lv_obj_clear_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_delete(sidebar_img);   // Frees the snapshot
+        }
+    });
+    lv_anim_start(&a);
+}
+
+void close_sidebar() {
+    if(sidebar) {
+        // Start from wherever the sidebar (or its bitmap, if still opening) is now
+        bool sliding_img = sidebar_img && !lv_obj_has_flag(sidebar_img, LV_OBJ_FLAG_HIDDEN);
+        int32_t from = sliding_img ? lv_obj_get_x(sidebar_img) + sidebar_img_ext : lv_obj_get_x(sidebar);
+
+        lv_obj_t *target = sliding_img ? sidebar_img : sidebar_slide_target();
+        if(target) {
+            lv_obj_add_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_clear_flag(target, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            target = sidebar;
+        }
+
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, target);
+        lv_anim_set_values(&a, from, -SIDEBAR_WIDTH);
+        lv_anim_set_time(&a, SIDEBAR_ANIM_MS);
+        lv_anim_set_exec_cb(&a, sidebar_anim_x_cb);
+        lv_anim_set_ready_cb(&a, [](lv_anim_t* a) {
+            if(a->var == sidebar_img) lv_obj_delete(sidebar_img);   // Frees the snapshot
+            else lv_obj_add_flag((lv_obj_t*)a->var, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+        });
+        lv_anim_start(&a);
+    }
+}
+
+void overlay_event_cb(lv_event_t *e) {
+    if(lv_event_get_code(e) == LV_EVENT_CLICKED) {  // Use the getter function
+        close_sidebar();
+        sidebar_open = false;
+    }
+}
+
+static void option_cb(lv_event_t *e) {
+    uint32_t id = (uint32_t)(uintptr_t)lv_event_get_user_data(e);
+    
+    // ONLY hide, set flag, and return
+    if(sidebar) {
+        lv_obj_add_flag(sidebar, LV_OBJ_FLAG_HIDDEN);
+    }
+    if(overlay) {
+        lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+    }
+    
+    sidebar_open = false;
+    ui_cmd_post(UI_CMD_SCREEN, id);  // Let UI task handle it
+    
+    // DON'T call show_battery_screen() here!
+}
+
+void sidebar_delete() {
+    if(sidebar) {
+        lv_obj_delete(sidebar);
+        sidebar = NULL;
+    }
+    if(overlay) {
+        lv_obj_delete(overlay);
+        overlay = NULL;
+    }
+    if(sidebar_img) {
+        lv_obj_delete(sidebar_img);
+    }
+}
+
+/* Dashboard body: the centre cluster takes what it needs, the two info
+ * columns share the rest */
+static const int32_t dash_cols[] = { LV_GRID_FR(1), LV_GRID_CONTENT, LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+static const int32_t dash_rows[] = { LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+
+static lv_obj_t *dash_value_label(lv_obj_t *parent, uint8_t field, const char *fmt, uint8_t px) {
+  lv_obj_t *label = lv_label_create(parent);
+  ui_bind_label(label, field, fmt);
+  lv_obj_set_style_text_color(label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(label, ui_font_px(px), 0);
+  return label;
+}
+
+// White full-width strip with its items spread across it
+static lv_obj_t *dash_bar(lv_obj_t *parent, int32_t height) {
+  lv_obj_t *bar = ui_layout_row(parent, LV_FLEX_ALIGN_SPACE_BETWEEN);
+  lv_obj_set_size(bar, LV_PCT(100), height);
+  lv_obj_set_style_bg_color(bar, lv_color_white(), 0);
+  lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, 0);
+  return bar;
+}
+
+/* Create EV Dashboard UI */
+void create_ev_dashboard_ui() {
+  lv_obj_t *scr = lv_scr_act();
+  lv_obj_clean(scr);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  // Widgets from here on belong to this build (the screen's own styles
+  // above do not)
+  ui_alloc_arena_begin();
+
+  // Bars and body stacked to fill the panel; the sidebar opens over it
+  lv_obj_t *root = ui_layout_column(scr, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER);
+  lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+  lv_obj_set_style_pad_row(root, 0, 0);
+
+  /* Top bar */
+  lv_obj_t *top_bar = dash_bar(root, ui_px(45));
+  lv_obj_set_style_pad_right(top_bar, ui_layout.pad, 0);
+
+  // Create menu button
+  menu_btn = lv_btn_create(top_bar);
+  lv_obj_set_size(menu_btn, ui_px(50), LV_PCT(100));
+  lv_obj_add_flag(menu_btn, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_clear_flag(menu_btn, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
+  lv_obj_set_style_bg_color(menu_btn, lv_color_hex(0x333333), 0);
+
+  // Create menu symbol
+  lv_obj_t *menu_label = lv_label_create(menu_btn);
+  lv_label_set_text(menu_label, LV_SYMBOL_BARS);
+  lv_obj_set_style_text_font(menu_label, ui_font_px(20), 0);
+  lv_obj_center(menu_label);
+
+  // Add event handler - Simplified version
+  lv_obj_add_event_cb(menu_btn, [](lv_event_t *e) {
+      if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
+          toggle_sidebar();
+      }
+  }, LV_EVENT_CLICKED, NULL);
+  
+  lv_obj_t *time_label = lv_label_create(top_bar);
+  lv_obj_set_style_text_color(time_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(time_label, ui_font_px(18), 0);
+  time_display_attach(time_label);
+
+  lv_obj_t *map_btn = lv_label_create(top_bar);
+  lv_label_set_text(map_btn, "Map");
+  lv_obj_set_style_text_font(map_btn, ui_font_px(16), 0);
+
+  /* Body: info | speed cluster | info */
+  lv_obj_t *body = ui_layout_grid(root, dash_cols, dash_rows);
+  lv_obj_set_width(body, LV_PCT(100));
+  lv_obj_set_flex_grow(body, 1);
+  lv_obj_set_style_pad_hor(body, ui_layout.pad, 0);
+
+  /* Left side info */
+  lv_obj_t *left = ui_layout_column(body, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_START);
+  lv_obj_set_grid_cell(left, LV_GRID_ALIGN_STRETCH, 0, 1, LV_GRID_ALIGN_STRETCH, 0, 1);
+  dash_value_label(left, DERIVED_RANGE, "Range: %d km", 16);
+  dash_value_label(left, DERIVED_AVG_WKM, "Avg. con: %d Wh/km", 16);
+  dash_value_label(left, FIELD_VOLTAGE, "Volt: %.2f V", 16);
+  dash_value_label(left, FIELD_CURRENT, "Current: %.2f A", 16);
+
+  /* Centre: status, speed, mode */
+  lv_obj_t *centre = ui_layout_column(body, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_CENTER);
+  lv_obj_set_grid_cell(centre, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_STRETCH, 0, 1);
+  lv_obj_set_style_pad_row(centre, 0, 0);
+
+  /* Status badge */
+  lv_obj_t *status_badge = lv_obj_create(centre);
+  lv_obj_set_size(status_badge, ui_px(140), ui_px(49));
+  lv_obj_set_style_bg_color(status_badge, lv_color_hex(0x333333), 0);
+  lv_obj_set_style_radius(status_badge, ui_px(20), 0);
+  lv_obj_set_style_border_width(status_badge, 0, 0);
+
+  lv_obj_t *status_label = lv_label_create(status_badge);
+  ui_bind_obj(status_label, FIELD_BIT(FIELD_ARMED), armed_observer_cb, NULL);
+  lv_obj_set_style_text_color(status_label, lv_color_white(), 0);
+  lv_obj_set_style_text_font(status_label, ui_font_px(16), 0);
+  lv_obj_center(status_label);
+
+  /* Main speed display: fixed-width cached digits, only changed cells redraw.
+   * Glyphs from the largest UI font, scaled up to the readout's size */
+  lv_obj_t *speed_label = digit_display_create(centre, SPEED_DIGITS, ui_px(SPEED_DIGIT_HEIGHT));
+  lv_obj_set_style_text_font(speed_label, ui_font(48), 0);
+  lv_obj_set_style_text_color(speed_label, lv_color_black(), 0);
+  ui_bind_obj(speed_label, FIELD_BIT(FIELD_SPEED), speed_observer_cb, NULL);
+
+  lv_obj_t *kmh_label = lv_label_create(centre);
+  lv_label_set_text(kmh_label, "Km/h");
+  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(kmh_label, ui_font_px(16), 0);
+
+  /* Mode selector, as wide as the badge so the info columns keep their room */
+  lv_obj_t *mode_container = lv_obj_create(centre);
+  lv_obj_set_size(mode_container, ui_px(140), ui_px(80));
+  lv_obj_set_style_bg_color(mode_container, lv_color_white(), 0);
+  lv_obj_set_style_radius(mode_container, ui_layout.radius, 0);
+  lv_obj_set_style_border_width(mode_container, 0, 0);
+
+  lv_obj_t *mode_text = lv_label_create(mode_container);
+  lv_label_set_text(mode_text, "Mode");
+  lv_obj_set_style_text_color(mode_text, lv_color_black(), 0);
+  lv_obj_set_style_text_font(mode_text, ui_font_px(16), 0);
+  lv_obj_align(mode_text, LV_ALIGN_TOP_MID, 0, ui_px(3));
+
+  lv_obj_t *mode_label = lv_label_create(mode_container);
+  lv_obj_set_style_text_font(mode_label, ui_font_px(20), 0);
+  ui_bind_obj(mode_label, FIELD_BIT(FIELD_MODE), mode_observer_cb, NULL);
+  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, ui_px(15));
+
+  /* Right side info */
+  lv_obj_t *right = ui_layout_column(body, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_END);
+  lv_obj_set_grid_cell(right, LV_GRID_ALIGN_STRETCH, 2, 1, LV_GRID_ALIGN_STRETCH, 0, 1);
+  dash_value_label(right, FIELD_AMBIENT_TEMP, "Motor: %d°C", 16);
+  dash_value_label(right, FIELD_BATTERY_TEMP, "Battery: %d°C", 16);
+  dash_value_label(right, FIELD_SOC, "SoC: %d%%", 16);
+
+  /* Bottom bar */
+  lv_obj_t *bottom_bar = dash_bar(root, ui_px(50));
+  lv_obj_set_style_pad_hor(bottom_bar, ui_layout.pad, 0);
+  dash_value_label(bottom_bar, FIELD_TRIP, "TRIP: %d km", 14);
+  dash_value_label(bottom_bar, FIELD_ODOMETER, "ODO: %d km", 14);
+  dash_value_label(bottom_bar, FIELD_AVG_SPEED, "Avg. SPEED: %d km/h", 14);
+
+  // Baking renders: keep its scratch blocks out of the arena
+  ui_alloc_arena_end();
+
+  /* Rounded cards and fixed captions never change: render them once */
+  layer_cache_bake(status_badge, &status_label, 1, 0);
+  layer_cache_bake(mode_container, &mode_label, 1, 0);
+  layer_cache_bake(kmh_label, NULL, 0, 0);
+
+}
+
+static void arc_observer_cb(lv_observer_t *observer, lv_subject_t *subject) {
+    lv_arc_set_value(lv_observer_get_target_obj(observer), lv_subject_get_int(subject));
+}
+
+/* Header row of the detail screens: back button, centred title, and an
+ * optional slot on the right */
+static const int32_t header_cols[] = { LV_GRID_FR(1), LV_GRID_CONTENT, LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+static const int32_t header_rows[] = { LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST };
+
+lv_obj_t *screen_frame(const char *title_text, uint32_t bg, lv_obj_t **right) {
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_clean(scr);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(bg), 0);
+    ui_alloc_arena_begin();   // Ended by the caller once its widgets are in place
+
+    lv_obj_t *root = ui_layout_column(scr, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_pad_all(root, ui_layout.pad, 0);
+
+    lv_obj_t *header = ui_layout_grid(root, header_cols, header_rows);
+    lv_obj_set_width(header, LV_PCT(100));
+
+    lv_obj_t *back_btn = lv_btn_create(header);
+    lv_obj_set_size(back_btn, ui_px(80), ui_layout.touch);
+    lv_obj_set_grid_cell(back_btn, LV_GRID_ALIGN_START, 0, 1, LV_GRID_ALIGN_CENTER, 0, 1);
+    lv_obj_set_style_bg_color(back_btn, lv_color_hex(0x333333), 0);
+    lv_obj_t *back_label = lv_label_create(back_btn);
+    lv_label_set_text(back_label, LV_SYMBOL_LEFT " Back");
+    lv_obj_set_style_text_font(back_label, ui_font_px(14), 0);
+    lv_obj_center(back_label);
+    // Rebuilding here would delete the button under its own event: let uiTask switch
+    lv_obj_add_event_cb(back_btn, [](lv_event_t *e) {
+        if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            ui_cmd_post(UI_CMD_SCREEN, SCREEN_DASHBOARD);
+        }
+    }, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *title = lv_label_create(header);
+    lv_label_set_text(title, title_text);
+    lv_obj_set_style_text_font(title, ui_font_px(24), 0);
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    lv_obj_set_grid_cell(title, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_CENTER, 0, 1);
+
+    if(right) {
+        *right = ui_layout_row(header, LV_FLEX_ALIGN_END);
+        lv_obj_set_grid_cell(*right, LV_GRID_ALIGN_END, 2, 1, LV_GRID_ALIGN_CENTER, 0, 1);
+    }
+
+    lv_obj_t *content = ui_layout_column(root, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_width(content, LV_PCT(100));
+    lv_obj_set_flex_grow(content, 1);
+    return content;
+}
+
+static lv_obj_t *screen_value_label(lv_obj_t *parent, uint8_t field, const char *fmt,
+                                    uint8_t px, uint32_t color) {
+    lv_obj_t *label = lv_label_create(parent);
+    ui_bind_label(label, field, fmt);
+    lv_obj_set_style_text_color(label, lv_color_hex(color), 0);
+    lv_obj_set_style_text_font(label, ui_font_px(px), 0);
+    return label;
+}
+
+// Two equal columns, as many content-sized rows as needed (up to four)
+static const int32_t two_cols[] = { LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST };
+static const int32_t four_rows[] = { LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT,
+                                     LV_GRID_TEMPLATE_LAST };
+
+static void grid_place(lv_obj_t *obj, uint8_t col, uint8_t row) {
+    lv_obj_set_grid_cell(obj, LV_GRID_ALIGN_START, col, 1, LV_GRID_ALIGN_CENTER, row, 1);
+}
+
+void show_battery_screen() {
+    lv_obj_t *content = screen_frame("BATTERY INFO", 0x0f1419, NULL);
+
+    lv_obj_t *top = ui_layout_row(content, LV_FLEX_ALIGN_SPACE_BETWEEN);
+    lv_obj_set_width(top, LV_PCT(100));
+    
+    // Battery SOC Arc, percentage in the middle
+    lv_obj_t *arc = lv_arc_create(top);
+    lv_obj_set_size(arc, ui_px(150), ui_px(150));
+    lv_arc_set_range(arc, 0, 100);
+    ui_bind_obj(arc, FIELD_BIT(FIELD_SOC), arc_observer_cb, NULL);
+    lv_obj_set_style_arc_color(arc, lv_color_hex(0x00ff00), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_width(arc, ui_px(16), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_width(arc, ui_px(16), LV_PART_MAIN);
+
+    lv_obj_t *soc_label = screen_value_label(arc, FIELD_SOC, "%d%%", 32, 0xffffff);
+    lv_obj_center(soc_label);
+    
+    // Per-cell heatmap, tap for temperatures
+    cell_map = cell_view_create(top, &ui_cells, ui_px(285), ui_px(170));
+    lv_obj_set_style_text_font(cell_map, ui_font_px(14), 0);
+    lv_obj_set_style_text_color(cell_map, lv_color_white(), 0);
+    ui_bind_clear_on_delete(&cell_map);
+    
+    // Details
+    lv_obj_t *details = ui_layout_grid(content, two_cols, four_rows);
+    lv_obj_set_width(details, LV_PCT(100));
+    grid_place(screen_value_label(details, FIELD_VOLTAGE, "Voltage: %.2f V", 18, 0xffffff), 0, 0);
+    grid_place(screen_value_label(details, FIELD_BATTERY_TEMP, "Temp: %d°C", 18, 0xffffff), 1, 0);
+    grid_place(screen_value_label(details, FIELD_CURRENT, "Current: %.2f A", 18, 0xffffff), 0, 1);
+    
+    ui_alloc_arena_end();     // Before the bake renders
+    layer_cache_bake(arc, &soc_label, 1, LAYER_LIVE_INDICATOR | LAYER_LIVE_KNOB);  // Track only
+    lv_refr_now(lv_display_get_default());
+}
+
+void show_voltage_screen() {
+    lv_obj_t *content = screen_frame("VOLTAGE MONITOR", 0x0f1419, NULL);
+
+    lv_obj_t *values = ui_layout_column(content, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    screen_value_label(values, FIELD_VOLTAGE, "%.2f V", 48, 0x00ffff);
+    screen_value_label(values, FIELD_CURRENT, "Current: %.2f A", 20, 0xffffff);
+    screen_value_label(values, DERIVED_POWER, "Power: %d W", 20, 0xffffff);
+    
+    ui_alloc_arena_end();
+    lv_refr_now(lv_display_get_default());
+}
+
+// Caption on top, value in the middle
+static void temperature_card(lv_obj_t *parent, const char *caption, uint8_t field,
+                             uint32_t bg, uint32_t color) {
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_set_size(card, ui_px(200), ui_px(100));
+    lv_obj_set_style_bg_color(card, lv_color_hex(bg), 0);
+    lv_obj_set_style_radius(card, ui_layout.radius, 0);
+
+    lv_obj_t *title = lv_label_create(card);
+    lv_label_set_text(title, caption);
+    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    lv_obj_set_style_text_font(title, ui_font_px(14), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 0);
+
+    lv_obj_t *value = screen_value_label(card, field, "%d°C", 32, color);
+    lv_obj_align(value, LV_ALIGN_CENTER, 0, ui_px(10));
+}
+
+void show_temperature_screen() {
+    lv_obj_t *content = screen_frame("TEMPERATURE", 0x2a1a1a, NULL);
+
+    // Side by side where the panel is wide enough, stacked otherwise
+    lv_obj_t *cards = ui_layout_column(content, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    if(ui_layout.size_class != UI_SIZE_COMPACT) lv_obj_set_flex_flow(cards, LV_FLEX_FLOW_ROW);
+    lv_obj_set_style_pad_gap(cards, ui_layout.pad, 0);
+    temperature_card(cards, "Battery", FIELD_BATTERY_TEMP, 0x3a2a2a, 0xff6600);
+    temperature_card(cards, "Motor", FIELD_AMBIENT_TEMP, 0x2a2a3a, 0x00ccff);
+    
+    ui_alloc_arena_end();
+    lv_refr_now(lv_display_get_default());
+}
+
+void show_statistics_screen() {
+    lv_obj_t *content = screen_frame("STATISTICS", 0x1a1a2a, NULL);
+    lv_obj_set_flex_align(content, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    lv_obj_t *stats = ui_layout_grid(content, two_cols, four_rows);
+    lv_obj_set_width(stats, LV_PCT(100));
+    lv_obj_set_style_pad_row(stats, ui_px(20), 0);
+    lv_obj_set_style_pad_top(stats, ui_px(10), 0);
+
+    grid_place(screen_value_label(stats, FIELD_TRIP, "Trip: %d km", 18, 0xffffff), 0, 0);
+    grid_place(screen_value_label(stats, FIELD_ODOMETER, "Odometer: %d km", 18, 0xffffff), 0, 1);
+    grid_place(screen_value_label(stats, FIELD_AVG_SPEED, "Avg Speed: %d km/h", 18, 0xffffff), 0, 2);
+    grid_place(screen_value_label(stats, DERIVED_RANGE, "Range: %d km", 18, 0xffffff), 0, 3);
+
+    // Trip energy and recent averages, integrated on the telemetry side
+    grid_place(screen_value_label(stats, DERIVED_ENERGY_USED, "Used: %.2f kWh", 18, 0xffffff), 1, 0);
+    grid_place(screen_value_label(stats, DERIVED_ENERGY_REGEN, "Regen: %.2f kWh", 18, 0xffffff), 1, 1);
+    grid_place(screen_value_label(stats, DERIVED_AVG_WKM, "Cons. 1 min: %d Wh/km", 18, 0xffffff), 1, 2);
+    grid_place(screen_value_label(stats, DERIVED_AVG_KMH, "Speed 1 min: %d km/h", 18, 0xffffff), 1, 3);
+    
+    ui_alloc_arena_end();
+    lv_refr_now(lv_display_get_default());
+}
+
+void show_settings_screen() {
+    lv_obj_t *content = screen_frame("SETTINGS", 0x1a1a1a, NULL);
+    
+    lv_obj_t *info = lv_label_create(content);
+    lv_label_set_text(info, "Settings Page\n\nAdd your options here");
+    lv_obj_set_style_text_color(info, lv_color_white(), 0);
+    lv_obj_set_style_text_font(info, ui_font_px(18), 0);
+    
+    ui_alloc_arena_end();
+    lv_refr_now(lv_display_get_default());
+}
@@ -0,0 +1,67 @@
+#include <string.h>
+
+#include "virtual_transport.h"
+
+void virtual_transport_feed_bytes(TelemetryTransport *t, const uint8_t *bytes, uint32_t len) {
+  VirtualTransport *v = (VirtualTransport *)t->ctx;
+  v->bytes = bytes;
+  v->bytes_len = len;
+  v->bytes_pos = 0;
+}
+
+bool virtual_transport_push_can(TelemetryTransport *t, uint16_t id, const uint8_t *data, uint8_t dlc) {
+  VirtualTransport *v = (VirtualTransport *)t->ctx;
+  if (v->can_count == VIRTUAL_CAN_QUEUE_LEN || dlc > 8) return false;
+  VirtualCanMsg *m = &v->can[(v->can_head + v->can_count) % VIRTUAL_CAN_QUEUE_LEN];
+  m->id = id;
+  m->dlc = dlc;
+  memcpy(m->data, data, dlc);
+  v->can_count++;
+  return true;
+}
+
+/* One chunk of the byte stream, then every queued CAN message that fits */
+static uint8_t virtual_receive(TelemetryTransport *t, uint32_t /* wait_ms: never blocks */) {
+  VirtualTransport *v = (VirtualTransport *)t->ctx;
+  t->batch.count = 0;
+
+  Rs485Framer *f = &v->framer;
+  rs485_framer_compact(f);
+  uint32_t n = v->bytes_len - v->bytes_pos;
+  if (n > VIRTUAL_CHUNK_LEN) n = VIRTUAL_CHUNK_LEN;
+  if (n > sizeof(f->buf) - f->pos) n = sizeof(f->buf) - f->pos;
+  if (n) {
+    memcpy(f->buf + f->pos, v->bytes + v->bytes_pos, n);
+    f->pos += n;
+    v->bytes_pos += n;
+    t->last_rx_ms = v->now_ms;
+  }
+  rs485_framer_decode(f, &t->batch);
+
+  while (v->can_count && t->batch.count < TRANSPORT_BATCH_MAX) {
+    VirtualCanMsg *m = &v->can[v->can_head];
+    v->can_head = (v->can_head + 1) % VIRTUAL_CAN_QUEUE_LEN;
+    v->can_count--;
+    t->last_rx_ms = v->now_ms;
+    can_map_decode(v->signals, v->signal_count, m->id, m->data, m->dlc, &t->batch);
+  }
+  return t->batch.count;
+}
+
+static bool virtual_begin(TelemetryTransport *t) {
+  VirtualTransport *v = (VirtualTransport *)t->ctx;
+  rs485_framer_init(&v->framer);
+  return true;
+}
+
+void virtual_transport_init(TelemetryTransport *t, VirtualTransport *ctx,
+                            const CanSignal *signals, uint8_t signal_count) {
+  memset(t, 0, sizeof(*t));
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->signals = signals;
+  ctx->signal_count = signal_count;
+  t->name = "VIRTUAL";
+  t->begin = virtual_begin;
+  t->receive = virtual_receive;
+  t->ctx = ctx;
+}
@@ -0,0 +1,156 @@
+#include <string.h>
+#include <unity.h>
+
+#include "alert_engine.h"
+#include "derived_metrics.h"
+#include "sim_drive.h"
+
+#define FILLER_RULES   48
+#define HEAT_SIM_MS    600000   // Ten minutes at 20 Hz
+
+static int32_t values[DASH_FIELD_COUNT];
+static DerivedMetrics derived;
+static AlertEngine e;
+
+static int32_t value_of(uint8_t field) {
+  return field < FIELD_COUNT ? values[field] : derived_value(&derived, field);
+}
+
+// Feed one sample of every field and let the debounce timers run
+static bool step(uint32_t now) {
+  bool c = alert_engine_update(&e, (1u << DASH_FIELD_COUNT) - 1, value_of, now);
+  return alert_engine_tick(&e, now) || c;
+}
+
+void setUp(void) {
+  memset(values, 0, sizeof(values));
+  derived_init(&derived);
+}
+
+void tearDown(void) {
+}
+
+/* A drive where the battery heats past both temperature thresholds with
+ * +-2 C of sensor noise and cools down again, next to dozens of rules that
+ * never trip: one raise per crossing (no chatter), the critical rule on top
+ * while both are active, and nothing left active at the end. */
+void test_heat_replay_raises_once_per_crossing(void) {
+  static AlertRule rules[FILLER_RULES];
+  rules[0] = { FIELD_BATTERY_TEMP, ALERT_ABOVE, 55, 3, 2000, ALERT_CRITICAL, "overheating" };
+  rules[1] = { FIELD_BATTERY_TEMP, ALERT_ABOVE, 45, 3, 5000, ALERT_WARNING, "hot" };
+  rules[2] = { FIELD_SOC, ALERT_BELOW, 10, 2, 0, ALERT_CRITICAL, "soc" };
+  for (uint8_t r = 3; r < FILLER_RULES; r++) {
+    // Filler on every field, out of reach of the synthetic values
+    uint8_t f = r % DASH_FIELD_COUNT;
+    rules[r] = { f, ALERT_ABOVE, 1000000 + r, 10, (uint16_t)(r * 100), ALERT_INFO, "filler" };
+  }
+  alert_engine_init(&e, rules, FILLER_RULES);
+
+  uint32_t raw[FIELD_COUNT];
+  uint32_t hot_raised = 0, over_raised = 0, hot_since = 0, over_since = 0;
+  bool was_hot = false, was_over = false;
+  for (uint32_t now = 0, n = 0; now < HEAT_SIM_MS; now += 50, n++) {
+    sim_drive_values(n % SIM_DRIVE_UPDATES, raw);
+    for (uint8_t f = 0; f < FIELD_COUNT; f++) values[f] = raw[f];
+
+    // 30 C -> 60 C over five minutes and back, with noise
+    uint32_t t = now < HEAT_SIM_MS / 2 ? now : HEAT_SIM_MS - now;
+    values[FIELD_BATTERY_TEMP] = 30 + t * 30 / (HEAT_SIM_MS / 2) + (int32_t)((n * 7919) % 5) - 2;
+    step(now);
+
+    bool hot = e.active & 2, over = e.active & 1;
+    if (hot && !was_hot) { hot_raised++; hot_since = now; }
+    if (over && !was_over) { over_raised++; over_since = now; }
+    was_hot = hot;
+    was_over = over;
+    if (over) TEST_ASSERT_EQUAL_PTR(&rules[0], alert_engine_top(&e));
+    else if (hot) TEST_ASSERT_EQUAL_PTR(&rules[1], alert_engine_top(&e));
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(1, hot_raised);
+  TEST_ASSERT_EQUAL_UINT32(1, over_raised);
+  TEST_ASSERT_GREATER_THAN(hot_since, over_since);
+  TEST_ASSERT_EQUAL_UINT8(0, e.active_count);
+  TEST_ASSERT_NULL(alert_engine_top(&e));
+}
+
+// A spike shorter than the debounce never raises; one that holds does, once
+void test_spike_shorter_than_debounce_is_ignored(void) {
+  static const AlertRule rules[] = {
+    { FIELD_AMBIENT_TEMP, ALERT_ABOVE, 80, 5, 1000, ALERT_WARNING, "motor hot" },
+  };
+  alert_engine_init(&e, rules, 1);
+
+  values[FIELD_AMBIENT_TEMP] = 70;
+  TEST_ASSERT_FALSE(step(0));
+  values[FIELD_AMBIENT_TEMP] = 90;
+  TEST_ASSERT_FALSE(step(100));
+  TEST_ASSERT_FALSE(step(1000));        // 900 ms over
+  values[FIELD_AMBIENT_TEMP] = 70;
+  TEST_ASSERT_FALSE(step(1050));
+  TEST_ASSERT_FALSE(step(3000));
+  TEST_ASSERT_NULL(alert_engine_top(&e));
+
+  values[FIELD_AMBIENT_TEMP] = 90;
+  TEST_ASSERT_FALSE(step(4000));
+  TEST_ASSERT_TRUE(step(5000));         // Held for the full second
+  for (uint32_t now = 5050; now < 10000; now += 50) TEST_ASSERT_FALSE(step(now));
+  TEST_ASSERT_EQUAL_UINT8(1, e.active_count);
+}
+
+// A below-threshold rule clears only once back above threshold + hysteresis
+void test_below_rule_clears_past_hysteresis(void) {
+  static const AlertRule rules[] = {
+    { FIELD_SOC, ALERT_BELOW, 10, 2, 0, ALERT_CRITICAL, "battery low" },
+  };
+  alert_engine_init(&e, rules, 1);
+
+  static const int32_t soc[] = { 12, 11, 10, 9, 10, 11, 9, 11, 12, 13 };
+  static const bool active[] = { false, false, false, true, true, true, true, true, false, false };
+  for (uint8_t i = 0; i < sizeof(soc) / sizeof(soc[0]); i++) {
+    values[FIELD_SOC] = soc[i];
+    step(i * 1000);
+    TEST_ASSERT_EQUAL(active[i], e.active_count == 1);
+  }
+}
+
+/* Steady 960 W at 36 km/h while the pack drains from 20% to 5%: the derived
+ * range crosses 5 km once and the alert on it raises once, after the
+ * controller's own figure has been replaced by the dashboard's. */
+void test_derived_range_replay(void) {
+  static const AlertRule rules[] = {
+    { DERIVED_RANGE, ALERT_BELOW, 5, 2, 3000, ALERT_WARNING, "range low" },
+  };
+  alert_engine_init(&e, rules, 1);
+
+  DerivedInputs in = { 48.0f, 20.0f, 36.0f, 20, 100, 30 };
+  uint32_t raised = 0, raised_soc = 0;
+  bool was = false;
+  for (uint32_t now = 0; in.soc >= 5; now += 50) {
+    if (now % 10000 == 0 && now) in.soc--;
+    values[FIELD_SOC] = in.soc;
+    uint32_t changed = derived_update(&derived, now, &in);
+    alert_engine_update(&e, changed, value_of, now);
+    alert_engine_tick(&e, now);
+
+    bool is = e.active_count == 1;
+    if (is && !was) {
+      raised++;
+      raised_soc = in.soc;
+      TEST_ASSERT_LESS_THAN(5, derived_value(&derived, DERIVED_RANGE));
+    }
+    was = is;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, raised);
+  TEST_ASSERT_LESS_OR_EQUAL(12, raised_soc);   // 26.7 Wh/km: 4.5 km left at 12%
+  TEST_ASSERT_TRUE(was);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_heat_replay_raises_once_per_crossing);
+  RUN_TEST(test_spike_shorter_than_debounce_is_ignored);
+  RUN_TEST(test_below_rule_clears_past_hysteresis);
+  RUN_TEST(test_derived_range_replay);
+  return UNITY_END();
+}
@@ -0,0 +1,96 @@
+#include <math.h>
+#include <unity.h>
+
+#include "derived_metrics.h"
+#include "sim_drive.h"
+
+#define DERIVED_SIM_MS   (2 * 3600 * 1000UL)   // Two hours of driving
+
+static DerivedMetrics m;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* A derived value is stale as soon as any field it is computed from is */
+void test_stale_inputs_mark_derived_stale(void) {
+  TEST_ASSERT_EQUAL_HEX32(0, derived_stale_fields(0));
+
+  uint32_t s = derived_stale_fields(FIELD_BIT(FIELD_SPEED));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(FIELD_SPEED));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_AVG_WKM));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_AVG_KMH));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_RANGE));
+  TEST_ASSERT_FALSE(s & DASH_FIELD_BIT(DERIVED_POWER));
+
+  s = derived_stale_fields(FIELD_BIT(FIELD_SOC));
+  TEST_ASSERT_EQUAL_HEX32(DASH_FIELD_BIT(FIELD_SOC) | DASH_FIELD_BIT(DERIVED_RANGE), s);
+
+  s = derived_stale_fields(FIELD_BIT(FIELD_CURRENT));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_POWER));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_AVG_WKM));
+  TEST_ASSERT_TRUE(s & DASH_FIELD_BIT(DERIVED_RANGE));
+  TEST_ASSERT_FALSE(s & DASH_FIELD_BIT(DERIVED_AVG_KMH));
+}
+
+/* Fields nothing is derived from stay on their own */
+void test_unrelated_fields_leave_derived_fresh(void) {
+  uint16_t unrelated = FIELD_BIT(FIELD_BATTERY_TEMP) | FIELD_BIT(FIELD_MODE) | FIELD_BIT(FIELD_ODOMETER);
+  TEST_ASSERT_EQUAL_HEX32(unrelated, derived_stale_fields(unrelated));
+
+  uint32_t all = derived_stale_fields(FIELD_MASK_ALL);
+  TEST_ASSERT_EQUAL_HEX32((1u << DASH_FIELD_COUNT) - 1, all);
+}
+
+/* The synthetic drive at a jittery ~20 Hz, every fourth minute regenerating:
+ * trip energy matches a double-precision reference integrated over the same
+ * timestamps, within display rounding (0.01 kWh). */
+void test_trip_energy_matches_reference(void) {
+  derived_init(&m);
+  uint32_t values[FIELD_COUNT];
+  DerivedInputs in = {};
+
+  double ref_used_wh = 0, ref_regen_wh = 0, held_w = 0;
+  uint32_t prev = 0;
+  for (uint32_t now = 1000, n = 0; now < DERIVED_SIM_MS; now += 40 + (n * 7919) % 21, n++) {
+    if (n > 0) {
+      double wh = held_w * (now - prev) / 3600000.0;
+      if (wh >= 0) ref_used_wh += wh;
+      else ref_regen_wh -= wh;
+    }
+    sim_drive_values(n % SIM_DRIVE_UPDATES, values);
+    in.voltage = telemetry_scale(FIELD_VOLTAGE, values[FIELD_VOLTAGE]);
+    in.current = telemetry_scale(FIELD_CURRENT, values[FIELD_CURRENT]) * ((now / 60000) % 4 == 3 ? -0.5f : 1.0f);
+    in.speed_kmh = telemetry_scale(FIELD_SPEED, values[FIELD_SPEED]);
+    in.soc = values[FIELD_SOC];
+    held_w = (double)in.voltage * in.current;
+    prev = now;
+    derived_update(&m, now, &in);
+  }
+
+  TEST_ASSERT_TRUE(ref_regen_wh > 0);
+  TEST_ASSERT_TRUE(fabs(derived_value(&m, DERIVED_ENERGY_USED) * 10.0 - ref_used_wh) <= 5.0);
+  TEST_ASSERT_TRUE(fabs(derived_value(&m, DERIVED_ENERGY_REGEN) * 10.0 - ref_regen_wh) <= 5.0);
+}
+
+// Steady 960 W at 36 km/h: 26.7 Wh/km, 36 km/h, half a pack goes 18.75 km
+void test_steady_cruise_figures(void) {
+  derived_init(&m);
+  DerivedInputs cruise = { 48.0f, 20.0f, 36.0f, 50, 0, 0 };
+  for (uint32_t now = 0; now <= 120000; now += 50) derived_update(&m, now, &cruise);
+  TEST_ASSERT_EQUAL_INT32(960, derived_value(&m, DERIVED_POWER));
+  TEST_ASSERT_EQUAL_INT32(27, derived_value(&m, DERIVED_AVG_WKM));
+  TEST_ASSERT_EQUAL_INT32(36, derived_value(&m, DERIVED_AVG_KMH));
+  TEST_ASSERT_EQUAL_INT32(19, derived_value(&m, DERIVED_RANGE));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stale_inputs_mark_derived_stale);
+  RUN_TEST(test_unrelated_fields_leave_derived_fresh);
+  RUN_TEST(test_trip_energy_matches_reference);
+  RUN_TEST(test_steady_cruise_figures);
+  return UNITY_END();
+}
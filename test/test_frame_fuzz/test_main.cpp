@@ -0,0 +1,179 @@
+#include <string.h>
+#include <unity.h>
+
+#include "telemetry_protocol.h"
+#include "telemetry_nodes.h"
+#include "sim_drive.h"
+
+#define FUZZ_ITERATIONS   200000
+#define FUZZ_CELLS        192    // Per-cell voltages, 2 bytes each
+#define FUZZ_DUMP_LEN     600    // Fault dump bytes
+
+static uint32_t fuzz_state;
+
+static uint32_t fuzz_rand() {
+  fuzz_state ^= fuzz_state << 13;
+  fuzz_state ^= fuzz_state >> 17;
+  fuzz_state ^= fuzz_state << 5;
+  return fuzz_state;
+}
+
+static uint8_t frame[FRAME_MAX_LEN + 64];
+static uint8_t work[FRAME_MAX_LEN + 64];
+static uint8_t cells[FUZZ_CELLS * 2];
+static uint8_t dump[FUZZ_DUMP_LEN];
+static TelemetryFrame tx, rx;
+static const FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY_BULK };
+
+/* A ~1 KB frame: every field plus a per-cell block and a fault dump */
+static uint16_t encode_big_frame() {
+  for (uint16_t k = 0; k < sizeof(cells); k += 2) {
+    uint16_t mv = 3300 + (k * 37) % 900;
+    cells[k] = mv >> 8;
+    cells[k + 1] = mv & 0xFF;
+  }
+  for (uint16_t k = 0; k < sizeof(dump); k++) dump[k] = fuzz_rand();
+
+  memset(&tx, 0, sizeof(tx));
+  sim_drive_values(0, tx.raw);
+  tx.present = FIELD_MASK_ALL;
+  tx.has_seq = true;
+  tx.keyframe = true;
+  tx.seq = 1;
+  tx.block_count = 2;
+  tx.blocks[0] = { ID_BLOCK_FIRST, sizeof(cells), cells };
+  tx.blocks[1] = { ID_BLOCK_FIRST + 1, sizeof(dump), dump };
+  return telemetry_encode_frame(frame, sizeof(frame), &tx, &hdr);
+}
+
+/* Decode info[0..len) twice, with different bytes after len. The decoder may
+ * only look inside len, so both runs must agree and every block must lie
+ * within the TLV section. */
+static bool decode_in_bounds(uint8_t *info, uint16_t len, uint16_t room) {
+  static TelemetryFrame a, b;
+  uint16_t tail = room - len;
+
+  memset(info + len, 0x00, tail);
+  bool ok_a = telemetry_decode_fields(info, len, &a);
+  memset(info + len, ID_BLOCK_FIRST, tail);   // Looks like a huge block header
+  bool ok_b = telemetry_decode_fields(info, len, &b);
+
+  if (ok_a != ok_b || a.present != b.present || a.block_count != b.block_count) return false;
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if ((a.present & FIELD_BIT(f)) && a.raw[f] != b.raw[f]) return false;
+  }
+  for (uint8_t k = 0; k < a.block_count; k++) {
+    if (a.blocks[k].len != b.blocks[k].len || a.blocks[k].data != b.blocks[k].data) return false;
+    if (a.blocks[k].data < info || a.blocks[k].data + a.blocks[k].len > info + len) return false;
+  }
+  return true;
+}
+
+void setUp(void) {
+  fuzz_state = 0x2545F491;
+}
+
+void tearDown(void) {
+}
+
+void test_large_frame_round_trip(void) {
+  uint16_t len = encode_big_frame();
+  TEST_ASSERT_GREATER_THAN(255, len);
+  TEST_ASSERT_TRUE(validateFrame(frame, len));
+  TEST_ASSERT_TRUE(telemetry_decode_fields(&frame[FRAME_INFO_OFFSET], len - FRAME_OVERHEAD, &rx));
+  TEST_ASSERT_EQUAL_HEX16(FIELD_MASK_ALL, rx.present);
+  TEST_ASSERT_EQUAL_UINT8(2, rx.block_count);
+  TEST_ASSERT_EQUAL_UINT16(sizeof(cells), rx.blocks[0].len);
+  TEST_ASSERT_EQUAL_MEMORY(cells, rx.blocks[0].data, sizeof(cells));
+  TEST_ASSERT_EQUAL_UINT16(sizeof(dump), rx.blocks[1].len);
+  TEST_ASSERT_EQUAL_MEMORY(dump, rx.blocks[1].data, sizeof(dump));
+
+  // Receivers that only expect MSG_TELEMETRY never get blocks
+  const FrameHeader plain = { NODE_ADDR_BMS, 0, MSG_TELEMETRY };
+  TEST_ASSERT_EQUAL_UINT16(0, telemetry_encode_frame(work, sizeof(work), &tx, &plain));
+  TEST_ASSERT_EQUAL_UINT16(0, telemetry_encode_frame(work, sizeof(work), &tx, NULL));
+}
+
+// Exactly FRAME_MAX_LEN encodes, one byte more does not
+void test_frame_max_len_is_the_limit(void) {
+  memset(&tx, 0, sizeof(tx));
+  tx.block_count = 1;
+  tx.blocks[0] = { ID_BLOCK_FIRST, (uint16_t)(FRAME_MAX_LEN - FRAME_OVERHEAD - 3), frame };
+  TEST_ASSERT_EQUAL_UINT16(FRAME_MAX_LEN, telemetry_encode_frame(work, sizeof(work), &tx, &hdr));
+  tx.blocks[0].len++;
+  TEST_ASSERT_EQUAL_UINT16(0, telemetry_encode_frame(work, sizeof(work), &tx, &hdr));
+}
+
+// A corrupt length is rejected, not trusted
+void test_corrupt_length_is_rejected(void) {
+  uint16_t len = encode_big_frame();
+  memcpy(work, frame, len);
+  work[2] = 0xFF;
+  work[3] = 0xFF;
+  TEST_ASSERT_FALSE(validateFrame(work, len));
+  TEST_ASSERT_FALSE(validateFrame(work, FRAME_MAX_LEN));
+}
+
+/* Mutated frames (random bytes, lengths and truncated TLVs, CRC fixed up so
+ * they reach the decoder) through validate+decode. Build with
+ * -fsanitize=address,undefined to catch reads the bounds check misses. */
+void test_mutated_frames_stay_in_bounds(void) {
+  uint16_t len = encode_big_frame();
+  uint32_t accepted = 0, bad = 0;
+  for (uint32_t n = 0; n < FUZZ_ITERATIONS; n++) {
+    uint16_t wlen = len;
+    memcpy(work, frame, len);
+
+    switch (fuzz_rand() % 4) {
+      case 0:   // Flip a few bytes anywhere in the TLV section
+        for (uint8_t k = 0; k < 1 + fuzz_rand() % 4; k++) {
+          work[FRAME_INFO_OFFSET + fuzz_rand() % (len - FRAME_OVERHEAD)] = fuzz_rand();
+        }
+        break;
+      case 1:   // Cut the TLV section short (drops the tail of a TLV)
+        wlen = FRAME_OVERHEAD + fuzz_rand() % (len - FRAME_OVERHEAD);
+        break;
+      case 2:   // Grow the frame with garbage TLVs
+        wlen = len + fuzz_rand() % (sizeof(work) - len - 64);
+        if (wlen > FRAME_MAX_LEN) wlen = FRAME_MAX_LEN;
+        for (uint16_t k = len - FRAME_TRAILER_SIZE - 3; k < wlen; k++) work[k] = fuzz_rand();
+        break;
+      default:  // Random block or field header at a random position
+        {
+          uint16_t at = FRAME_INFO_OFFSET + fuzz_rand() % (len - FRAME_OVERHEAD);
+          work[at] = 0x80 + fuzz_rand() % 0x20;
+          if (at + 2 < len) { work[at + 1] = fuzz_rand(); work[at + 2] = fuzz_rand(); }
+        }
+        break;
+    }
+
+    // Rebuild the envelope so the mutation gets past validation
+    uint16_t declared = wlen - 6;
+    work[2] = declared >> 8;
+    work[3] = declared & 0xFF;
+    work[wlen - 3] = ETX;
+    uint16_t crc = calculateChecksum(&work[2], declared + 2);
+    work[wlen - 2] = crc >> 8;
+    work[wlen - 1] = crc & 0xFF;
+
+    if (!validateFrame(work, wlen)) {
+      bad++;
+      continue;
+    }
+    accepted++;
+    if (!decode_in_bounds(&work[FRAME_INFO_OFFSET], wlen - FRAME_OVERHEAD, sizeof(work) - FRAME_INFO_OFFSET)) {
+      bad++;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(FUZZ_ITERATIONS, accepted);
+  TEST_ASSERT_EQUAL_UINT32(0, bad);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_large_frame_round_trip);
+  RUN_TEST(test_frame_max_len_is_the_limit);
+  RUN_TEST(test_corrupt_length_is_rejected);
+  RUN_TEST(test_mutated_frames_stay_in_bounds);
+  return UNITY_END();
+}
@@ -0,0 +1,179 @@
+#include <string.h>
+#include <unity.h>
+
+#include "telemetry_protocol.h"
+#include "telemetry_nodes.h"
+#include "sim_drive.h"
+
+#define SIM_NODES          3
+#define SIM_DURATION_MS    10000
+#define SIM_CHARGER_STOP   5000   // Charger goes quiet half way through
+#define SIM_KEYFRAME_EVERY 20
+
+struct SimNode {
+  uint8_t  address;
+  uint16_t fields;
+  uint16_t period_ms;
+  uint32_t next_ms;
+  uint32_t sent;
+  uint32_t last[FIELD_COUNT];
+  TelemetryEncoder enc;
+};
+
+static uint8_t route_bytes(const uint8_t *frame, uint16_t len, uint32_t now) {
+  if (!validateFrame(frame, len)) return 0;
+  FrameHeader hdr;
+  TelemetryFrame decoded;
+  telemetry_parse_header(frame, &hdr);
+  if (!telemetry_decode_fields(&frame[FRAME_INFO_OFFSET], len - FRAME_OVERHEAD, &decoded)) return 0;
+  return telemetry_route_frame(&hdr, &decoded, now) != nullptr;
+}
+
+static uint16_t encode_one(uint8_t source, uint8_t msg_type, uint8_t *frame, uint16_t room) {
+  TelemetryFrame tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.present = FIELD_BIT(FIELD_SOC);
+  tx.raw[FIELD_SOC] = 42;
+  tx.keyframe = true;
+  FrameHeader hdr = { source, 0, msg_type };
+  return telemetry_encode_frame(frame, room, &tx, &hdr);
+}
+
+void setUp(void) {
+  telemetry_reset_routes();
+  bmsData = BmsData();
+  motorData = MotorData();
+  chargerData = ChargerData();
+}
+
+void tearDown(void) {
+}
+
+/* BMS, motor controller and charger frames interleaved at a combined
+ * ~160 Hz: every store ends up with its own node's last values, no sequence
+ * gaps, and only the node that went quiet is stale. */
+void test_interleaved_nodes_keep_their_own_values(void) {
+  SimNode nodes[SIM_NODES] = {
+    { NODE_ADDR_BMS,     FIELD_BIT(FIELD_SOC) | FIELD_BIT(FIELD_VOLTAGE) |
+                         FIELD_BIT(FIELD_CURRENT) | FIELD_BIT(FIELD_BATTERY_TEMP), 20, 0, 0, {}, {} },
+    { NODE_ADDR_MOTOR,   FIELD_BIT(FIELD_SPEED) | FIELD_BIT(FIELD_MODE) | FIELD_BIT(FIELD_ARMED) |
+                         FIELD_BIT(FIELD_RANGE) | FIELD_BIT(FIELD_TRIP) | FIELD_BIT(FIELD_ODOMETER),
+                         10, 0, 0, {}, {} },
+    { NODE_ADDR_CHARGER, FIELD_BIT(FIELD_VOLTAGE) | FIELD_BIT(FIELD_CURRENT), 100, 0, 0, {}, {} },
+  };
+  for (uint8_t k = 0; k < SIM_NODES; k++) {
+    telemetry_encoder_init(&nodes[k].enc, SIM_KEYFRAME_EVERY);
+    nodes[k].enc.header.source = nodes[k].address;
+    nodes[k].enc.header.msg_type = MSG_TELEMETRY;
+    nodes[k].enc.fields = nodes[k].fields;
+    nodes[k].next_ms = k * 3;   // Offset the schedules so frames interleave
+  }
+
+  uint8_t frame[128];
+  for (uint32_t now = 0; now < SIM_DURATION_MS; now++) {
+    for (uint8_t k = 0; k < SIM_NODES; k++) {
+      SimNode *node = &nodes[k];
+      if (now < node->next_ms) continue;
+      if (node->address == NODE_ADDR_CHARGER && now >= SIM_CHARGER_STOP) continue;
+      node->next_ms += node->period_ms;
+
+      // Each node reports its own view: offset the charger so it differs from the BMS
+      sim_drive_values(now / 10 + k * 1000, node->last);
+      uint16_t len = telemetry_encoder_next(&node->enc, node->last, frame, sizeof(frame));
+      TEST_ASSERT_EQUAL(1, route_bytes(frame, len, now));
+      node->sent++;
+    }
+    telemetry_check_staleness(now);
+  }
+
+  TEST_ASSERT_EQUAL_INT(nodes[0].last[FIELD_SOC], bmsData.soc);
+  TEST_ASSERT_EQUAL_FLOAT(telemetry_scale(FIELD_VOLTAGE, nodes[0].last[FIELD_VOLTAGE]), bmsData.voltage);
+  TEST_ASSERT_EQUAL_INT((int)telemetry_scale(FIELD_SPEED, nodes[1].last[FIELD_SPEED]), motorData.speed);
+  TEST_ASSERT_EQUAL_INT((int)telemetry_scale(FIELD_ODOMETER, nodes[1].last[FIELD_ODOMETER]), motorData.odo);
+  TEST_ASSERT_EQUAL_FLOAT(telemetry_scale(FIELD_VOLTAGE, nodes[2].last[FIELD_VOLTAGE]), chargerData.voltage);
+
+  const uint8_t addr[SIM_NODES] = { NODE_ADDR_BMS, NODE_ADDR_MOTOR, NODE_ADDR_CHARGER };
+  for (uint8_t k = 0; k < SIM_NODES; k++) {
+    const NodeRouteState *st = &telemetry_find_route(addr[k])->state;
+    TEST_ASSERT_EQUAL_UINT32(nodes[k].sent, st->frames);
+    TEST_ASSERT_EQUAL_UINT32(0, st->seq.gaps);
+    TEST_ASSERT_EQUAL(addr[k] == NODE_ADDR_CHARGER, st->stale);
+  }
+  TEST_ASSERT_FALSE(telemetry_find_route(NODE_ADDR_LEGACY)->state.seen);
+  TEST_ASSERT_EQUAL_UINT32(0, telemetry_unrouted_frames());
+}
+
+// Sources missing from the table land on the legacy route
+void test_unknown_source_goes_to_legacy(void) {
+  uint8_t frame[64];
+  uint16_t len = encode_one(0x55, MSG_TELEMETRY, frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(ROUTE_UNKNOWN_TO_LEGACY, route_bytes(frame, len, 100));
+#if ROUTE_UNKNOWN_TO_LEGACY
+  TEST_ASSERT_EQUAL_UINT32(1, telemetry_find_route(NODE_ADDR_LEGACY)->state.frames);
+#endif
+}
+
+// Registered nodes must send telemetry frames; anything else is dropped and counted
+void test_registered_node_needs_telemetry_type(void) {
+  uint8_t frame[64];
+  uint16_t len = encode_one(NODE_ADDR_BMS, MSG_TELEMETRY_BULK + 1, frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(0, route_bytes(frame, len, 100));
+  TEST_ASSERT_EQUAL_UINT32(1, telemetry_unrouted_frames());
+  TEST_ASSERT_EQUAL_INT(0, bmsData.soc);
+
+  len = encode_one(NODE_ADDR_LEGACY, MSG_TELEMETRY_BULK + 1, frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(1, route_bytes(frame, len, 100));   // Legacy senders don't set it
+}
+
+// A node goes stale after its own timeout and fresh again with the next frame
+void test_staleness_follows_each_node_timeout(void) {
+  uint8_t frame[64];
+  uint16_t len = encode_one(NODE_ADDR_MOTOR, MSG_TELEMETRY, frame, sizeof(frame));
+  route_bytes(frame, len, 1000);
+  len = encode_one(NODE_ADDR_BMS, MSG_TELEMETRY, frame, sizeof(frame));
+  route_bytes(frame, len, 1000);
+
+  TEST_ASSERT_EQUAL_UINT8(0, telemetry_check_staleness(1500));
+  TEST_ASSERT_EQUAL_UINT8(1, telemetry_check_staleness(1501));   // Motor: 500 ms
+  TEST_ASSERT_TRUE(telemetry_find_route(NODE_ADDR_MOTOR)->state.stale);
+  TEST_ASSERT_FALSE(telemetry_find_route(NODE_ADDR_BMS)->state.stale);
+  TEST_ASSERT_EQUAL_UINT8(1, telemetry_check_staleness(2001));   // BMS: 1000 ms
+  TEST_ASSERT_FALSE(telemetry_find_route(NODE_ADDR_CHARGER)->state.stale);   // Never heard
+
+  len = encode_one(NODE_ADDR_MOTOR, MSG_TELEMETRY, frame, sizeof(frame));
+  route_bytes(frame, len, 2100);
+  TEST_ASSERT_EQUAL_UINT8(1, telemetry_check_staleness(2100));
+  TEST_ASSERT_FALSE(telemetry_find_route(NODE_ADDR_MOTOR)->state.stale);
+}
+
+/* A lost delta leaves the node waiting for a keyframe: the gap is flagged on
+ * the frame after it only, the wait lasts until the next keyframe. */
+void test_lost_delta_waits_for_keyframe(void) {
+  TelemetryEncoder enc;
+  telemetry_encoder_init(&enc, 4);
+  enc.header = { NODE_ADDR_BMS, 0, MSG_TELEMETRY };
+  const TelemetrySeqTracker *seq = &telemetry_find_route(NODE_ADDR_BMS)->state.seq;
+  uint32_t values[FIELD_COUNT];
+  uint8_t frame[FRAME_MAX_LEN];
+
+  for (uint32_t n = 0; n < 8; n++) {
+    sim_drive_values(n * 100, values);
+    uint16_t len = telemetry_encoder_next(&enc, values, frame, sizeof(frame));
+    if (n == 1) continue;                    // The first delta is lost
+    TEST_ASSERT_EQUAL(1, route_bytes(frame, len, n * 50));
+    TEST_ASSERT_EQUAL(n == 2, seq->gap);
+    TEST_ASSERT_EQUAL(n == 2 || n == 3, seq->awaiting_keyframe);   // Keyframe at #4
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, seq->gaps);
+  TEST_ASSERT_EQUAL_UINT32(1, seq->lost_frames);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_interleaved_nodes_keep_their_own_values);
+  RUN_TEST(test_unknown_source_goes_to_legacy);
+  RUN_TEST(test_registered_node_needs_telemetry_type);
+  RUN_TEST(test_staleness_follows_each_node_timeout);
+  RUN_TEST(test_lost_delta_waits_for_keyframe);
+  return UNITY_END();
+}
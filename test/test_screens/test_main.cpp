@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include <unity.h>
+#include <lvgl.h>
+
+#include "ui_screens.h"
+#include "ui_layout.h"
+#include "ui_bind.h"
+#include "cell_store.h"
+
+/* Every screen rendered headless into a memory display, at 480x320 and
+ * 800x480, and compared with its PNG under golden/. A pixel differs when any
+ * channel is off by more than SCREENS_PX_TOLERANCE; a screen fails when more
+ * than SCREENS_DIFF_PERMILLE of its pixels differ, and then leaves the render
+ * and a diff image (differing pixels red over the dimmed golden) in out/.
+ * A missing golden is recorded from the render and the test is ignored:
+ * look at the new PNG before committing it. After an intended UI change,
+ * rerecord with SCREENS_UPDATE=1 pio test -e native_ui. */
+#ifndef SCREENS_DIR
+#define SCREENS_DIR            "test/test_screens"
+#endif
+#define SCREENS_PX_TOLERANCE   24     // Per channel, 0-255: anti-aliasing noise
+#define SCREENS_DIFF_PERMILLE  1      // Differing pixels allowed, per mille of the screen
+#define SCREENS_MAX_HOR        800
+#define SCREENS_MAX_VER        480
+#define SCREENS_CELLS          96
+
+struct Panel {
+  int32_t hor;
+  int32_t ver;
+};
+
+static const Panel panels[] = { { 480, 320 }, { 800, 480 } };
+#define PANELS (sizeof(panels) / sizeof(panels[0]))
+
+// Telemetry every screen is rendered with, in ui_bind display units (as bench_golden)
+static const int32_t screen_values[FIELD_COUNT] = {
+  64, 5120, 1234, 31, 42, MODE_CITY, 1, 87, 96, 48, 12, 3456, 38
+};
+
+static uint8_t frame[SCREENS_MAX_HOR * SCREENS_MAX_VER * 2];   // RGB565, whole screen
+static uint8_t rgb[SCREENS_MAX_HOR * SCREENS_MAX_VER * 3];
+static uint8_t golden_rgb[SCREENS_MAX_HOR * SCREENS_MAX_VER * 3];
+
+/* LVGL allocates from the C library here; the screen arenas of ui_alloc.cpp
+ * are a firmware concern */
+void ui_alloc_arena_begin() {
+}
+
+void ui_alloc_arena_end() {
+}
+
+// A fixed clock instead of the RTC
+void time_display_attach(lv_obj_t *label) {
+  lv_label_set_text(label, "12:00");
+}
+
+/* ---- PNG, 8-bit RGB. Written unfiltered; read with any filter. ---- */
+
+static void png_put32(uint8_t *p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+static uint32_t png_get32(const uint8_t *p) {
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+  uint8_t b[4];
+  png_put32(b, len);
+  fwrite(b, 1, 4, f);
+  fwrite(type, 1, 4, f);
+  if (len) fwrite(data, 1, len, f);
+  uint32_t crc = crc32(crc32(0, (const Bytef *)type, 4), data, len);
+  png_put32(b, crc);
+  fwrite(b, 1, 4, f);
+}
+
+static bool png_write(const char *path, const uint8_t *px, int32_t w, int32_t h) {
+  static uint8_t raw[SCREENS_MAX_VER * (1 + SCREENS_MAX_HOR * 3)];
+  for (int32_t y = 0; y < h; y++) {
+    raw[y * (1 + w * 3)] = 0;
+    memcpy(&raw[y * (1 + w * 3) + 1], &px[y * w * 3], w * 3);
+  }
+  uLongf zlen = compressBound(h * (1 + w * 3));
+  uint8_t *z = (uint8_t *)malloc(zlen);
+  FILE *f = fopen(path, "wb");
+  bool ok = z && f && compress2(z, &zlen, raw, h * (1 + w * 3), 9) == Z_OK;
+  if (ok) {
+    static const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    uint8_t ihdr[13] = { 0 };
+    png_put32(&ihdr[0], w);
+    png_put32(&ihdr[4], h);
+    ihdr[8] = 8;        // Bit depth
+    ihdr[9] = 2;        // RGB
+    fwrite(sig, 1, 8, f);
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    png_chunk(f, "IDAT", z, zlen);
+    png_chunk(f, "IEND", NULL, 0);
+  }
+  if (f) ok = fclose(f) == 0 && ok;
+  free(z);
+  return ok;
+}
+
+static uint8_t png_paeth(uint8_t a, uint8_t b, uint8_t c) {
+  int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+// False if missing, not 8-bit RGB of w x h, or damaged
+static bool png_read(const char *path, uint8_t *px, int32_t w, int32_t h) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *file = (uint8_t *)malloc(size);
+  uint8_t *idat = (uint8_t *)malloc(size);
+  bool ok = file && idat && size > 8 && fread(file, 1, size, f) == (size_t)size;
+  fclose(f);
+
+  uint32_t idat_len = 0;
+  bool header_ok = false;
+  for (long pos = 8; ok && pos + 12 <= size; ) {
+    uint32_t len = png_get32(&file[pos]);
+    const uint8_t *type = &file[pos + 4], *data = &file[pos + 8];
+    if (len > (uint32_t)(size - pos - 12)) {
+      ok = false;
+      break;
+    }
+    if (!memcmp(type, "IHDR", 4)) {
+      header_ok = len == 13 && png_get32(data) == (uint32_t)w && png_get32(data + 4) == (uint32_t)h &&
+                  data[8] == 8 && data[9] == 2 && data[12] == 0;
+    } else if (!memcmp(type, "IDAT", 4)) {
+      memcpy(&idat[idat_len], data, len);
+      idat_len += len;
+    } else if (!memcmp(type, "IEND", 4)) {
+      break;
+    }
+    pos += 12 + len;
+  }
+
+  uint32_t stride = w * 3;
+  static uint8_t raw[SCREENS_MAX_VER * (1 + SCREENS_MAX_HOR * 3)];
+  uLongf raw_len = h * (1 + stride);
+  ok = ok && header_ok && uncompress(raw, &raw_len, idat, idat_len) == Z_OK && raw_len == h * (1 + stride);
+  for (int32_t y = 0; ok && y < h; y++) {
+    const uint8_t *in = &raw[y * (1 + stride) + 1];
+    uint8_t *out = &px[y * stride], *up = y ? &px[(y - 1) * stride] : NULL;
+    uint8_t filter = in[-1];
+    for (uint32_t i = 0; i < stride; i++) {
+      uint8_t a = i >= 3 ? out[i - 3] : 0, b = up ? up[i] : 0, c = up && i >= 3 ? up[i - 3] : 0;
+      switch (filter) {
+        case 0: out[i] = in[i]; break;
+        case 1: out[i] = in[i] + a; break;
+        case 2: out[i] = in[i] + b; break;
+        case 3: out[i] = in[i] + (a + b) / 2; break;
+        case 4: out[i] = in[i] + png_paeth(a, b, c); break;
+        default: ok = false; break;
+      }
+    }
+  }
+  free(file);
+  free(idat);
+  return ok;
+}
+
+/* ---- Rendering ---- */
+
+static void screens_flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px_map) {
+  lv_display_flush_ready(d);
+}
+
+// Run every animation to its end on simulated ticks
+static void finish_anims() {
+  for (uint16_t i = 0; i < 500 && lv_anim_count_running(); i++) {
+    lv_tick_inc(LV_DEF_REFR_PERIOD);
+    lv_anim_refr_now();
+  }
+}
+
+static void sidebar_opened() {
+  create_ev_dashboard_ui();
+  show_sidebar();
+  sidebar_open = true;
+  finish_anims();
+}
+
+static void sidebar_closed() {
+  sidebar_opened();
+  close_sidebar();
+  sidebar_open = false;
+  finish_anims();
+}
+
+// Render show() on a w x h memory display into rgb[]
+static void render(void (*show)(), int32_t w, int32_t h) {
+  lv_display_t *d = lv_display_create(w, h);
+  lv_display_set_color_format(d, LV_COLOR_FORMAT_RGB565);
+  lv_display_set_flush_cb(d, screens_flush_cb);
+  lv_display_set_buffers(d, frame, NULL, w * h * 2, LV_DISPLAY_RENDER_MODE_FULL);
+  lv_display_set_default(d);
+  ui_layout_init(d);
+
+  show();
+  finish_anims();
+  lv_obj_invalidate(lv_screen_active());
+  lv_refr_now(d);
+
+  for (int32_t i = 0; i < w * h; i++) {
+    uint16_t p = frame[2 * i] | frame[2 * i + 1] << 8;
+    uint8_t r = p >> 11, g = (p >> 5) & 0x3F, b = p & 0x1F;
+    rgb[3 * i] = r << 3 | r >> 2;
+    rgb[3 * i + 1] = g << 2 | g >> 4;
+    rgb[3 * i + 2] = b << 3 | b >> 2;
+  }
+  lv_display_delete(d);
+}
+
+/* Render and compare one screen at every panel size. Failures and recordings
+ * are reported once all sizes are done. */
+static void check_screen(const char *name, void (*show)()) {
+  char msg[256] = "", path[256];
+  bool recorded = false;
+  bool update = getenv("SCREENS_UPDATE") != NULL;
+  mkdir(SCREENS_DIR "/golden", 0755);
+
+  for (uint8_t p = 0; p < PANELS; p++) {
+    int32_t w = panels[p].hor, h = panels[p].ver;
+    render(show, w, h);
+
+    snprintf(path, sizeof(path), SCREENS_DIR "/golden/%s_%ldx%ld.png", name, (long)w, (long)h);
+    if (update || !png_read(path, golden_rgb, w, h)) {
+      TEST_ASSERT_TRUE_MESSAGE(png_write(path, rgb, w, h), path);
+      recorded = true;
+      continue;
+    }
+
+    // Diff image: differing pixels red, the rest the golden at a third
+    static uint8_t diff[SCREENS_MAX_HOR * SCREENS_MAX_VER * 3];
+    uint32_t differing = 0;
+    for (int32_t i = 0; i < w * h; i++) {
+      bool off = false;
+      for (uint8_t c = 0; c < 3; c++) {
+        if (abs(rgb[3 * i + c] - golden_rgb[3 * i + c]) > SCREENS_PX_TOLERANCE) off = true;
+      }
+      differing += off;
+      for (uint8_t c = 0; c < 3; c++) {
+        diff[3 * i + c] = off ? (c == 0 ? 255 : 0) : golden_rgb[3 * i + c] / 3;
+      }
+    }
+    if (differing * 1000 <= (uint32_t)(w * h) * SCREENS_DIFF_PERMILLE) continue;
+
+    mkdir(SCREENS_DIR "/out", 0755);
+    snprintf(path, sizeof(path), SCREENS_DIR "/out/%s_%ldx%ld.png", name, (long)w, (long)h);
+    png_write(path, rgb, w, h);
+    snprintf(path, sizeof(path), SCREENS_DIR "/out/%s_%ldx%ld.diff.png", name, (long)w, (long)h);
+    png_write(path, diff, w, h);
+    snprintf(msg + strlen(msg), sizeof(msg) - strlen(msg), "%s%ldx%ld: %lu px differ, see %s",
+             msg[0] ? "; " : "", (long)w, (long)h, (unsigned long)differing, path);
+  }
+
+  if (msg[0]) TEST_FAIL_MESSAGE(msg);
+  if (recorded) TEST_IGNORE_MESSAGE("golden recorded, check it under " SCREENS_DIR "/golden before committing");
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_dashboard(void) {
+  check_screen("dashboard", create_ev_dashboard_ui);
+}
+
+void test_battery(void) {
+  check_screen("battery", show_battery_screen);
+}
+
+void test_voltage(void) {
+  check_screen("voltage", show_voltage_screen);
+}
+
+void test_temperature(void) {
+  check_screen("temperature", show_temperature_screen);
+}
+
+void test_statistics(void) {
+  check_screen("statistics", show_statistics_screen);
+}
+
+void test_settings(void) {
+  check_screen("settings", show_settings_screen);
+}
+
+void test_sidebar_open(void) {
+  check_screen("sidebar_open", sidebar_opened);
+}
+
+// Closing must leave nothing of the sidebar behind
+void test_sidebar_closed(void) {
+  check_screen("sidebar_closed", sidebar_closed);
+}
+
+/* Fixed telemetry and a pack with one weak cell, the same for every screen */
+static void screens_init() {
+  lv_init();
+  ui_bind_init();
+  for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++) {
+    ui_bind_publish(f, f < FIELD_COUNT ? screen_values[f] : 10 + f * 3);
+  }
+  ui_bind_publish_stale(0);
+
+  static uint8_t mv[1 + SCREENS_CELLS * 2], temps[1 + SCREENS_CELLS];
+  mv[0] = temps[0] = 0;
+  for (uint8_t i = 0; i < SCREENS_CELLS; i++) {
+    uint16_t cell_mv = 3700 + (i * 13) % 40 - (i == 57 ? 150 : 0);
+    mv[1 + 2 * i] = cell_mv >> 8;
+    mv[2 + 2 * i] = cell_mv & 0xFF;
+    temps[1 + i] = 25 + (i * 7) % 9;
+  }
+  TelemetryBlock block = { ID_CELL_VOLTAGES, sizeof(mv), mv };
+  cell_store_init(&ui_cells);
+  cell_store_apply_block(&ui_cells, &block);
+  block = { ID_CELL_TEMPS, sizeof(temps), temps };
+  cell_store_apply_block(&ui_cells, &block);
+}
+
+int main() {
+  screens_init();
+  UNITY_BEGIN();
+  RUN_TEST(test_dashboard);
+  RUN_TEST(test_battery);
+  RUN_TEST(test_voltage);
+  RUN_TEST(test_temperature);
+  RUN_TEST(test_statistics);
+  RUN_TEST(test_settings);
+  RUN_TEST(test_sidebar_open);
+  RUN_TEST(test_sidebar_closed);
+  return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include <string.h>
+#include <unity.h>
+
+#include "virtual_transport.h"
+#include "link_health.h"
+#include "telemetry_nodes.h"
+#include "sim_drive.h"
+
+#define XPORT_UPDATES     400
+#define XPORT_FRAME_LEN   32     // A BMS frame with four fields is 29 bytes
+
+// BMS pack message, laid out like the 0x310 entry of the CAN map in main.cpp
+static const CanSignal xport_signals[] = {
+  { 0x310, NODE_ADDR_BMS, FIELD_SOC,          0, 1, false },
+  { 0x310, NODE_ADDR_BMS, FIELD_VOLTAGE,      1, 2, false },
+  { 0x310, NODE_ADDR_BMS, FIELD_CURRENT,      3, 2, true  },
+  { 0x310, NODE_ADDR_BMS, FIELD_BATTERY_TEMP, 5, 2, false },
+  { 0x320, NODE_ADDR_MOTOR, FIELD_SPEED,      0, 2, false },
+  { 0x321, NODE_ADDR_MOTOR, FIELD_RANGE,      0, 2, false },
+};
+#define XPORT_SIGNALS  (sizeof(xport_signals) / sizeof(xport_signals[0]))
+
+static const uint8_t xport_fields[] = { FIELD_SOC, FIELD_VOLTAGE, FIELD_CURRENT, FIELD_BATTERY_TEMP };
+
+static VirtualTransport vctx;
+static TelemetryTransport t;
+static uint8_t stream[XPORT_UPDATES * XPORT_FRAME_LEN];
+static uint32_t sent[XPORT_UPDATES][4], via_rs485[XPORT_UPDATES][4], via_can[XPORT_UPDATES][4];
+
+/* Drain the transport, keeping the BMS fields of every frame in arrival order */
+static uint32_t drain(uint32_t (*out)[4]) {
+  uint32_t n = 0;
+  for (;;) {
+    uint8_t count = t.receive(&t, 0);
+    if (!count && vctx.bytes_pos == vctx.bytes_len && !vctx.can_count) break;
+    for (uint8_t k = 0; k < count && n < XPORT_UPDATES; k++, n++) {
+      TEST_ASSERT_EQUAL_UINT8(NODE_ADDR_BMS, t.batch.hdr[k].source);
+      for (uint8_t i = 0; i < 4; i++) out[n][i] = t.batch.frame[k].raw[xport_fields[i]];
+    }
+  }
+  return n;
+}
+
+/* The synthetic drive as RS485 frames, every other update regenerating */
+static uint32_t encode_stream() {
+  FrameHeader hdr = { NODE_ADDR_BMS, 0, MSG_TELEMETRY };
+  TelemetryFrame tx;
+  memset(&tx, 0, sizeof(tx));
+  uint32_t values[FIELD_COUNT];
+  uint32_t len = 0;
+  for (uint32_t n = 0; n < XPORT_UPDATES; n++) {
+    sim_drive_values(n * 10, values);
+    if (n & 1) values[FIELD_CURRENT] = 0x8000 | (values[FIELD_CURRENT] / 3);   // Regen
+    for (uint8_t i = 0; i < 4; i++) {
+      tx.raw[xport_fields[i]] = sent[n][i] = values[xport_fields[i]];
+      tx.present |= FIELD_BIT(xport_fields[i]);
+    }
+    len += telemetry_encode_frame(&stream[len], sizeof(stream) - len, &tx, &hdr);
+  }
+  return len;
+}
+
+// The same values as a 0x310 message, current in two's complement
+static void can_message(uint32_t n, uint8_t *d) {
+  int32_t cur = (sent[n][2] & 0x8000) ? -(int32_t)(sent[n][2] & 0x7FFF) : (int32_t)sent[n][2];
+  d[0] = sent[n][0];
+  d[1] = sent[n][1] >> 8;
+  d[2] = sent[n][1];
+  d[3] = (uint16_t)cur >> 8;
+  d[4] = cur;
+  d[5] = sent[n][3] >> 8;
+  d[6] = sent[n][3];
+  d[7] = 0;
+}
+
+void setUp(void) {
+  memset(&linkHealth, 0, sizeof(linkHealth));
+  virtual_transport_init(&t, &vctx, xport_signals, XPORT_SIGNALS);
+  t.begin(&t);
+}
+
+void tearDown(void) {
+}
+
+/* Both transports must decode the same values into identical raw fields,
+ * discharge and regen current alike, in the order they were sent. */
+void test_rs485_and_can_decode_identically(void) {
+  uint32_t len = encode_stream();
+  virtual_transport_feed_bytes(&t, stream, len);
+  TEST_ASSERT_EQUAL_UINT32(XPORT_UPDATES, drain(via_rs485));
+  TEST_ASSERT_EQUAL_UINT32(0, linkHealth.crc_errors);
+  TEST_ASSERT_EQUAL_UINT32(0, linkHealth.bytes_dropped);
+
+  uint32_t can_frames = 0;
+  for (uint32_t n = 0; n < XPORT_UPDATES;) {
+    // Fill the queue like a burst in the driver's ISR queue, then drain it
+    for (; n < XPORT_UPDATES; n++) {
+      uint8_t d[8];
+      can_message(n, d);
+      if (!virtual_transport_push_can(&t, 0x310, d, 8)) break;
+    }
+    can_frames += drain(&via_can[can_frames]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(XPORT_UPDATES, can_frames);
+
+  TEST_ASSERT_EQUAL_MEMORY(sent, via_rs485, sizeof(sent));
+  TEST_ASSERT_EQUAL_MEMORY(sent, via_can, sizeof(sent));
+}
+
+/* Junk between frames is skipped and counted, and frames split across
+ * receive chunks still come out whole. */
+void test_rs485_skips_junk_between_frames(void) {
+  static uint8_t noisy[sizeof(stream) + XPORT_UPDATES * 3];
+  uint32_t len = encode_stream();
+  uint32_t out = 0, junk = 0;
+  for (uint32_t pos = 0; pos < len; ) {
+    uint16_t frame_len = ((stream[pos + 2] << 8) | stream[pos + 3]) + 6;
+    memcpy(&noisy[out], &stream[pos], frame_len);
+    out += frame_len;
+    pos += frame_len;
+    for (uint8_t k = 0; k < pos % 3; k++, junk++) noisy[out++] = 0x55;
+  }
+  virtual_transport_feed_bytes(&t, noisy, out);
+  TEST_ASSERT_EQUAL_UINT32(XPORT_UPDATES, drain(via_rs485));
+  TEST_ASSERT_EQUAL_MEMORY(sent, via_rs485, sizeof(sent));
+  TEST_ASSERT_EQUAL_UINT32(junk, linkHealth.bytes_dropped);
+}
+
+/* A short message is dropped whole rather than half-applied, and an
+ * unmapped ID never becomes a frame. Either still counts as traffic. */
+void test_can_drops_short_and_unmapped(void) {
+  static const uint8_t msg[8] = { 0 };
+  vctx.now_ms = 1234;
+  TEST_ASSERT_TRUE(virtual_transport_push_can(&t, 0x310, msg, 4));
+  TEST_ASSERT_TRUE(virtual_transport_push_can(&t, 0x311, msg, 8));
+  TEST_ASSERT_EQUAL_UINT8(0, t.receive(&t, 0));
+  TEST_ASSERT_EQUAL_UINT32(1234, t.last_rx_ms);
+
+  TEST_ASSERT_TRUE(virtual_transport_push_can(&t, 0x320, msg, 2));
+  TEST_ASSERT_EQUAL_UINT8(1, t.receive(&t, 0));
+  TEST_ASSERT_EQUAL_UINT8(NODE_ADDR_MOTOR, t.batch.hdr[0].source);
+  TEST_ASSERT_EQUAL_UINT16(FIELD_BIT(FIELD_SPEED), t.batch.frame[0].present);
+  TEST_ASSERT_TRUE(t.batch.frame[0].keyframe);
+  TEST_ASSERT_NULL(t.batch.raw[0]);
+}
+
+/* The single acceptance filter passes every mapped ID; what else it lets
+ * through is left to can_map_decode. */
+void test_can_filter_passes_every_mapped_id(void) {
+  uint32_t code, mask, accepted = 0;
+  can_map_filter(xport_signals, XPORT_SIGNALS, &code, &mask);
+  for (uint32_t id = 0; id < 0x800; id++) {
+    if ((((id << 21) ^ code) & ~mask) == 0) accepted++;
+  }
+  for (uint8_t s = 0; s < XPORT_SIGNALS; s++) {
+    TEST_ASSERT_EQUAL_UINT32(0, (((uint32_t)xport_signals[s].can_id << 21) ^ code) & ~mask);
+  }
+  TEST_ASSERT_LESS_THAN(0x800, accepted);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rs485_and_can_decode_identically);
+  RUN_TEST(test_rs485_skips_junk_between_frames);
+  RUN_TEST(test_can_drops_short_and_unmapped);
+  RUN_TEST(test_can_filter_passes_every_mapped_id);
+  return UNITY_END();
+}
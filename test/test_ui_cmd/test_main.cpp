@@ -0,0 +1,105 @@
+#include <thread>
+#include <atomic>
+#include <unity.h>
+
+#include "ui_cmd.h"
+
+#define CMD_PRODUCERS     6
+#define CMD_PER_PRODUCER  200000
+
+static UiCmdQueue q;
+
+void setUp(void) {
+  ui_cmd_queue_init(&q);
+}
+
+void tearDown(void) {
+}
+
+/* Producer: arg = producer << 24 | sequence, retried until accepted */
+static void producer(uint32_t p) {
+  for (uint32_t i = 0; i < CMD_PER_PRODUCER;) {
+    UiCmd cmd = { UI_CMD_ALERT, (int32_t)(p << 24 | i), nullptr };
+    if (ui_cmd_queue_push(&q, &cmd)) i++;
+    else std::this_thread::yield();
+  }
+}
+
+/* Several producer threads hammer one queue while this thread drains it:
+ * every command arrives exactly once and in order per producer, and the
+ * queue is empty afterwards. Run under -fsanitize=thread to check the
+ * memory ordering as well. */
+void test_producers_deliver_exactly_once_in_order(void) {
+  std::thread threads[CMD_PRODUCERS];
+  for (uint32_t p = 0; p < CMD_PRODUCERS; p++) threads[p] = std::thread(producer, p);
+
+  int32_t last[CMD_PRODUCERS];
+  for (uint8_t p = 0; p < CMD_PRODUCERS; p++) last[p] = -1;
+  uint32_t received = 0, bad = 0;
+  while (received < CMD_PRODUCERS * CMD_PER_PRODUCER) {
+    UiCmd cmd;
+    if (!ui_cmd_queue_pop(&q, &cmd)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t p = (uint32_t)cmd.arg >> 24;
+    int32_t seq = cmd.arg & 0xFFFFFF;
+    if (p >= CMD_PRODUCERS || seq != last[p] + 1) bad++;
+    else last[p] = seq;
+    received++;
+  }
+  for (uint32_t p = 0; p < CMD_PRODUCERS; p++) threads[p].join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, bad);
+  for (uint8_t p = 0; p < CMD_PRODUCERS; p++) TEST_ASSERT_EQUAL_INT32(CMD_PER_PRODUCER - 1, last[p]);
+  UiCmd extra;
+  TEST_ASSERT_FALSE(ui_cmd_queue_pop(&q, &extra));
+}
+
+// A full ring refuses the push and counts it, and takes commands again once drained
+void test_full_queue_refuses_and_counts(void) {
+  UiCmd cmd = { UI_CMD_ALERT, 0, nullptr };
+  for (int32_t i = 0; i < UI_CMD_QUEUE_LEN; i++) {
+    cmd.arg = i;
+    TEST_ASSERT_TRUE(ui_cmd_queue_push(&q, &cmd));
+  }
+  TEST_ASSERT_FALSE(ui_cmd_queue_push(&q, &cmd));
+  TEST_ASSERT_EQUAL_UINT32(1, q.dropped.load());
+
+  UiCmd out;
+  TEST_ASSERT_TRUE(ui_cmd_queue_pop(&q, &out));
+  TEST_ASSERT_EQUAL_INT32(0, out.arg);
+  TEST_ASSERT_TRUE(ui_cmd_queue_push(&q, &cmd));
+}
+
+// Only the latest SCREEN, BRIGHTNESS and BANNER survive, in the latest one's place
+void test_collect_coalesces_latest_wins(void) {
+  const UiCmd burst[] = {
+    { UI_CMD_SCREEN, 1, nullptr }, { UI_CMD_BRIGHTNESS, 50, nullptr }, { UI_CMD_ALERT, 3, "a" },
+    { UI_CMD_BANNER, 1, "x" }, { UI_CMD_SCREEN, 6, nullptr }, { UI_CMD_ALERT, 3, "b" },
+    { UI_CMD_BRIGHTNESS, 200, nullptr }, { UI_CMD_BANNER, 0, nullptr },
+  };
+  for (uint8_t i = 0; i < sizeof(burst) / sizeof(burst[0]); i++) ui_cmd_queue_push(&q, &burst[i]);
+
+  UiCmd out[UI_CMD_QUEUE_LEN];
+  uint8_t n = ui_cmd_queue_collect(&q, out, UI_CMD_QUEUE_LEN);
+  TEST_ASSERT_EQUAL_UINT8(5, n);
+  TEST_ASSERT_EQUAL(UI_CMD_ALERT, out[0].type);
+  TEST_ASSERT_EQUAL_STRING("a", out[0].text);
+  TEST_ASSERT_EQUAL(UI_CMD_SCREEN, out[1].type);
+  TEST_ASSERT_EQUAL_INT32(6, out[1].arg);
+  TEST_ASSERT_EQUAL(UI_CMD_ALERT, out[2].type);
+  TEST_ASSERT_EQUAL_STRING("b", out[2].text);
+  TEST_ASSERT_EQUAL(UI_CMD_BRIGHTNESS, out[3].type);
+  TEST_ASSERT_EQUAL_INT32(200, out[3].arg);
+  TEST_ASSERT_EQUAL(UI_CMD_BANNER, out[4].type);
+  TEST_ASSERT_NULL(out[4].text);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_producers_deliver_exactly_once_in_order);
+  RUN_TEST(test_full_queue_refuses_and_counts);
+  RUN_TEST(test_collect_coalesces_latest_wins);
+  return UNITY_END();
+}
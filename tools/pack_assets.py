@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""Pack images and fonts into the dashboard's flash asset partition.
+
+    tools/pack_assets.py [--assets DIR] [--out FILE] [--partitions CSV]
+
+Inputs, named by file stem:
+  DIR/images/*.bin   LVGL v9 binary images (LVGLImage.py / online converter)
+  DIR/fonts/*.c      lv_font_conv --format lvgl output (bpp 1-8, compressed or not)
+
+images/logo is the boot splash. fonts/montserrat_<px> replace the built-in
+fonts when the firmware is built with -D DASH_ASSET_FONTS (see ui_fonts.h);
+tools/subset_fonts.py generates them with only the glyphs the UI draws.
+
+Writes the partition image (default .pio/assets.bin) in the layout read by
+src/asset_store.cpp and prints the esptool command that flashes it at the
+"assets" offset from partitions.csv. UI code is untouched: assets are looked
+up by name at runtime, so they can be updated without rebuilding the firmware.
+"""
+
+import argparse
+import csv
+import os
+import re
+import struct
+import sys
+import zlib
+
+ASSET_MAGIC = 0x41485344  # "DSHA"
+ASSET_VERSION = 1
+ASSET_NAME_LEN = 24
+ASSET_MAX_ENTRIES = 32
+ASSET_IMAGE = 1
+ASSET_FONT = 2
+
+LV_IMAGE_HEADER_MAGIC = 0x19
+
+HEADER_FMT = "<IHHII"                       # AssetHeader
+ENTRY_FMT = "<%dsB3xII" % ASSET_NAME_LEN    # AssetEntry
+FONT_FMT = "<HhbbBBBBHHHIIII"               # PackedFont
+CMAP_FMT = "<IHHHBxII"                      # PackedCmap
+KERN_FMT = "<BBxxIII"                       # PackedKernClasses
+
+CMAP_TYPES = {
+    "FORMAT0_FULL": 0,
+    "SPARSE_FULL": 1,
+    "FORMAT0_TINY": 2,
+    "SPARSE_TINY": 3,
+}
+
+SUBPX = {"NONE": 0, "HOR": 1, "VER": 2, "BOTH": 3}
+
+
+def align4(buf):
+    buf.extend(b"\0" * (-len(buf) % 4))
+
+
+def strip_comments(src):
+    src = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+    return re.sub(r"//[^\n]*", "", src)
+
+
+def c_array(src, name):
+    m = re.search(r"\b%s\s*\[\s*\]\s*=\s*\{(.*?)\};" % re.escape(name), src, re.S)
+    if not m:
+        return None
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)", m.group(1))]
+
+
+def c_field(src, name, default=None):
+    m = re.search(r"\.%s\s*=\s*([^,\n}]+)" % re.escape(name), src)
+    if not m:
+        if default is None:
+            raise ValueError("missing .%s" % name)
+        return default
+    return m.group(1).strip()
+
+
+def font_codepoints(path):
+    """Code points an lv_font_conv C font has glyphs for."""
+    with open(path, encoding="utf-8") as f:
+        src = strip_comments(f.read())
+    out = set()
+    for start, length, ulist in re.findall(
+            r"\.range_start\s*=\s*(\d+),\s*\.range_length\s*=\s*(\d+),.*?\.unicode_list\s*=\s*(\w+)",
+            src, re.S):
+        if ulist == "NULL":
+            out.update(range(int(start), int(start) + int(length)))
+        else:
+            out.update(int(start) + u for u in c_array(src, ulist))
+    return out
+
+
+def pack_font(path):
+    """Convert lv_font_conv C output into the pointer-free PackedFont layout."""
+    with open(path, encoding="utf-8") as f:
+        src = strip_comments(f.read())
+
+    bitmap = bytes(v & 0xFF for v in c_array(src, "glyph_bitmap"))
+
+    glyphs = re.findall(
+        r"\{\s*\.bitmap_index\s*=\s*(\d+),\s*\.adv_w\s*=\s*(\d+),\s*\.box_w\s*=\s*(\d+),"
+        r"\s*\.box_h\s*=\s*(\d+),\s*\.ofs_x\s*=\s*(-?\d+),\s*\.ofs_y\s*=\s*(-?\d+)\s*\}", src)
+    if not glyphs:
+        raise ValueError("no glyph descriptors")
+
+    cmaps = re.findall(
+        r"\.range_start\s*=\s*(\d+),\s*\.range_length\s*=\s*(\d+),\s*\.glyph_id_start\s*=\s*(\d+),"
+        r"\s*\.unicode_list\s*=\s*(\w+),\s*\.glyph_id_ofs_list\s*=\s*(\w+),"
+        r"\s*\.list_length\s*=\s*(\d+),\s*\.type\s*=\s*LV_FONT_FMT_TXT_CMAP_(\w+)", src)
+    if not cmaps:
+        raise ValueError("no character maps")
+
+    line_height = int(c_field(src, "line_height"))
+    base_line = int(c_field(src, "base_line"))
+    underline_position = int(c_field(src, "underline_position", "0"))
+    underline_thickness = int(c_field(src, "underline_thickness", "0"))
+    subpx = SUBPX[c_field(src, "subpx", "LV_FONT_SUBPX_NONE").replace("LV_FONT_SUBPX_", "")]
+    bpp = int(c_field(src, "bpp"))
+    bitmap_format = int(c_field(src, "bitmap_format", "0"))
+    kern_scale = int(c_field(src, "kern_scale", "0"))
+
+    kern_left = c_array(src, "kern_left_class_mapping")
+    kern_right = c_array(src, "kern_right_class_mapping")
+    kern_values = c_array(src, "kern_class_values")
+    has_kern = kern_left is not None and kern_right is not None and kern_values is not None
+    if not has_kern and "kern_pair_glyph_ids" in src:
+        print("  %s: pair kerning is not supported, dropped" % os.path.basename(path))
+
+    # Variable-size tables go after the fixed header, cmap and glyph tables
+    out = bytearray(struct.calcsize(FONT_FMT))
+    glyph_dsc_off = len(out)
+    for idx, adv, bw, bh, ox, oy in glyphs:
+        idx, adv = int(idx), int(adv)
+        if idx >= 1 << 20 or adv >= 1 << 12:
+            raise ValueError("glyph too large for the small descriptor layout")
+        out += struct.pack("<IBBbb", idx | (adv << 20), int(bw), int(bh), int(ox), int(oy))
+
+    cmaps_off = len(out)
+    out += bytes(struct.calcsize(CMAP_FMT) * len(cmaps))
+
+    packed_cmaps = []
+    for start, length, gid, ulist, ofs_list, list_len, ctype in cmaps:
+        unicode_off = ofs_off = 0
+        if ulist != "NULL":
+            align4(out)
+            unicode_off = len(out)
+            out += struct.pack("<%dH" % int(list_len), *c_array(src, ulist))
+        if ofs_list != "NULL":
+            align4(out)
+            ofs_off = len(out)
+            values = c_array(src, ofs_list)
+            if CMAP_TYPES[ctype] == CMAP_TYPES["SPARSE_FULL"]:
+                out += struct.pack("<%dH" % len(values), *values)
+            else:
+                out += bytes(values)
+        packed_cmaps.append(struct.pack(CMAP_FMT, int(start), int(length), int(gid), int(list_len),
+                                        CMAP_TYPES[ctype], unicode_off, ofs_off))
+    out[cmaps_off:cmaps_off + len(b"".join(packed_cmaps))] = b"".join(packed_cmaps)
+
+    kern_off = 0
+    if has_kern:
+        align4(out)
+        kern_off = len(out)
+        out += bytes(struct.calcsize(KERN_FMT))
+        left_off = len(out)
+        out += bytes(kern_left)
+        right_off = len(out)
+        out += bytes(kern_right)
+        values_off = len(out)
+        out += bytes(v & 0xFF for v in kern_values)
+        out[kern_off:kern_off + struct.calcsize(KERN_FMT)] = struct.pack(
+            KERN_FMT, int(c_field(src, "left_class_cnt")), int(c_field(src, "right_class_cnt")),
+            left_off, right_off, values_off)
+
+    align4(out)
+    bitmap_off = len(out)
+    out += bitmap
+
+    out[0:struct.calcsize(FONT_FMT)] = struct.pack(
+        FONT_FMT, line_height, base_line, underline_position, underline_thickness, bpp,
+        bitmap_format, subpx, 1 if has_kern else 0, kern_scale, len(cmaps), len(glyphs),
+        glyph_dsc_off, cmaps_off, bitmap_off, kern_off)
+    return bytes(out)
+
+
+def pack_image(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < 12 or data[0] != LV_IMAGE_HEADER_MAGIC:
+        raise ValueError("not an LVGL v9 .bin image")
+    return data
+
+
+def partition_offset(csv_path, label):
+    with open(csv_path, encoding="utf-8") as f:
+        for row in csv.reader(line for line in f if not line.lstrip().startswith("#")):
+            if row and row[0].strip() == label:
+                return int(row[3].strip(), 0), int(row[4].strip(), 0)
+    raise ValueError("no '%s' partition in %s" % (label, csv_path))
+
+
+def collect(assets_dir):
+    items = []
+    for sub, ext, kind, packer in (("images", ".bin", ASSET_IMAGE, pack_image),
+                                   ("fonts", ".c", ASSET_FONT, pack_font)):
+        folder = os.path.join(assets_dir, sub)
+        if not os.path.isdir(folder):
+            continue
+        for fname in sorted(os.listdir(folder)):
+            if not fname.endswith(ext):
+                continue
+            name = fname[:-len(ext)]
+            if len(name) >= ASSET_NAME_LEN:
+                raise ValueError("asset name too long: %s" % name)
+            items.append((name, kind, packer(os.path.join(folder, fname))))
+    return items
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--assets", default=os.path.join(root, "assets"))
+    ap.add_argument("--out", default=os.path.join(root, ".pio", "assets.bin"))
+    ap.add_argument("--partitions", default=os.path.join(root, "partitions.csv"))
+    args = ap.parse_args()
+
+    try:
+        items = collect(args.assets)
+        offset, size = partition_offset(args.partitions, "assets")
+    except (OSError, ValueError) as e:
+        sys.exit("ERROR: %s" % e)
+    if not items:
+        sys.exit("ERROR: no assets under %s/images or %s/fonts" % (args.assets, args.assets))
+    if len(items) > ASSET_MAX_ENTRIES:
+        sys.exit("ERROR: %d assets, at most %d fit the index" % (len(items), ASSET_MAX_ENTRIES))
+
+    index_len = struct.calcsize(HEADER_FMT) + struct.calcsize(ENTRY_FMT) * len(items)
+    payload = bytearray(index_len)
+    align4(payload)
+    index = b""
+    for name, kind, data in items:
+        index += struct.pack(ENTRY_FMT, name.encode(), kind, len(payload), len(data))
+        payload += data
+        align4(payload)
+        print("  %-24s %-5s %7d bytes" % (name, "image" if kind == ASSET_IMAGE else "font", len(data)))
+
+    if len(payload) > size:
+        sys.exit("ERROR: %d bytes of assets, partition holds %d" % (len(payload), size))
+
+    header = struct.pack(HEADER_FMT, ASSET_MAGIC, ASSET_VERSION, len(items), len(payload),
+                         zlib.crc32(index) & 0xFFFFFFFF)
+    payload[0:index_len] = header + index
+
+    os.makedirs(os.path.dirname(args.out), exist_ok=True)
+    with open(args.out, "wb") as f:
+        f.write(payload)
+
+    print("%d assets, %d of %d bytes (%.0f%%) -> %s" % (len(items), len(payload), size,
+                                                        100.0 * len(payload) / size, args.out))
+    print("Flash with: esptool.py write_flash 0x%X %s" % (offset, args.out))
+
+
+if __name__ == "__main__":
+    main()
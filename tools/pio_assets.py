@@ -0,0 +1,20 @@
+"""PlatformIO targets for the asset partition.
+
+    pio run -t fonts     subset the UI fonts (tools/subset_fonts.py)
+    pio run -t assets    subset fonts, check every used size has one, and pack
+                         .pio/assets.bin (tools/pack_assets.py)
+"""
+
+Import("env")  # noqa: F821
+
+subset = '"$PYTHONEXE" "$PROJECT_DIR/tools/subset_fonts.py"'
+check = subset + " --check"
+pack = '"$PYTHONEXE" "$PROJECT_DIR/tools/pack_assets.py"'
+
+env.AddCustomTarget(  # noqa: F821
+    name="fonts", dependencies=None, actions=[subset],
+    title="Subset fonts", description="Montserrat subsets with only the glyphs the UI draws")
+
+env.AddCustomTarget(  # noqa: F821
+    name="assets", dependencies=None, actions=[subset, check, pack],
+    title="Build assets", description="Subset fonts and pack the asset partition image")
@@ -0,0 +1,471 @@
+#!/usr/bin/env python3
+"""Generate Montserrat subsets holding only the glyphs the dashboard draws.
+
+    tools/subset_fonts.py [--src DIR] [--out DIR] [--font-dir DIR] [--compress] [--dry-run|--check]
+
+Scans the UI sources for every font a label is given, ui_font(<px>) or
+ui_font_px(<design px>), and the text that label can show: string literals,
+LV_SYMBOL_* macros, ui_bind_label() formats and the snprintf formats whose
+buffer ends up in lv_label_set_text(). A design size stands for the font
+ui_font_px() picks on every panel in PANELS (src/ui_layout.cpp rounds the
+scaled size down to one of its font_sizes). Label helpers that take the
+size or the format as a parameter are followed to their call sites; a size
+that is still not a constant stands for every font size. A font call the
+scanner cannot attribute to a label is an error, so a new way of setting
+fonts cannot silently drop sizes from the subsets.
+Conversions are expanded to the characters they can print (%d -> digits and
+'-', %.2f adds '.'). Text that cannot be resolved statically (observers,
+string tables, %s) falls back to every character of every literal in the
+sources.
+
+For each size, lv_font_conv (npx lv_font_conv, needs node) writes
+OUT/montserrat_<px>.c, which tools/pack_assets.py packs into the asset
+partition used with -D DASH_ASSET_FONTS. Glyphs are stored uncompressed so
+text renders without the RLE decoder; --compress trades that for flash and
+needs LV_USE_FONT_COMPRESSED.
+
+The report compares each subset with LVGL's built-in font of the same size,
+both measured in the packed layout, so the numbers are what the partition
+and the app image actually hold.
+
+--check generates nothing: it fails when a size the sources use has no
+subset in OUT, or a subset lacks glyphs the sources need (pio run -t assets
+runs it before packing).
+"""
+
+import argparse
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from pack_assets import font_codepoints, pack_font  # noqa: E402
+
+STRING_RE = r'"(?:[^"\\\n]|\\.)*"'
+TEXT_RE = re.compile(r'(%s)|\b(LV_SYMBOL_\w+)' % STRING_RE)
+CONV_RE = re.compile(r"%[-+ #0]*(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z)?([diouxXfFeEgGcsp%])")
+
+# Panels the layout is checked on (bench_layout); ui_font_px() sizes are resolved for each
+UI_DESIGN_RES = (480, 320)
+PANELS = [(480, 320), (800, 480)]
+
+# lv_obj_set_style_text_font(<var>, ui_font[_px](<arg>), ...)
+FONT_CALL_RE = re.compile(r"text_font\(\s*(\w+)\s*,\s*(ui_font(?:_px)?)\(\s*(\w+)\s*\)")
+ANY_FONT_CALL_RE = re.compile(r"\bui_font(?:_px)?\s*\(")
+
+# Literals in log output never reach a label
+LOG_RE = re.compile(r"\bSerial\.|\bprintf\s*\(|\blog_[a-z]\s*\(")
+
+DIGITS = "0123456789"
+CONV_CHARS = {
+    "d": DIGITS + "-", "i": DIGITS + "-", "u": DIGITS, "o": "01234567",
+    "x": DIGITS + "abcdef", "X": DIGITS + "ABCDEF",
+    "f": DIGITS + "-.", "F": DIGITS + "-.", "e": DIGITS + "-.e+", "E": DIGITS + "-.E+",
+    "g": DIGITS + "-.e+", "G": DIGITS + "-.E+", "p": DIGITS + "abcdefx", "%": "%",
+}
+
+# What lv_font_conv is given for the built-in fonts (lvgl/scripts/built_in_font)
+TEXT_TTF = "Montserrat-Medium.ttf"
+SYMBOL_TTF = "FontAwesome5-Solid+Brands+Regular.woff"
+FONT_BPP = 4
+BUILTIN_EXTRA = "\u00b0\u2022"         # degree sign, bullet
+
+
+def c_unescape(lit):
+    """Decode a C string literal body (UTF-8 source) to text."""
+    out = bytearray()
+    i = 0
+    raw = lit.encode("utf-8")
+    while i < len(raw):
+        c = raw[i]
+        if c != 0x5C:
+            out.append(c)
+            i += 1
+            continue
+        n = chr(raw[i + 1])
+        if n == "x":
+            m = re.match(rb"[0-9a-fA-F]{1,2}", raw[i + 2:])
+            out.append(int(m.group(0), 16))
+            i += 2 + len(m.group(0))
+            continue
+        out += {"n": b"\n", "t": b"\t", "r": b"\r", "0": b"\0"}.get(n, n.encode())
+        i += 2
+    return out.decode("utf-8")
+
+
+def strip_comments(src):
+    return re.sub(r'//[^\n]*|/\*.*?\*/|(%s)' % STRING_RE,
+                  lambda m: m.group(1) or " ", src, flags=re.S)
+
+
+def statements(src):
+    """Split on ';' and braces outside string literals."""
+    parts, cur = [], []
+    for tok in re.split(r'(%s|[;{}])' % STRING_RE, src):
+        if tok in (";", "{", "}"):
+            parts.append("".join(cur))
+            cur = []
+        elif tok:
+            cur.append(tok)
+    parts.append("".join(cur))
+    return [p.strip() for p in parts if p.strip()]
+
+
+def call_args(stmt, func):
+    """Top-level arguments of the first call to func in stmt, or None."""
+    m = re.search(r"\b%s\s*\(" % re.escape(func), stmt)
+    if not m:
+        return None
+    args, depth, cur = [], 0, ""
+    for tok in re.split(r'(%s|[(),])' % STRING_RE, stmt[m.end():]):
+        if tok == "(":
+            depth += 1
+        elif tok == ")":
+            if depth == 0:
+                args.append(cur.strip())
+                return args
+            depth -= 1
+        elif tok == "," and depth == 0:
+            args.append(cur.strip())
+            cur = ""
+            continue
+        cur += tok or ""
+    return None
+
+
+def load_font_sizes(src_dir):
+    """font_sizes[] of ui_layout.cpp: the sizes ui_font() provides"""
+    with open(os.path.join(src_dir, "ui_layout.cpp"), encoding="utf-8") as f:
+        m = re.search(r"font_sizes\[\]\s*=\s*\{([^}]*)\}", f.read())
+    if not m:
+        raise ValueError("font_sizes[] not found in ui_layout.cpp")
+    return [int(v) for v in re.findall(r"\d+", m.group(1))]
+
+
+def panel_scale(hor, ver):
+    """ui_layout_init(): 8.8 fixed-point scale from the design resolution"""
+    return min(hor * 256 // UI_DESIGN_RES[0], ver * 256 // UI_DESIGN_RES[1])
+
+
+def font_px_sizes(design_px, font_sizes):
+    """Font sizes ui_font_px(design_px) returns across PANELS"""
+    out = set()
+    for hor, ver in PANELS:
+        want = (design_px * panel_scale(hor, ver) + 128) // 256
+        out.add(max([s for s in font_sizes if s <= want] or [font_sizes[0]]))
+    return out
+
+
+def func_params(params):
+    """Parameter names of a C parameter list"""
+    names = []
+    for p in params.split(","):
+        m = re.search(r"(\w+)\s*(?:\[\s*\])?\s*$", p.strip())
+        if m and m.group(1) != "void":
+            names.append(m.group(1))
+    return names
+
+
+class Scanner:
+    def __init__(self, symbols, font_sizes):
+        self.symbols = symbols
+        self.symbol_chars = set("".join(symbols.values()))
+        self.font_sizes = font_sizes
+        self.fonts = {}         # label variable -> set of pixel sizes
+        self.texts = {}         # label variable -> list of (text, dynamic)
+        self.literal_text = set()
+        self.unresolved = []    # (path, line) of font calls not tied to a label
+        self.call_sites = 0     # Helper calls, each a label of its own
+
+    def font_sizes_of(self, func, arg):
+        """Sizes a ui_font/ui_font_px argument stands for"""
+        if not arg.isdigit():
+            return set(self.font_sizes)
+        px = int(arg)
+        return font_px_sizes(px, self.font_sizes) if func == "ui_font_px" else {px}
+
+    def text_of(self, expr):
+        """Literal text of an expression made of literals and LV_SYMBOL_*."""
+        text = ""
+        for lit, sym in TEXT_RE.findall(expr):
+            if sym:
+                if sym not in self.symbols:
+                    raise ValueError("unknown symbol %s" % sym)
+                text += self.symbols[sym]
+            else:
+                text += c_unescape(lit[1:-1])
+        return text
+
+    def format_chars(self, fmt):
+        """(characters printed by fmt, whether a %s/%c made it dynamic)"""
+        dynamic = False
+        chars = set(CONV_RE.sub("", fmt))
+        for m in CONV_RE.finditer(fmt):
+            conv = m.group(4)
+            if conv in "sc":
+                dynamic = True
+            else:
+                chars |= set(CONV_CHARS[conv])
+        return chars, dynamic
+
+    def scan(self, path):
+        with open(path, encoding="utf-8") as f:
+            src = strip_comments(f.read())
+        for stmt in statements(src):
+            if not LOG_RE.search(stmt):
+                for lit, sym in TEXT_RE.findall(stmt):
+                    self.literal_text |= set(self.text_of(lit or sym))
+
+        # Helpers that create a label, set its font and return it. The size and
+        # the text may be parameters, resolved at each call site.
+        helpers = {}
+        for m in re.finditer(r"\blv_obj_t\s*\*\s*(\w+)\s*\(([^)]*)\)\s*\{(.*?)\n\s*\}", src, re.S):
+            name, params, body = m.group(1), func_params(m.group(2)), m.group(3)
+            fm = FONT_CALL_RE.search(body)
+            if not fm or not re.search(r"return\s+%s\s*;" % fm.group(1), body):
+                continue
+            var = fm.group(1)
+            h = {"font": fm.group(2), "size": fm.group(3), "size_param": None, "text_params": [], "texts": []}
+            if h["size"] in params:
+                h["size_param"] = params.index(h["size"])
+            for stmt in statements(body):
+                args = call_args(stmt, "ui_bind_label")
+                if args and len(args) >= 3 and args[0] == var:
+                    if args[2] in params:
+                        h["text_params"].append(params.index(args[2]))
+                    else:
+                        h["texts"].append(self.format_chars(self.text_of(args[2])))
+                args = call_args(stmt, "lv_label_set_text")
+                if args and len(args) >= 2 and args[0] == var:
+                    if args[1] in params:
+                        h["text_params"].append(("literal", params.index(args[1])))
+                    else:
+                        h["texts"].append((set(self.text_of(args[1])), False))
+            helpers[name] = h
+        # Outside the helpers, each call site stands for the label it creates
+        outside = re.sub(r"\blv_obj_t\s*\*\s*(\w+)\s*\([^)]*\)\s*\{.*?\n\s*\}",
+                         lambda m: " " if m.group(1) in helpers else m.group(0), src, flags=re.S)
+
+        # Every font call must be attributed to a label. The font functions
+        # themselves (ui_fonts.cpp, ui_layout.cpp) are not calls to check.
+        calls = re.sub(r"\bconst\s+lv_font_t\s*\*\s*ui_font\w*\s*\([^)]*\)\s*\{.*?\n\}",
+                       lambda m: re.sub(r"[^\n]", " ", m.group(0)), src, flags=re.S)
+        for m in ANY_FONT_CALL_RE.finditer(calls):
+            line_start = calls.rfind("\n", 0, m.start()) + 1
+            line_end = calls.find("\n", m.end())
+            if not FONT_CALL_RE.search(calls[line_start:line_end if line_end >= 0 else None]):
+                self.unresolved.append((path, calls.count("\n", 0, m.start()) + 1))
+
+        pending = {}            # buffer -> [(chars, dynamic)] written by snprintf
+        for stmt in statements(outside):
+            for name, h in helpers.items():
+                args = call_args(stmt, name)
+                if args is None:
+                    continue
+                m = re.search(r"\b(\w+)\s*=\s*%s\s*\(" % name, stmt)
+                if m:
+                    var = m.group(1)
+                else:
+                    self.call_sites += 1
+                    var = "%s#%d" % (name, self.call_sites)
+                size = h["size"]
+                if h["size_param"] is not None:
+                    size = args[h["size_param"]] if h["size_param"] < len(args) else ""
+                self.fonts.setdefault(var, set()).update(self.font_sizes_of(h["font"], size))
+                texts = self.texts.setdefault(var, [])
+                texts.extend(h["texts"])
+                for tp in h["text_params"]:
+                    literal = isinstance(tp, tuple)
+                    i = tp[1] if literal else tp
+                    expr = args[i] if i < len(args) else ""
+                    if not TEXT_RE.search(expr) or TEXT_RE.sub("", expr).strip():
+                        texts.append((set(), True))
+                    elif literal:
+                        texts.append((set(self.text_of(expr)), False))
+                    else:
+                        texts.append(self.format_chars(self.text_of(expr)))
+
+            m = FONT_CALL_RE.search(stmt)
+            if m:
+                self.fonts.setdefault(m.group(1), set()).update(self.font_sizes_of(m.group(2), m.group(3)))
+
+            args = call_args(stmt, "snprintf")
+            if args and len(args) >= 3:
+                buf = re.match(r"\w+", args[0]).group(0)
+                entry = self.format_chars(self.text_of(args[2]))
+                if "+" in args[0]:
+                    pending.setdefault(buf, []).append(entry)
+                else:
+                    pending[buf] = [entry]
+
+            args = call_args(stmt, "ui_bind_label")
+            if args and len(args) >= 3:
+                self.texts.setdefault(args[0], []).append(self.format_chars(self.text_of(args[2])))
+
+            for func in ("lv_label_set_text", "lv_label_set_text_static", "lv_label_set_text_fmt"):
+                args = call_args(stmt, func)
+                if not args or len(args) < 2:
+                    continue
+                var, expr = args[0], args[1]
+                texts = self.texts.setdefault(var, [])
+                rest = TEXT_RE.sub("", expr).strip()
+                if func == "lv_label_set_text_fmt":
+                    texts.append(self.format_chars(self.text_of(expr)))
+                elif not rest or ("?" in rest and TEXT_RE.search(expr)):
+                    texts.append((set(self.text_of(expr)), False))
+                elif rest in pending:
+                    texts.extend(pending[rest])
+                else:
+                    texts.append((set(), True))
+                break
+
+    def glyphs(self):
+        """Pixel size -> set of characters"""
+        out = {}
+        for var, sizes in self.fonts.items():
+            chars = set(" ")
+            for text, dynamic in self.texts.get(var, [(set(), True)]):
+                chars |= text
+                if dynamic:
+                    chars |= self.literal_text | set(DIGITS + "-.:")
+            for px in sizes:
+                out.setdefault(px, set()).update(chars)
+        # Nothing outside the built-in fonts' ranges could be drawn before either
+        for px in out:
+            out[px] = {c for c in out[px]
+                       if " " <= c <= "~" or c in BUILTIN_EXTRA or c in self.symbol_chars}
+        return out
+
+
+def find_lvgl(root):
+    hits = glob.glob(os.path.join(root, ".pio", "libdeps", "*", "lvgl"))
+    return hits[0] if hits else None
+
+
+def load_symbols(lvgl_dir):
+    path = os.path.join(lvgl_dir, "src", "font", "lv_symbol_def.h")
+    symbols = {}
+    with open(path, encoding="utf-8") as f:
+        for name, lit in re.findall(r"#define\s+(LV_SYMBOL_\w+)\s+(%s)" % STRING_RE, f.read()):
+            symbols[name] = c_unescape(lit[1:-1])
+    return symbols
+
+
+def ranges(codepoints):
+    return ",".join("0x%X" % c for c in sorted(codepoints))
+
+
+def convert(px, chars, font_dir, out_path, compress):
+    text = sorted(c for c in chars if c < "\uf000")
+    icons = sorted(ord(c) for c in chars if c >= "\uf000")
+    cmd = ["npx", "--yes", "lv_font_conv", "--format", "lvgl", "--bpp", str(FONT_BPP),
+           "--size", str(px), "--lv-font-name", "montserrat_%d" % px, "-o", out_path,
+           "--font", os.path.join(font_dir, TEXT_TTF), "--range", ranges(ord(c) for c in text)]
+    if icons:
+        cmd += ["--font", os.path.join(font_dir, SYMBOL_TTF), "--range", ranges(icons)]
+    if not compress:
+        cmd.append("--no-compress")
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+
+
+def check(glyphs, out_dir):
+    """0 when every used size has a subset in out_dir holding every glyph it needs"""
+    failed = 0
+    for px in sorted(glyphs):
+        path = os.path.join(out_dir, "montserrat_%d.c" % px)
+        if not os.path.isfile(path):
+            print("ERROR: %d px is used but %s is missing" % (px, path))
+            failed += 1
+            continue
+        try:
+            missing = {ord(c) for c in glyphs[px]} - font_codepoints(path)
+        except (OSError, ValueError) as e:
+            print("ERROR: %s: %s" % (path, e))
+            failed += 1
+            continue
+        if missing:
+            print("ERROR: %d px subset lacks %d glyph(s): %r" % (
+                px, len(missing), "".join(sorted(chr(c) for c in missing if c < 0xF000))))
+            failed += 1
+    if failed:
+        print("Regenerate with tools/subset_fonts.py (pio run -t fonts)")
+    else:
+        print("All %d sizes have complete subsets" % len(glyphs))
+    return 1 if failed else 0
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--src", default=os.path.join(root, "src"))
+    ap.add_argument("--out", default=os.path.join(root, "assets", "fonts"))
+    ap.add_argument("--lvgl", help="LVGL source tree (default: .pio/libdeps/*/lvgl)")
+    ap.add_argument("--font-dir", help="TTF/WOFF sources (default: LVGL scripts/built_in_font)")
+    ap.add_argument("--compress", action="store_true", help="RLE-compress glyph bitmaps")
+    mode = ap.add_mutually_exclusive_group()
+    mode.add_argument("--dry-run", action="store_true", help="only print the glyph sets")
+    mode.add_argument("--check", action="store_true",
+                      help="fail if a used size has no subset in --out or misses glyphs")
+    args = ap.parse_args()
+
+    lvgl_dir = args.lvgl or find_lvgl(root)
+    if not lvgl_dir:
+        sys.exit("ERROR: LVGL not found, build once (pio run) or pass --lvgl")
+    font_dir = args.font_dir or os.path.join(lvgl_dir, "scripts", "built_in_font")
+
+    try:
+        scanner = Scanner(load_symbols(lvgl_dir), load_font_sizes(args.src))
+        for path in sorted(glob.glob(os.path.join(args.src, "*.cpp"))):
+            scanner.scan(path)
+    except (OSError, ValueError) as e:
+        sys.exit("ERROR: %s" % e)
+    for path, line in scanner.unresolved:
+        print("ERROR: %s:%d: font call not tied to a label, its size would get no subset"
+              % (os.path.relpath(path, root), line))
+    if scanner.unresolved:
+        sys.exit(1)
+    glyphs = scanner.glyphs()
+    if not glyphs:
+        sys.exit("ERROR: no ui_font()/ui_font_px() sizes found under %s" % args.src)
+
+    for px in sorted(glyphs):
+        shown = "".join(sorted(c for c in glyphs[px] if ord(c) < 0xF000))
+        icons = sum(1 for c in glyphs[px] if ord(c) >= 0xF000)
+        print("  %2d px  %3d glyphs  %r%s" % (px, len(glyphs[px]), shown,
+                                             " + %d symbols" % icons if icons else ""))
+    if args.dry_run:
+        return
+    if args.check:
+        sys.exit(check(glyphs, args.out))
+
+    if not shutil.which("npx"):
+        sys.exit("ERROR: npx not found, lv_font_conv needs node")
+    for name in (TEXT_TTF, SYMBOL_TTF):
+        if not os.path.isfile(os.path.join(font_dir, name)):
+            sys.exit("ERROR: %s not in %s, pass --font-dir" % (name, font_dir))
+
+    os.makedirs(args.out, exist_ok=True)
+    total_full = total_subset = 0
+    print("\n  size     built-in     subset    saved")
+    for px in sorted(glyphs):
+        out_path = os.path.join(args.out, "montserrat_%d.c" % px)
+        try:
+            convert(px, glyphs[px], font_dir, out_path, args.compress)
+            subset = len(pack_font(out_path))
+            full = len(pack_font(os.path.join(lvgl_dir, "src", "font", "lv_font_montserrat_%d.c" % px)))
+        except (OSError, ValueError, subprocess.CalledProcessError) as e:
+            sys.exit("ERROR: %d px: %s" % (px, e))
+        total_full += full
+        total_subset += subset
+        print("  %2d px  %9d  %9d  %6.1f%%" % (px, full, subset, 100.0 * (full - subset) / full))
+    print("  total  %9d  %9d  %6.1f%%  (%d bytes of flash freed)" % (
+        total_full, total_subset, 100.0 * (total_full - total_subset) / total_full,
+        total_full - total_subset))
+    print("Pack with tools/pack_assets.py and build with -D DASH_ASSET_FONTS")
+
+
+if __name__ == "__main__":
+    main()